@@ -0,0 +1,253 @@
+// 对比 mystl 与 std 的算法在百万元素的 vector 上的耗时(ms)
+// find/count/min_element/max_element/accumulate 在 MYSTL_SIMD 打开时走 SSE2/AVX2
+// sort/stable_sort 分别在随机、有序、逆序和大量重复的输入上与 std 对比
+// radix_sort/msd_radix_sort 与 std::sort 对比
+// lower_bound 和 eytzinger_array 在不同大小的表上与 std::lower_bound 对比
+//
+// 用法: mystl_algorithm_bench [-n 元素个数] [-r 重复次数]
+
+#include "vector.h"
+#include "algorithm.h"
+#include "numeric.h"
+#include "sort.h"
+#include "radix_sort.h"
+#include "eytzinger_array.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+
+namespace {
+
+// 防止编译器把整轮循环优化掉
+volatile long long g_sink = 0;
+
+template <class F>
+double Millis(int reps, F f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        g_sink = g_sink + static_cast<long long>(f());
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / reps;
+}
+
+void Row(const char* name, double mystl_ms, double std_ms) {
+    std::printf("%-28s %10.3f %10.3f %7.2fx\n", name, mystl_ms, std_ms, mystl_ms > 0.0 ? std_ms / mystl_ms : 0.0);
+}
+
+template <class T>
+void BenchType(const char* type, std::size_t n, int reps) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 1000);
+    mystl::vector<T> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<T>(dist(rng)));
+    }
+    const T missing = static_cast<T>(-1); // 不存在的值, find 扫描整个区间
+    const T* first = v.data();
+    const T* last = v.data() + v.size();
+    std::string name;
+
+    name = std::string("find<") + type + ">";
+    Row(name.c_str(), Millis(reps, [&] { return mystl::find(first, last, missing) - first; }),
+        Millis(reps, [&] { return std::find(first, last, missing) - first; }));
+    name = std::string("count<") + type + ">";
+    Row(name.c_str(), Millis(reps, [&] { return mystl::count(first, last, static_cast<T>(7)); }),
+        Millis(reps, [&] { return std::count(first, last, static_cast<T>(7)); }));
+}
+
+template <class T>
+void BenchInteger(const char* type, std::size_t n, int reps) {
+    BenchType<T>(type, n, reps);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-100000, 100000);
+    mystl::vector<T> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<T>(dist(rng)));
+    }
+    const T* first = v.data();
+    const T* last = v.data() + v.size();
+    std::string name;
+
+    name = std::string("min_element<") + type + ">";
+    Row(name.c_str(), Millis(reps, [&] { return mystl::min_element(first, last) - first; }),
+        Millis(reps, [&] { return std::min_element(first, last) - first; }));
+    name = std::string("max_element<") + type + ">";
+    Row(name.c_str(), Millis(reps, [&] { return mystl::max_element(first, last) - first; }),
+        Millis(reps, [&] { return std::max_element(first, last) - first; }));
+    name = std::string("accumulate<") + type + ">";
+    Row(name.c_str(), Millis(reps, [&] { return mystl::accumulate(first, last, T()); }),
+        Millis(reps, [&] { return std::accumulate(first, last, T()); }));
+}
+
+// 每轮先把原始数据拷回再排序, 拷贝的耗时两边相同
+template <class Sort>
+double SortMillis(int reps, const mystl::vector<int>& input, mystl::vector<int>& work, Sort sort) {
+    return Millis(reps, [&] {
+        mystl::copy(input.begin(), input.end(), work.begin());
+        sort(work.begin(), work.end());
+        return work[work.size() / 2];
+    });
+}
+
+void BenchSort(std::size_t n, int reps) {
+    std::mt19937 rng(11);
+    const char* const patterns[] = {"random", "sorted", "reversed", "few_unique"};
+    for (int p = 0; p < 4; ++p) {
+        mystl::vector<int> input;
+        input.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const int x = static_cast<int>(i);
+            input.push_back(p == 0 ? static_cast<int>(rng()) : p == 1 ? x : p == 2 ? -x : static_cast<int>(rng() % 16));
+        }
+        mystl::vector<int> work(input);
+        std::string name;
+
+        name = std::string("sort/") + patterns[p];
+        Row(name.c_str(), SortMillis(reps, input, work, [](int* f, int* l) { mystl::sort(f, l); }),
+            SortMillis(reps, input, work, [](int* f, int* l) { std::sort(f, l); }));
+        name = std::string("stable_sort/") + patterns[p];
+        Row(name.c_str(), SortMillis(reps, input, work, [](int* f, int* l) { mystl::stable_sort(f, l); }),
+            SortMillis(reps, input, work, [](int* f, int* l) { std::stable_sort(f, l); }));
+        name = std::string("nth_element/") + patterns[p];
+        Row(name.c_str(), SortMillis(reps, input, work, [](int* f, int* l) { mystl::nth_element(f, f + (l - f) / 2, l); }),
+            SortMillis(reps, input, work, [](int* f, int* l) { std::nth_element(f, f + (l - f) / 2, l); }));
+        // 取前 1000 个, top-k 的常见用法
+        name = std::string("partial_sort/") + patterns[p];
+        Row(name.c_str(),
+            SortMillis(reps, input, work,
+                       [](int* f, int* l) { mystl::partial_sort(f, f + std::min<std::ptrdiff_t>(1000, l - f), l); }),
+            SortMillis(reps, input, work,
+                       [](int* f, int* l) { std::partial_sort(f, f + std::min<std::ptrdiff_t>(1000, l - f), l); }));
+    }
+}
+
+template <class T, class RadixSort>
+void BenchRadixType(const char* name, const mystl::vector<T>& input, int reps, RadixSort radix) {
+    mystl::vector<T> work(input);
+    auto run = [&](void (*sort)(T*, T*)) {
+        return Millis(reps, [&] {
+            mystl::copy(input.begin(), input.end(), work.begin());
+            sort(work.data(), work.data() + work.size());
+            return work.size();
+        });
+    };
+    Row(name, run(radix), run([](T* f, T* l) { std::sort(f, l); }));
+}
+
+void BenchRadix(std::size_t n, int reps) {
+    std::mt19937_64 rng(13);
+    mystl::vector<std::uint64_t> u64;
+    mystl::vector<int> i32;
+    mystl::vector<double> f64;
+    for (std::size_t i = 0; i < n; ++i) {
+        u64.push_back(rng());
+        i32.push_back(static_cast<int>(rng()));
+        f64.push_back(static_cast<double>(static_cast<std::int64_t>(rng())) * 1e-9);
+    }
+    BenchRadixType("radix_sort/uint64", u64, reps, [](std::uint64_t* f, std::uint64_t* l) { mystl::radix_sort(f, l); });
+    BenchRadixType("radix_sort/int", i32, reps, [](int* f, int* l) { mystl::radix_sort(f, l); });
+    BenchRadixType("radix_sort/double", f64, reps, [](double* f, double* l) { mystl::radix_sort(f, l); });
+
+    // 16 字节的定长字符串, 字符串排序慢, 元素数减到十分之一
+    mystl::vector<std::string> str;
+    for (std::size_t i = 0; i < std::max<std::size_t>(1, n / 10); ++i) {
+        std::string s(16, 'a');
+        for (char& c : s) {
+            c = static_cast<char>('a' + rng() % 26);
+        }
+        str.push_back(s);
+    }
+    BenchRadixType("msd_radix_sort/string16", str, reps,
+                   [](std::string* f, std::string* l) { mystl::msd_radix_sort(f, l); });
+}
+
+// 表从放得进 L1 到远大于 L2, 每种大小做同样多次随机查询
+void BenchSearch(std::size_t queries, int reps) {
+    const std::size_t sizes[] = {1 << 10, 1 << 16, 1 << 20, 1 << 24};
+    std::mt19937 rng(19);
+    for (std::size_t n : sizes) {
+        mystl::vector<int> table;
+        table.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            table.push_back(static_cast<int>(i * 2));
+        }
+        mystl::vector<int> keys;
+        keys.reserve(queries);
+        for (std::size_t i = 0; i < queries; ++i) {
+            keys.push_back(static_cast<int>(rng() % (2 * n)));
+        }
+        const mystl::eytzinger_array<int> eytzinger(table.data(), table.data() + n);
+        const int* first = table.data();
+        const int* last = table.data() + n;
+
+        const double std_ms = Millis(reps, [&] {
+            long long sum = 0;
+            for (int k : keys) {
+                sum += std::lower_bound(first, last, k) - first;
+            }
+            return sum;
+        });
+        std::string name = "lower_bound/" + std::to_string(n);
+        Row(name.c_str(), Millis(reps, [&] {
+                long long sum = 0;
+                for (int k : keys) {
+                    sum += mystl::lower_bound(first, last, k) - first;
+                }
+                return sum;
+            }),
+            std_ms);
+        name = "eytzinger/" + std::to_string(n);
+        Row(name.c_str(), Millis(reps, [&] {
+                long long sum = 0;
+                for (int k : keys) {
+                    const int* p = eytzinger.lower_bound(k);
+                    sum += p != nullptr ? *p : 0;
+                }
+                return sum;
+            }),
+            std_ms);
+    }
+}
+
+void Usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-n elements] [-r reps]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t n = 1000000;
+    int reps = 50;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            n = static_cast<std::size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (arg == "-r" && i + 1 < argc) {
+            reps = std::max(1, std::atoi(argv[++i]));
+        } else {
+            Usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::printf("MYSTL_SIMD=%d elements=%zu\n", MYSTL_SIMD, n);
+    std::printf("%-28s %10s %10s %8s\n", "algorithm", "mystl ms", "std ms", "speedup");
+    BenchInteger<int>("int", n, reps);
+    BenchInteger<short>("short", n, reps);
+    BenchInteger<long long>("long long", n, reps);
+    BenchType<float>("float", n, reps);
+    BenchType<double>("double", n, reps);
+    // 排序比线性扫描慢得多, 少跑几轮
+    BenchSort(n, std::max(1, reps / 10));
+    BenchRadix(n, std::max(1, reps / 10));
+    BenchSearch(n, std::max(1, reps / 10));
+    return 0;
+}
@@ -0,0 +1,105 @@
+// 对比 mystl::set (红黑树) 与 mystl::btree_set (B+ 树) 在 10^3 到 10^N 个元素时的
+// 随机插入, 随机查找 (lower_bound) 和顺序遍历, 输出每个元素/每次查找的耗时(ns)
+//
+// 用法: mystl_btree_bench [-n 最大元素个数, 默认 10^7; 10^8 需要约 8GB 内存] [-q 查找次数]
+
+#include "vector.h"
+#include "set.h"
+#include "btree_set.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+// 防止编译器把整轮循环优化掉
+volatile long long g_sink = 0;
+
+template <class F>
+double Nanos(std::size_t ops, F f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / static_cast<double>(ops);
+}
+
+struct Result {
+    double insert;
+    double lookup;
+    double scan;
+};
+
+template <class Set>
+Result Run(const mystl::vector<std::int64_t>& keys, const mystl::vector<std::int64_t>& queries) {
+    Result r;
+    Set s;
+    r.insert = Nanos(keys.size(), [&] {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            s.insert(keys[i]);
+        }
+    });
+    r.lookup = Nanos(queries.size(), [&] {
+        long long sum = 0;
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            auto it = s.lower_bound(queries[i]);
+            sum += it == s.end() ? 0 : *it;
+        }
+        g_sink = g_sink + sum;
+    });
+    r.scan = Nanos(s.size(), [&] {
+        long long sum = 0;
+        for (auto it = s.begin(); it != s.end(); ++it) {
+            sum += *it;
+        }
+        g_sink = g_sink + sum;
+    });
+    return r;
+}
+
+void Usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-n max_elements] [-q queries]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t max_n = 10000000;
+    std::size_t queries = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            max_n = static_cast<std::size_t>(std::max(1000L, std::atol(argv[++i])));
+        } else if (arg == "-q" && i + 1 < argc) {
+            queries = static_cast<std::size_t>(std::max(1L, std::atol(argv[++i])));
+        } else {
+            Usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::printf("%10s %-10s %10s %10s %10s\n", "elements", "container", "insert ns", "lookup ns", "scan ns");
+    std::mt19937_64 rng(23);
+    for (std::size_t n = 1000; n <= max_n; n *= 10) {
+        mystl::vector<std::int64_t> keys;
+        keys.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back(static_cast<std::int64_t>(rng() >> 1));
+        }
+        mystl::vector<std::int64_t> q;
+        q.reserve(queries);
+        for (std::size_t i = 0; i < queries; ++i) {
+            // 一半命中已有的键
+            q.push_back(i % 2 == 0 ? keys[rng() % n] : static_cast<std::int64_t>(rng() >> 1));
+        }
+        const Result rb = Run<mystl::set<std::int64_t>>(keys, q);
+        const Result bt = Run<mystl::btree_set<std::int64_t>>(keys, q);
+        std::printf("%10zu %-10s %10.1f %10.1f %10.2f\n", n, "rb_tree", rb.insert, rb.lookup, rb.scan);
+        std::printf("%10zu %-10s %10.1f %10.1f %10.2f\n", n, "btree", bt.insert, bt.lookup, bt.scan);
+    }
+    return 0;
+}
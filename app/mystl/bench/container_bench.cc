@@ -0,0 +1,179 @@
+// 对比 mystl::vector 和 mystl::small_vector 在反复创建小容器时的开销:
+// 每轮构造一个容器, push_back n 个元素, 遍历求和后析构, 输出每轮耗时(ns)
+// n 不超过内部缓冲区时 small_vector 不申请内存; 超过之后两者都要扩容
+// 另外对比 mystl::set 从有序区间线性建树与逐个 insert 的耗时(ms)
+// 以及 mystl::set 与 mystl::flat_set 从乱序区间建表和随机查找的耗时(ms)
+// 以及在两个 mystl::map 之间来回迁移全部元素时, erase + insert 与 extract + insert(node) 的耗时(ms)
+//
+// 用法: mystl_container_bench [-n 每种规模的轮数]
+
+#include "vector.h"
+#include "small_vector.h"
+#include "set.h"
+#include "flat_set.h"
+#include "map.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+const std::size_t INLINE_N = 8;
+const std::size_t SIZES[] = {1, 4, 8, 9, 16, 64, 1024};
+
+// 防止编译器把整轮循环优化掉
+volatile long long g_sink = 0;
+
+template <class Container>
+double NanosPerRound(std::size_t n, long rounds) {
+    long long sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (long r = 0; r < rounds; ++r) {
+        Container c;
+        for (std::size_t i = 0; i < n; ++i) {
+            c.push_back(static_cast<int>(i + r));
+        }
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            sum += *it;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    g_sink = g_sink + sum;
+    return seconds * 1e9 / static_cast<double>(rounds);
+}
+
+template <class Build>
+double BuildMillis(const mystl::vector<int>& keys, Build build) {
+    const auto start = std::chrono::steady_clock::now();
+    mystl::set<int> s;
+    build(s, keys);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    g_sink = g_sink + static_cast<long long>(s.size());
+    return ms;
+}
+
+template <class F>
+double Millis(F f) {
+    const auto start = std::chrono::steady_clock::now();
+    g_sink = g_sink + static_cast<long long>(f());
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 乱序区间一次建好, 再做同样多次随机查找
+template <class Set>
+void BenchLookup(const mystl::vector<int>& keys, const mystl::vector<int>& probes, double& build, double& lookup) {
+    Set s;
+    build = Millis([&] {
+        s.insert(keys.begin(), keys.end());
+        return s.size();
+    });
+    lookup = Millis([&] {
+        std::size_t hits = 0;
+        for (auto it = probes.begin(); it != probes.end(); ++it) {
+            hits += s.count(*it);
+        }
+        return hits;
+    });
+}
+
+// 把 from 的元素全部移到 to, 再移回来
+template <class Move>
+double MigrateMillis(std::size_t n, Move move) {
+    mystl::map<int, std::string> a;
+    mystl::map<int, std::string> b;
+    for (std::size_t i = 0; i < n; ++i) {
+        a[static_cast<int>(i)] = "value-" + std::to_string(i);
+    }
+    return Millis([&] {
+        move(a, b);
+        move(b, a);
+        return a.size();
+    });
+}
+
+void Usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-n rounds]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long rounds = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            rounds = std::max(1L, std::atol(argv[++i]));
+        } else {
+            Usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::printf("%8s %14s %18s %8s\n", "elements", "vector ns", "small_vector<8> ns", "speedup");
+    for (std::size_t n : SIZES) {
+        // 大规模时减少轮数, 每种规模的总元素数大致相当
+        const long r = std::max(1L, rounds / static_cast<long>(n < 16 ? 1 : n / 8));
+        const double v = NanosPerRound<mystl::vector<int>>(n, r);
+        const double s = NanosPerRound<mystl::small_vector<int, INLINE_N>>(n, r);
+        std::printf("%8zu %14.1f %18.1f %7.2fx\n", n, v, s, s > 0.0 ? v / s : 0.0);
+    }
+
+    std::printf("\n%8s %14s %18s %8s\n", "elements", "set insert ms", "set sorted ms", "speedup");
+    const std::size_t set_sizes[] = {1000, 100000, 1000000, 4000000};
+    for (std::size_t n : set_sizes) {
+        mystl::vector<int> keys;
+        keys.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back(static_cast<int>(i * 3));
+        }
+        const double insert = BuildMillis(keys, [](mystl::set<int>& s, const mystl::vector<int>& k) {
+            for (auto it = k.begin(); it != k.end(); ++it) {
+                s.insert(*it);
+            }
+        });
+        const double bulk = BuildMillis(keys, [](mystl::set<int>& s, const mystl::vector<int>& k) {
+            mystl::set<int> built(k.begin(), k.end());
+            s.swap(built);
+        });
+        std::printf("%8zu %14.3f %18.3f %7.2fx\n", n, insert, bulk, bulk > 0.0 ? insert / bulk : 0.0);
+    }
+
+    std::printf("\n%8s %14s %18s %14s %18s\n", "elements", "set build ms", "flat_set build ms", "set find ms",
+                "flat_set find ms");
+    std::mt19937 rng(3);
+    for (std::size_t n : set_sizes) {
+        mystl::vector<int> keys;
+        mystl::vector<int> probes;
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back(static_cast<int>(rng()));
+            probes.push_back(static_cast<int>(rng()));
+        }
+        double set_build = 0.0, set_find = 0.0, flat_build = 0.0, flat_find = 0.0;
+        BenchLookup<mystl::set<int>>(keys, probes, set_build, set_find);
+        BenchLookup<mystl::flat_set<int>>(keys, probes, flat_build, flat_find);
+        std::printf("%8zu %14.3f %18.3f %14.3f %18.3f\n", n, set_build, flat_build, set_find, flat_find);
+    }
+
+    std::printf("\n%8s %14s %18s %8s\n", "elements", "erase+insert ms", "extract+insert ms", "speedup");
+    for (std::size_t n : set_sizes) {
+        using map_type = mystl::map<int, std::string>;
+        const double copy = MigrateMillis(n, [](map_type& from, map_type& to) {
+            while (!from.empty()) {
+                auto it = from.begin();
+                to.insert(*it);
+                from.erase(it);
+            }
+        });
+        const double relink = MigrateMillis(n, [](map_type& from, map_type& to) {
+            while (!from.empty()) {
+                to.insert(from.extract(from.begin()));
+            }
+        });
+        std::printf("%8zu %14.3f %18.3f %7.2fx\n", n, copy, relink, relink > 0.0 ? copy / relink : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// 多线程算法的扩展性: 在 1, 2, 4 ... N 个线程下的耗时(ms), 以及相对单线程版本的加速比
+// parallel_sort 对比 mystl::sort, parallel_reduce/parallel_inclusive_scan 对比 mystl::reduce/inclusive_scan
+//
+// 用法: mystl_parallel_bench [-n 元素个数] [-t 最大线程数] [-r 重复次数]
+
+#include "vector.h"
+#include "sort.h"
+#include "parallel.h"
+#include "numeric.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+
+// 防止编译器把整轮循环优化掉
+volatile long long g_sink = 0;
+
+// 每轮先把原始数据拷回再排序
+template <class Sort>
+double SortMillis(int reps, const mystl::vector<int>& input, mystl::vector<int>& work, Sort sort) {
+    double total = 0.0;
+    for (int r = 0; r < reps; ++r) {
+        mystl::copy(input.begin(), input.end(), work.begin());
+        const auto start = std::chrono::steady_clock::now();
+        sort(work.begin(), work.end());
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        g_sink = g_sink + work[work.size() / 2];
+    }
+    return total / reps;
+}
+
+template <class F>
+double Millis(int reps, F f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        g_sink = g_sink + static_cast<long long>(f());
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / reps;
+}
+
+// 单线程版本一行, 之后线程数每次翻倍直到 max_threads
+template <class Sequential, class Parallel>
+void Scale(const char* name, std::size_t max_threads, Sequential seq, Parallel par) {
+    const double base = seq();
+    std::printf("%-8s %8s %12.3f %7.2fx\n", name, "seq", base, 1.0);
+    for (std::size_t t = 1;; t = std::min(t * 2, max_threads)) {
+        const double ms = par(t);
+        std::printf("%-8s %8zu %12.3f %7.2fx\n", name, t, ms, ms > 0.0 ? base / ms : 0.0);
+        if (t == max_threads) break;
+    }
+}
+
+void Usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-n elements] [-t max_threads] [-r reps]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t n = 10000000;
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    int reps = 3;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            n = static_cast<std::size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (arg == "-t" && i + 1 < argc) {
+            max_threads = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "-r" && i + 1 < argc) {
+            reps = std::max(1, std::atoi(argv[++i]));
+        } else {
+            Usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::mt19937 rng(17);
+    mystl::vector<int> input;
+    input.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        input.push_back(static_cast<int>(rng()));
+    }
+    mystl::vector<int> work(input);
+
+    std::printf("elements=%zu hardware_concurrency=%u\n", n, std::thread::hardware_concurrency());
+    std::printf("%-8s %8s %12s %8s\n", "algo", "threads", "ms", "speedup");
+    Scale(
+        "sort", max_threads, [&] { return SortMillis(reps, input, work, [](int* f, int* l) { mystl::sort(f, l); }); },
+        [&](std::size_t t) {
+            return SortMillis(reps, input, work, [t](int* f, int* l) { mystl::parallel_sort(f, l, mystl::less<int>(), t); });
+        });
+
+    // 归约和前缀和受内存带宽限制, 多跑几轮
+    mystl::vector<std::int64_t> metrics(input.begin(), input.end());
+    mystl::vector<std::int64_t> prefix(n);
+    const int scan_reps = reps * 10;
+    const std::int64_t* first = metrics.data();
+    const std::int64_t* last = metrics.data() + n;
+    Scale(
+        "reduce", max_threads,
+        [&] { return Millis(scan_reps, [&] { return mystl::reduce(first, last, std::int64_t(0)); }); },
+        [&](std::size_t t) {
+            return Millis(scan_reps, [&] {
+                return mystl::parallel_reduce(first, last, std::int64_t(0), mystl::plus<std::int64_t>(), t);
+            });
+        });
+    Scale(
+        "scan", max_threads,
+        [&] {
+            return Millis(scan_reps, [&] {
+                mystl::inclusive_scan(first, last, prefix.data());
+                return prefix[n - 1];
+            });
+        },
+        [&](std::size_t t) {
+            return Millis(scan_reps, [&] {
+                mystl::parallel_inclusive_scan(first, last, prefix.data(), mystl::plus<std::int64_t>(), std::int64_t(0), t);
+                return prefix[n - 1];
+            });
+        });
+    return 0;
+}
@@ -0,0 +1,487 @@
+// 用 csapp malloc lab 的 trace 回放分配请求, 对比 MyAllocator、系统分配器和 Arena 的
+// 吞吐(ops/s)、峰值占用和空间利用率(峰值有效载荷 / 峰值占用, 与 mdriver 的定义相同)
+//
+// 用法: mystl_bench [-n 重复次数] [-t trace 目录] [trace 文件...]
+// 不指定 trace 文件时使用 mdriver 默认的 trace 列表
+
+#include "arena.h"
+#include "my_allocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifndef MYSTL_TRACE_DIR
+#define MYSTL_TRACE_DIR "book/csapp/code/vm/malloc/traces"
+#endif
+
+namespace {
+
+const char* const DEFAULT_TRACES[] = {
+    "corners.rep", "short2.rep", "malloc.rep", "binary-bal.rep", "coalescing-bal.rep",
+    "fs.rep", "hostname.rep", "login.rep", "ls.rep", "perl.rep",
+    "random-bal.rep", "rm.rep", "xterm.rep"};
+
+// 占用无法测量时(统计关闭或非 glibc)为 NO_FOOTPRINT
+const std::size_t NO_FOOTPRINT = static_cast<std::size_t>(-1);
+
+struct TraceOp {
+    char type; // 'a' 分配, 'r' 重新分配, 'f' 释放
+    long id;
+    std::size_t size;
+};
+
+struct Trace {
+    std::string name;
+    std::size_t numIds;
+    std::vector<TraceOp> ops;
+};
+
+// 文件头依次为 weight、num_ids、num_ops、ignore_ranges, 之后每行一个请求
+bool ReadTrace(const std::string& path, Trace& trace) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+        return false;
+    }
+    long weight = 0;
+    long numIds = 0;
+    long numOps = 0;
+    long ignoreRanges = 0;
+    if (!(in >> weight >> numIds >> numOps >> ignoreRanges) || numIds < 0 || numOps < 0) {
+        return false;
+    }
+    const std::size_t slash = path.find_last_of("/\\");
+    trace.name = slash == std::string::npos ? path : path.substr(slash + 1);
+    trace.numIds = static_cast<std::size_t>(numIds);
+    trace.ops.clear();
+    trace.ops.reserve(static_cast<std::size_t>(numOps));
+    std::string type;
+    while (trace.ops.size() < static_cast<std::size_t>(numOps) && in >> type) {
+        TraceOp op = {type[0], 0, 0};
+        if (!(in >> op.id)) {
+            return false;
+        }
+        if (op.type == 'a' || op.type == 'r') {
+            if (!(in >> op.size)) {
+                return false;
+            }
+        } else if (op.type != 'f') {
+            return false;
+        }
+        if (op.id >= numIds) {
+            return false;
+        }
+        trace.ops.push_back(op);
+    }
+    return trace.ops.size() == static_cast<std::size_t>(numOps);
+}
+
+// 分配器适配层: Allocate/Deallocate/Reallocate 以及 Footprint(当前向系统占用的字节数)
+
+class PoolPolicy {
+public:
+    PoolPolicy() :
+        alloc_(mystl::MyAllocator::GetInstance()) {
+    }
+
+    static const char* Name() {
+        return "MyAllocator";
+    }
+
+    void* Allocate(std::size_t bytes) {
+        if (bytes > mystl::MyAllocator::BLOCK_SIZE) {
+            largeLive_ += bytes;
+        }
+        return alloc_->Allocate(bytes);
+    }
+
+    void Deallocate(void* ptr, std::size_t bytes) {
+        if (bytes > mystl::MyAllocator::BLOCK_SIZE) {
+            largeLive_ -= bytes;
+        }
+        alloc_->Deallocate(static_cast<unsigned char*>(ptr), bytes);
+    }
+
+    void* Reallocate(void* ptr, std::size_t oldBytes, std::size_t bytes) {
+        void* result = Allocate(bytes);
+        std::memcpy(result, ptr, std::min(oldBytes, bytes));
+        Deallocate(ptr, oldBytes);
+        return result;
+    }
+
+    // 所有 Pool 持有的 chunk 加上转交 operator new 的大块, 需要打开 MYSTL_ALLOCATOR_STATS
+    std::size_t Footprint() {
+        const mystl::AllocatorStats stats = alloc_->GetStats();
+        if (!stats.enabled) {
+            return NO_FOOTPRINT;
+        }
+        return stats.reservedBytes + largeLive_;
+    }
+
+private:
+    mystl::MyAllocator* alloc_;
+    std::size_t largeLive_{0};
+};
+
+class MallocPolicy {
+public:
+    MallocPolicy() :
+        baseHeap_(HeapBytes()), baseInUse_(InUseBytes()) {
+    }
+
+    static const char* Name() {
+        return "malloc";
+    }
+
+    void* Allocate(std::size_t bytes) {
+        void* ptr = std::malloc(bytes);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void Deallocate(void* ptr, std::size_t) {
+        std::free(ptr);
+    }
+
+    void* Reallocate(void* ptr, std::size_t, std::size_t bytes) {
+        void* result = std::realloc(ptr, bytes);
+        if (result == nullptr) {
+            throw std::bad_alloc();
+        }
+        return result;
+    }
+
+    // 堆的增长量与已分配块(含块头)的增长量取大者; 请求很少时堆不必增长, 只能看到后者
+    std::size_t Footprint() {
+        const std::size_t heap = HeapBytes();
+        const std::size_t inUse = InUseBytes();
+        if (heap == NO_FOOTPRINT || inUse == NO_FOOTPRINT) {
+            return NO_FOOTPRINT;
+        }
+        return std::max(heap > baseHeap_ ? heap - baseHeap_ : 0U, inUse > baseInUse_ ? inUse - baseInUse_ : 0U);
+    }
+
+private:
+    // brk 堆加上 mmap 出去的大块
+    static std::size_t HeapBytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        const struct mallinfo2 info = ::mallinfo2();
+        return info.arena + info.hblkhd;
+#else
+        return NO_FOOTPRINT;
+#endif
+    }
+
+    static std::size_t InUseBytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        const struct mallinfo2 info = ::mallinfo2();
+        return info.uordblks + info.hblkhd;
+#else
+        return NO_FOOTPRINT;
+#endif
+    }
+
+    std::size_t baseHeap_;
+    std::size_t baseInUse_;
+};
+
+// 每次回放使用一个新的 Arena, 释放不回收内存
+class ArenaPolicy {
+public:
+    static const char* Name() {
+        return "Arena";
+    }
+
+    void* Allocate(std::size_t bytes) {
+        return arena_.Allocate(bytes);
+    }
+
+    void Deallocate(void*, std::size_t) {
+    }
+
+    void* Reallocate(void* ptr, std::size_t oldBytes, std::size_t bytes) {
+        void* result = Allocate(bytes);
+        std::memcpy(result, ptr, std::min(oldBytes, bytes));
+        return result;
+    }
+
+    std::size_t Footprint() {
+        return arena_.BytesReserved();
+    }
+
+private:
+    mystl::Arena arena_;
+};
+
+struct Slot {
+    void* ptr;
+    std::size_t size;
+};
+
+struct NoSample {
+    void operator()(std::size_t) {
+    }
+};
+
+// 每个请求之后采样占用, 记录峰值有效载荷和峰值占用
+template <class Policy>
+struct FootprintSample {
+    Policy* policy;
+    std::size_t peakPayload;
+    std::size_t peakFootprint;
+
+    void operator()(std::size_t payload) {
+        peakPayload = std::max(peakPayload, payload);
+        const std::size_t footprint = policy->Footprint();
+        if (footprint == NO_FOOTPRINT || peakFootprint == NO_FOOTPRINT) {
+            peakFootprint = NO_FOOTPRINT;
+        } else {
+            peakFootprint = std::max(peakFootprint, footprint);
+        }
+    }
+};
+
+// 回放一遍 trace, 结束时释放仍然存活的块
+template <class Policy, class Sample>
+void Replay(const Trace& trace, Policy& policy, std::vector<Slot>& slots, Sample& sample) {
+    slots.assign(trace.numIds, Slot{nullptr, 0U});
+    std::size_t payload = 0;
+    for (const TraceOp& op : trace.ops) {
+        if (op.id < 0) {
+            // free(NULL)
+            continue;
+        }
+        Slot& slot = slots[static_cast<std::size_t>(op.id)];
+        switch (op.type) {
+        case 'a':
+            slot.ptr = policy.Allocate(op.size);
+            slot.size = op.size;
+            payload += op.size;
+            break;
+        case 'r':
+            if (slot.ptr == nullptr) {
+                slot.ptr = policy.Allocate(op.size);
+            } else if (op.size == 0U) {
+                policy.Deallocate(slot.ptr, slot.size);
+                slot.ptr = nullptr;
+            } else {
+                slot.ptr = policy.Reallocate(slot.ptr, slot.size, op.size);
+            }
+            payload = payload - slot.size + (slot.ptr == nullptr ? 0U : op.size);
+            slot.size = slot.ptr == nullptr ? 0U : op.size;
+            break;
+        default:
+            if (slot.ptr != nullptr) {
+                policy.Deallocate(slot.ptr, slot.size);
+                payload -= slot.size;
+                slot.ptr = nullptr;
+                slot.size = 0U;
+            }
+            break;
+        }
+        sample(payload);
+    }
+    for (Slot& slot : slots) {
+        if (slot.ptr != nullptr) {
+            policy.Deallocate(slot.ptr, slot.size);
+        }
+    }
+}
+
+struct Result {
+    double opsPerSec;
+    std::size_t peakPayload;
+    std::size_t peakFootprint;
+
+    double Utilization() const {
+        if (peakFootprint == NO_FOOTPRINT || peakFootprint == 0U) {
+            return -1.0;
+        }
+        return static_cast<double>(peakPayload) / static_cast<double>(peakFootprint);
+    }
+};
+
+// 回放一遍, 每个请求之后采样占用
+template <class Policy>
+void MeasureFootprint(const Trace& trace, Result& result) {
+    // slots 先分配好, 回放时不再向系统分配器申请
+    std::vector<Slot> slots(trace.numIds, Slot{nullptr, 0U});
+    Policy policy;
+    FootprintSample<Policy> sample = {&policy, 0U, 0U};
+    Replay(trace, policy, slots, sample);
+    result.peakPayload = sample.peakPayload;
+    result.peakFootprint = sample.peakFootprint;
+}
+
+// 之前回放留下的空闲内存会被后面的 trace 复用, 占用在新启动的子进程
+// (mystl_bench --footprint 分配器 trace)中测量; 不能启动子进程时退回在本进程中测量
+template <class Policy>
+void MeasureFootprintIsolated(const char* prog, const Trace& trace, const std::string& file, Result& result) {
+#ifndef _WIN32
+    const std::string self = prog;
+    if (self.find('\'') == std::string::npos && file.find('\'') == std::string::npos) {
+        const std::string cmd = "'" + self + "' --footprint " + Policy::Name() + " '" + file + "'";
+        FILE* pipe = ::popen(cmd.c_str(), "r");
+        if (pipe != nullptr) {
+            std::size_t payload = 0;
+            std::size_t footprint = 0;
+            const bool ok = std::fscanf(pipe, "%zu %zu", &payload, &footprint) == 2;
+            if (::pclose(pipe) == 0 && ok) {
+                result.peakPayload = payload;
+                result.peakFootprint = footprint;
+                return;
+            }
+        }
+    }
+#else
+    (void)prog;
+    (void)file;
+#endif
+    MeasureFootprint<Policy>(trace, result);
+}
+
+// 计时回放 reps 遍
+template <class Policy>
+void MeasureThroughput(const Trace& trace, int reps, Result& result) {
+    std::vector<Slot> slots(trace.numIds, Slot{nullptr, 0U});
+    NoSample none;
+    double seconds = 0.0;
+    for (int i = 0; i < reps; ++i) {
+        Policy policy;
+        const auto start = std::chrono::steady_clock::now();
+        Replay(trace, policy, slots, none);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    result.opsPerSec = seconds > 0.0 ? static_cast<double>(trace.ops.size()) * reps / seconds : 0.0;
+}
+
+template <class Policy>
+Result Run(const char* prog, const Trace& trace, const std::string& file, int reps) {
+    Result result = Result();
+    MeasureFootprintIsolated<Policy>(prog, trace, file, result);
+    MeasureThroughput<Policy>(trace, reps, result);
+    return result;
+}
+
+// 子进程: 只测量一个分配器在一个 trace 上的占用, 输出"峰值有效载荷 峰值占用"
+int FootprintMain(const std::string& name, const std::string& file) {
+    Trace trace;
+    if (!ReadTrace(file, trace)) {
+        return 1;
+    }
+    Result result = Result();
+    if (name == PoolPolicy::Name()) {
+        MeasureFootprint<PoolPolicy>(trace, result);
+    } else if (name == MallocPolicy::Name()) {
+        MeasureFootprint<MallocPolicy>(trace, result);
+    } else if (name == ArenaPolicy::Name()) {
+        MeasureFootprint<ArenaPolicy>(trace, result);
+    } else {
+        return 1;
+    }
+    std::printf("%zu %zu\n", result.peakPayload, result.peakFootprint);
+    return 0;
+}
+
+struct Total {
+    const char* name;
+    double ops;
+    double seconds;
+    double utilSum;
+    int utilCount;
+};
+
+void Report(const Trace& trace, const char* name, const Result& r, Total& total) {
+    char footprint[32];
+    char util[16];
+    if (r.Utilization() < 0.0) {
+        std::snprintf(footprint, sizeof(footprint), "-");
+        std::snprintf(util, sizeof(util), "-");
+    } else {
+        std::snprintf(footprint, sizeof(footprint), "%zu", r.peakFootprint);
+        std::snprintf(util, sizeof(util), "%.1f%%", r.Utilization() * 100.0);
+    }
+    std::printf("%-20s %-12s %8zu %12.0f %14zu %14s %8s\n", trace.name.c_str(), name, trace.ops.size(), r.opsPerSec,
+                r.peakPayload, footprint, util);
+
+    total.ops += static_cast<double>(trace.ops.size());
+    total.seconds += r.opsPerSec > 0.0 ? static_cast<double>(trace.ops.size()) / r.opsPerSec : 0.0;
+    if (r.Utilization() >= 0.0) {
+        total.utilSum += r.Utilization();
+        ++total.utilCount;
+    }
+}
+
+void Usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-n reps] [-t tracedir] [tracefile...]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--footprint") {
+        return FootprintMain(argv[2], argv[3]);
+    }
+
+    int reps = 20;
+    std::string traceDir = MYSTL_TRACE_DIR;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            reps = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-t" && i + 1 < argc) {
+            traceDir = argv[++i];
+        } else if (arg == "-h" || (!arg.empty() && arg[0] == '-')) {
+            Usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        for (const char* name : DEFAULT_TRACES) {
+            files.push_back(traceDir + "/" + name);
+        }
+    }
+
+    Total totals[] = {{PoolPolicy::Name(), 0.0, 0.0, 0.0, 0},
+                      {MallocPolicy::Name(), 0.0, 0.0, 0.0, 0},
+                      {ArenaPolicy::Name(), 0.0, 0.0, 0.0, 0}};
+
+    std::printf("%-20s %-12s %8s %12s %14s %14s %8s\n", "trace", "allocator", "ops", "ops/s", "peak payload",
+                "peak footprint", "util");
+    for (const std::string& file : files) {
+        Trace trace;
+        if (!ReadTrace(file, trace)) {
+            std::fprintf(stderr, "cannot read trace %s\n", file.c_str());
+            return 1;
+        }
+        Report(trace, PoolPolicy::Name(), Run<PoolPolicy>(argv[0], trace, file, reps), totals[0]);
+        Report(trace, MallocPolicy::Name(), Run<MallocPolicy>(argv[0], trace, file, reps), totals[1]);
+        Report(trace, ArenaPolicy::Name(), Run<ArenaPolicy>(argv[0], trace, file, reps), totals[2]);
+    }
+
+    std::printf("\n%-12s %12s %10s\n", "allocator", "ops/s", "avg util");
+    for (const Total& t : totals) {
+        char util[16];
+        if (t.utilCount == 0) {
+            std::snprintf(util, sizeof(util), "-");
+        } else {
+            std::snprintf(util, sizeof(util), "%.1f%%", t.utilSum / t.utilCount * 100.0);
+        }
+        std::printf("%-12s %12.0f %10s\n", t.name, t.seconds > 0.0 ? t.ops / t.seconds : 0.0, util);
+    }
+    return 0;
+}
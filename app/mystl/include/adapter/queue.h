@@ -6,6 +6,7 @@
 #include "deque.h"
 #include "vector.h"
 #include "algorithm.h"
+#include "heap.h"
 #include "allocator.h"
 #include "utility.h"
 
@@ -268,6 +269,139 @@ template <typename T, typename Container, typename Compare>
 void swap(priority_queue<T, Container, Compare>& x, priority_queue<T, Container, Compare>& y) {
     x.swap(y);
 }
+
+/*
+ * top_k: 从任意长的输入流中保留按 Compare 排序最靠后的 k 个元素(默认 less, 即最大的 k 个)
+ * 内部是大小不超过 k 的堆, 堆顶为已保留元素中最小的一个; 新元素只在比堆顶大时替换堆顶
+ * 每个元素 O(log k), 内存 O(k)
+ */
+template <typename T, typename Compare = mystl::less<T>>
+class top_k {
+public: // member types
+    using container_type = mystl::vector<T>;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using const_iterator = typename container_type::const_iterator;
+    using value_compare = Compare;
+
+public: // member functions
+    explicit top_k(size_type k, const Compare& comp = Compare()) :
+        heap_(), k_(k), comp_{comp} {
+        heap_.reserve(k);
+    }
+
+    /*
+     * @brief Capacity
+     */
+    size_type size() const noexcept {
+        return heap_.size();
+    }
+
+    bool empty() const noexcept {
+        return heap_.empty();
+    }
+
+    bool full() const noexcept {
+        return heap_.size() == k_;
+    }
+
+    size_type k() const noexcept {
+        return k_;
+    }
+
+    /*
+     * @brief Element access
+     */
+    // 已保留元素中最小的一个, 装满之后新元素要比它大才会被保留
+    const_reference top() const {
+        return heap_.front();
+    }
+
+    // 按堆的存放顺序遍历, 不是有序的
+    const_iterator begin() const noexcept {
+        return heap_.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return heap_.end();
+    }
+
+    // 保留的元素, 从大到小
+    container_type sorted() const {
+        container_type result(heap_);
+        mystl::sort_heap(result.begin(), result.end(), comp_);
+        return result;
+    }
+
+    /*
+     * @brief Modifiers
+     */
+    // 返回元素是否被保留
+    bool push(const value_type& val) {
+        if (heap_.size() < k_) {
+            heap_.push_back(val);
+            mystl::push_heap(heap_.begin(), heap_.end(), comp_);
+            return true;
+        }
+        if (k_ == 0 || !comp_.comp(heap_.front(), val)) return false;
+        replace_top(value_type(val));
+        return true;
+    }
+
+    bool push(value_type&& val) {
+        if (heap_.size() < k_) {
+            heap_.push_back(mystl::move(val));
+            mystl::push_heap(heap_.begin(), heap_.end(), comp_);
+            return true;
+        }
+        if (k_ == 0 || !comp_.comp(heap_.front(), val)) return false;
+        replace_top(mystl::move(val));
+        return true;
+    }
+
+    template <class InputIterator>
+    void push(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
+    void clear() noexcept {
+        heap_.clear();
+    }
+
+    void swap(top_k& x) {
+        mystl::swap(heap_, x.heap_);
+        mystl::swap(k_, x.k_);
+        mystl::swap(comp_, x.comp_);
+    }
+
+private:
+    // 比较方向相反, 堆顶是按 Compare 最小的元素
+    struct inverted_compare {
+        Compare comp;
+        bool operator()(const T& x, const T& y) const {
+            return comp(y, x);
+        }
+    };
+
+    // 新元素放在堆顶的位置并下沉, 原来的堆顶被丢弃
+    void replace_top(value_type&& val) {
+        using diff_t = typename iterator_traits<typename container_type::iterator>::difference_type;
+        mystl::adjust_heap(heap_.begin(), diff_t(0), diff_t(heap_.size()), mystl::move(val), comp_);
+    }
+
+    container_type heap_;
+    size_type k_;
+    inverted_compare comp_;
+};
+
+template <typename T, typename Compare>
+void swap(top_k<T, Compare>& x, top_k<T, Compare>& y) {
+    x.swap(y);
+}
 } // namespace mystl
 
 #endif // MYSTL_QUEUE_H_
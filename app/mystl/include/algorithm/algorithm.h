@@ -4,7 +4,9 @@
 #include <type_traits>
 #include <cstring>
 #include "utility.h"
+#include "iterator.h"
 #include "heap.h"
+#include "simd.h"
 
 namespace mystl {
 
@@ -57,8 +59,49 @@ bool any_of(InputIterator first, InputIterator last, UnaryPredicate pred) {
     return false;
 }
 
+template <class InputIterator, class T>
+typename iterator_traits<InputIterator>::difference_type
+__count(InputIterator first, InputIterator last, const T& val, std::false_type) {
+    typename iterator_traits<InputIterator>::difference_type n = 0;
+    for (; first != last; ++first) {
+        if (*first == val) ++n;
+    }
+    return n;
+}
+
+template <class U, class T>
+std::ptrdiff_t __count(U* first, U* last, const T& val, std::true_type) {
+    return simd::count<T>(first, last, val);
+}
+
+template <class InputIterator, class T>
+typename iterator_traits<InputIterator>::difference_type
+count(InputIterator first, InputIterator last, const T& val) {
+    return mystl::__count(first, last, val, simd::is_simd_range<InputIterator, T>());
+}
+
+template <class InputIterator, class UnaryPredicate>
+typename iterator_traits<InputIterator>::difference_type
+count_if(InputIterator first, InputIterator last, UnaryPredicate pred) {
+    typename iterator_traits<InputIterator>::difference_type n = 0;
+    for (; first != last; ++first) {
+        if (pred(*first)) ++n;
+    }
+    return n;
+}
+
+// 逐字节比较与逐个 == 等价的类型: 整数和指针, 浮点数有 -0.0 和 NaN 所以不行
+template <class Iterator1, class Iterator2>
+struct is_memcmp_comparable : std::false_type {};
+
+template <class T, class U>
+struct is_memcmp_comparable<T*, U*>
+    : std::integral_constant<bool, std::is_same<typename std::remove_cv<T>::type, typename std::remove_cv<U>::type>::value
+                                       && (std::is_integral<T>::value || std::is_pointer<T>::value)
+                                       && !std::is_volatile<T>::value && !std::is_volatile<U>::value> {};
+
 template <class InputIterator1, class InputIterator2>
-bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+bool __equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, std::false_type) {
     while (first1 != last1) {
         if (!(*first1 == *first2))
             return false;
@@ -68,6 +111,17 @@ bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
     return true;
 }
 
+template <class T, class U>
+bool __equal(T* first1, T* last1, U* first2, std::true_type) {
+    const std::size_t n = static_cast<std::size_t>(last1 - first1);
+    return n == 0U || std::memcmp(first1, first2, n * sizeof(T)) == 0;
+}
+
+template <class InputIterator1, class InputIterator2>
+bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+    return mystl::__equal(first1, last1, first2, is_memcmp_comparable<InputIterator1, InputIterator2>());
+}
+
 template <class InputIterator1, class InputIterator2, class BinaryPredicate>
 bool equal(InputIterator1 first1, InputIterator1 last1,
            InputIterator2 first2, BinaryPredicate pred) {
@@ -80,16 +134,45 @@ bool equal(InputIterator1 first1, InputIterator1 last1,
     return true;
 }
 
+// 可以用 memset 填充的区间: 指向非 const 整数类型的指针
+template <class Iterator>
+struct is_memset_fillable : std::false_type {};
+
+template <class T>
+struct is_memset_fillable<T*>
+    : std::integral_constant<bool, std::is_integral<T>::value && !std::is_const<T>::value
+                                       && !std::is_volatile<T>::value> {};
+
 template <class ForwardIterator, class T>
-void fill(ForwardIterator first, ForwardIterator last, const T& val) {
+void __fill(ForwardIterator first, ForwardIterator last, const T& val, std::false_type) {
     while (first != last) {
         *first = val;
         ++first;
     }
 }
 
+// 单字节类型任意值都可以 memset, 更宽的整数只有填 0 时可以
+template <class U, class T>
+void __fill(U* first, U* last, const T& val, std::true_type) {
+    const U tmp = static_cast<U>(val);
+    if (sizeof(U) == 1U || tmp == U()) {
+        unsigned char byte = 0U;
+        std::memcpy(&byte, &tmp, 1U);
+        if (first != last) {
+            std::memset(first, byte, static_cast<std::size_t>(last - first) * sizeof(U));
+        }
+        return;
+    }
+    mystl::__fill(first, last, tmp, std::false_type());
+}
+
+template <class ForwardIterator, class T>
+void fill(ForwardIterator first, ForwardIterator last, const T& val) {
+    mystl::__fill(first, last, val, is_memset_fillable<ForwardIterator>());
+}
+
 template <class OutputIterator, class Size, class T>
-OutputIterator fill_n(OutputIterator first, Size n, const T& val) {
+OutputIterator __fill_n(OutputIterator first, Size n, const T& val, std::false_type) {
     while (n > 0) {
         *first = val;
         ++first;
@@ -98,9 +181,50 @@ OutputIterator fill_n(OutputIterator first, Size n, const T& val) {
     return first; // since C++11
 }
 
+template <class U, class Size, class T>
+U* __fill_n(U* first, Size n, const T& val, std::true_type) {
+    if (n <= 0) {
+        return first;
+    }
+    mystl::__fill(first, first + n, val, std::true_type());
+    return first + n;
+}
+
+template <class OutputIterator, class Size, class T>
+OutputIterator fill_n(OutputIterator first, Size n, const T& val) {
+    return mystl::__fill_n(first, n, val, is_memset_fillable<OutputIterator>());
+}
+
+template <class InputIterator, class T>
+InputIterator __find(InputIterator first, InputIterator last, const T& val, std::false_type) {
+    while (first != last && !(*first == val)) {
+        ++first;
+    }
+    return first;
+}
+
+template <class U, class T>
+U* __find(U* first, U* last, const T& val, std::true_type) {
+    return first + (simd::find<T>(first, last, val) - first);
+}
+
+// vector、array 等连续区间上的算术类型使用 SIMD 比较
+template <class InputIterator, class T>
+InputIterator find(InputIterator first, InputIterator last, const T& val) {
+    return mystl::__find(first, last, val, simd::is_simd_range<InputIterator, T>());
+}
+
+template <class InputIterator, class UnaryPredicate>
+InputIterator find_if(InputIterator first, InputIterator last, UnaryPredicate pred) {
+    while (first != last && !pred(*first)) {
+        ++first;
+    }
+    return first;
+}
+
 template <class ForwardIterator1, class ForwardIterator2>
 void iter_swap(ForwardIterator1 a, ForwardIterator2 b) {
-    swap(*a, *b);
+    mystl::swap(*a, *b);
 }
 
 template <class InputIterator1, class InputIterator2>
@@ -142,6 +266,41 @@ const T& max(const T& a, const T& b, Compare comp) {
     return comp(a, b) ? b : a;
 }
 
+template <class ForwardIterator, class Compare>
+ForwardIterator max_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+    if (first == last) return last;
+    ForwardIterator result = first;
+    while (++first != last) {
+        if (comp(*result, *first)) result = first;
+    }
+    return result;
+}
+
+template <class ForwardIterator>
+ForwardIterator __max_element(ForwardIterator first, ForwardIterator last, std::false_type) {
+    if (first == last) return last;
+    ForwardIterator result = first;
+    while (++first != last) {
+        if (*result < *first) result = first;
+    }
+    return result;
+}
+
+template <class U>
+U* __max_element(U* first, U* last, std::true_type) {
+    using T = typename std::remove_cv<U>::type;
+    const T* result = simd::extreme_element<true, T>(first, last);
+    if (result == nullptr) { // CPU 不支持
+        return mystl::__max_element(first, last, std::false_type());
+    }
+    return first + (result - first);
+}
+
+template <class ForwardIterator>
+ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
+    return mystl::__max_element(first, last, simd::is_simd_minmax_range<ForwardIterator>());
+}
+
 template <class T>
 const T& min(const T& a, const T& b) {
     return (a > b) ? b : a;
@@ -152,6 +311,41 @@ const T& min(const T& a, const T& b, Compare comp) {
     return comp(b, a) ? b : a;
 }
 
+template <class ForwardIterator, class Compare>
+ForwardIterator min_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+    if (first == last) return last;
+    ForwardIterator result = first;
+    while (++first != last) {
+        if (comp(*first, *result)) result = first;
+    }
+    return result;
+}
+
+template <class ForwardIterator>
+ForwardIterator __min_element(ForwardIterator first, ForwardIterator last, std::false_type) {
+    if (first == last) return last;
+    ForwardIterator result = first;
+    while (++first != last) {
+        if (*first < *result) result = first;
+    }
+    return result;
+}
+
+template <class U>
+U* __min_element(U* first, U* last, std::true_type) {
+    using T = typename std::remove_cv<U>::type;
+    const T* result = simd::extreme_element<false, T>(first, last);
+    if (result == nullptr) { // CPU 不支持
+        return mystl::__min_element(first, last, std::false_type());
+    }
+    return first + (result - first);
+}
+
+template <class ForwardIterator>
+ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
+    return mystl::__min_element(first, last, simd::is_simd_minmax_range<ForwardIterator>());
+}
+
 template <class InputIterator1, class InputIterator2>
 pair<InputIterator1, InputIterator2>
 mismatch(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
@@ -173,6 +367,17 @@ mismatch(InputIterator1 first1, InputIterator1 last1,
     return make_pair(first1, first2);
 }
 
+/*
+ * copy / move: 源和目标都是指针, 元素类型相同且可平凡复制时降为一次 memmove
+ */
+template <class InputIterator, class OutputIterator>
+struct is_memmove_copyable : std::false_type {};
+
+template <class T, class U>
+struct is_memmove_copyable<T*, U*>
+    : std::integral_constant<bool, std::is_same<typename std::remove_const<T>::type, U>::value
+                                       && std::is_trivially_copyable<U>::value> {};
+
 template <class InputIterator, class OutputIterator>
 OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result, input_iterator_tag) {
     while (first != last) {
@@ -183,83 +388,62 @@ OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator re
     return result;
 }
 
-template <class RandomAccessIterator, class OutputIterator, class Distance>
-inline OutputIterator __copy_d(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result, Distance*) {
-    Distance n = last - first;
-    while (n > 0) {
+template <class RandomAccessIterator, class OutputIterator>
+OutputIterator __copy(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                      random_access_iterator_tag) {
+    for (auto n = last - first; n > 0; --n) {
         *result = *first;
         ++result;
         ++first;
-        --n;
     }
     return result;
 }
 
 template <class InputIterator, class OutputIterator>
-OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result, random_access_iterator_tag) {
-    return __copy_d(first, last, result, distance_type(first));
-}
-
-template <class InputIterator, class OutputIterator>
-OutputIterator __copy_dispatch(InputIterator first, InputIterator last, OutputIterator result) {
-    return __copy<InputIterator, OutputIterator>(first, last, result, iterator_category(first));
-}
-
-template <class T>
-T* __copy_t(T* first, T* last, T* result, std::true_type) {
-    std::memmove(result, first, (last - first) * sizeof(T));
-    return result;
-}
-
-template <class T>
-T* __copy_t(T* first, T* last, T* result, std::false_type) {
-    return __copy_d(first, last, result, (ptrdiff_t*)0);
-}
-
-template <class T>
-T* __copy_dispatch(T* first, T* last, T* result) {
-    return __copy_t(first, last, result, std::is_trivial<T>::type);
+OutputIterator __copy_dispatch(InputIterator first, InputIterator last, OutputIterator result, std::false_type) {
+    return __copy(first, last, result, iterator_category(first));
 }
 
-template <class T>
-T* __copy_dispatch(const T* first, const T* last, T* result) {
-    return __copy_t(first, last, result, std::is_trivial<T>::type);
+// memmove 允许重叠, copy 和 move 共用
+template <class T, class U>
+U* __copy_dispatch(T* first, T* last, U* result, std::true_type) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n != 0U) {
+        std::memmove(result, first, n * sizeof(U));
+    }
+    return result + n;
 }
 
 template <class InputIterator, class OutputIterator>
 OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result) {
-    return __copy_dispatch<InputIterator, OutputIterator>(first, last, result);
+    return mystl::__copy_dispatch(first, last, result, is_memmove_copyable<InputIterator, OutputIterator>());
 }
 
 template <class BidirectionalIterator1, class BidirectionalIterator2>
-BidirectionalIterator2 copy_backward(BidirectionalIterator1 first,
-                                     BidirectionalIterator1 last,
-                                     BidirectionalIterator2 result) {
+BidirectionalIterator2 __copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                       BidirectionalIterator2 result, std::false_type) {
     while (last != first) { *(--result) = *(--last); }
     return result;
 }
 
-/*
- *@bug multiple definition
-
-// 针对 char* 的特化版本
-template <>
-char* copy(const char* first, const char* last, char* result) {
-    std::memmove(result, first, last - first);
-    return result;
+template <class T, class U>
+U* __copy_backward(T* first, T* last, U* result, std::true_type) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n != 0U) {
+        std::memmove(result - n, first, n * sizeof(U));
+    }
+    return result - n;
 }
 
-// 针对 wchar_t* 的特化版本
-template <>
-wchar_t* copy(const wchar_t* first, const wchar_t* last, wchar_t* result) {
-    std::memmove(result, first, (last - first) * sizeof(wchar_t));
-    return result;
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+BidirectionalIterator2 copy_backward(BidirectionalIterator1 first,
+                                     BidirectionalIterator1 last,
+                                     BidirectionalIterator2 result) {
+    return mystl::__copy_backward(first, last, result, is_memmove_copyable<BidirectionalIterator1, BidirectionalIterator2>());
 }
 
-*/
-
 template <class InputIterator, class OutputIterator>
-OutputIterator move(InputIterator first, InputIterator last, OutputIterator result) {
+OutputIterator __move(InputIterator first, InputIterator last, OutputIterator result, std::false_type) {
     while (first != last) {
         *result = mystl::move(*first);
         ++result;
@@ -268,12 +452,61 @@ OutputIterator move(InputIterator first, InputIterator last, OutputIterator resu
     return result;
 }
 
+template <class T, class U>
+U* __move(T* first, T* last, U* result, std::true_type) {
+    return mystl::__copy_dispatch(first, last, result, std::true_type());
+}
+
+template <class InputIterator, class OutputIterator>
+OutputIterator move(InputIterator first, InputIterator last, OutputIterator result) {
+    return mystl::__move(first, last, result, is_memmove_copyable<InputIterator, OutputIterator>());
+}
+
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+BidirectionalIterator2 __move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                       BidirectionalIterator2 result, std::false_type) {
+    while (last != first) *(--result) = mystl::move(*(--last));
+    return result;
+}
+
+template <class T, class U>
+U* __move_backward(T* first, T* last, U* result, std::true_type) {
+    return mystl::__copy_backward(first, last, result, std::true_type());
+}
+
 template <class BidirectionalIterator1, class BidirectionalIterator2>
 BidirectionalIterator2 move_backward(BidirectionalIterator1 first,
                                      BidirectionalIterator1 last,
                                      BidirectionalIterator2 result) {
-    while (last != first) *(--result) = std::move(*(--last));
-    return result;
+    return mystl::__move_backward(first, last, result, is_memmove_copyable<BidirectionalIterator1, BidirectionalIterator2>());
+}
+
+template <class BidirectionalIterator>
+void reverse(BidirectionalIterator first, BidirectionalIterator last) {
+    while (first != last && first != --last) {
+        mystl::iter_swap(first, last);
+        ++first;
+    }
+}
+
+// 三次翻转实现, 返回原来的 first 移动后所在的位置
+template <class BidirectionalIterator>
+BidirectionalIterator rotate(BidirectionalIterator first, BidirectionalIterator middle,
+                             BidirectionalIterator last) {
+    if (first == middle) return last;
+    if (middle == last) return first;
+    mystl::reverse(first, middle);
+    mystl::reverse(middle, last);
+    while (first != middle && middle != last) {
+        mystl::iter_swap(first, --last);
+        ++first;
+    }
+    if (first == middle) {
+        mystl::reverse(middle, last);
+        return last;
+    }
+    mystl::reverse(first, middle);
+    return first;
 }
 
 /*
@@ -446,18 +679,144 @@ OutputIterator set_union(InputIterator1 first1, InputIterator1 last1,
 /*
  * search
  */
+// 没有给出比较器时用 operator<, 两边类型可以不同
+struct __less_op {
+    template <class T1, class T2>
+    bool operator()(const T1& x, const T2& y) const {
+        return x < y;
+    }
+};
+
+// 只对指针预取, 其他迭代器取地址本身就要付出代价
+template <class RandomAccessIterator, class Distance>
+inline void __search_prefetch(RandomAccessIterator, Distance, std::false_type) {
+}
+
+template <class T, class Distance>
+inline void __search_prefetch(T* base, Distance offset, std::true_type) {
+    __builtin_prefetch(base + offset);
+}
+
+template <class ForwardIterator, class T, class Compare>
+ForwardIterator __lower_bound(ForwardIterator first, ForwardIterator last, const T& val, Compare comp,
+                              forward_iterator_tag) {
+    auto len = mystl::distance(first, last);
+    while (len > 0) {
+        auto half = len / 2;
+        ForwardIterator mid = first;
+        mystl::advance(mid, half);
+        if (comp(*mid, val)) {
+            first = ++mid;
+            len = len - half - 1;
+        } else {
+            len = half;
+        }
+    }
+    return first;
+}
+
+// 无分支版本: 每次只收缩区间长度, 起点用条件传送更新, 比较结果不会导致分支预测失败;
+// 循环次数只取决于长度, 下一轮可能访问的两个位置提前预取
+template <class RandomAccessIterator, class T, class Compare>
+RandomAccessIterator __lower_bound(RandomAccessIterator first, RandomAccessIterator last, const T& val,
+                                   Compare comp, random_access_iterator_tag) {
+    auto len = last - first;
+    if (len == 0) return first;
+    while (len > 1) {
+        const auto half = len / 2;
+        len -= half;
+        mystl::__search_prefetch(first, len / 2, std::is_pointer<RandomAccessIterator>());
+        mystl::__search_prefetch(first, half + len / 2, std::is_pointer<RandomAccessIterator>());
+        first = comp(first[half], val) ? first + half : first;
+    }
+    return comp(*first, val) ? first + 1 : first;
+}
+
+template <class ForwardIterator, class T, class Compare>
+ForwardIterator __upper_bound(ForwardIterator first, ForwardIterator last, const T& val, Compare comp,
+                              forward_iterator_tag) {
+    auto len = mystl::distance(first, last);
+    while (len > 0) {
+        auto half = len / 2;
+        ForwardIterator mid = first;
+        mystl::advance(mid, half);
+        if (comp(val, *mid)) {
+            len = half;
+        } else {
+            first = ++mid;
+            len = len - half - 1;
+        }
+    }
+    return first;
+}
+
+template <class RandomAccessIterator, class T, class Compare>
+RandomAccessIterator __upper_bound(RandomAccessIterator first, RandomAccessIterator last, const T& val,
+                                   Compare comp, random_access_iterator_tag) {
+    auto len = last - first;
+    if (len == 0) return first;
+    while (len > 1) {
+        const auto half = len / 2;
+        len -= half;
+        mystl::__search_prefetch(first, len / 2, std::is_pointer<RandomAccessIterator>());
+        mystl::__search_prefetch(first, half + len / 2, std::is_pointer<RandomAccessIterator>());
+        first = comp(val, first[half]) ? first : first + half;
+    }
+    return comp(val, *first) ? first : first + 1;
+}
+
+// 返回第一个不小于 val 的位置
+template <class ForwardIterator, class T, class Compare>
+ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                            const T& val, Compare comp) {
+    return mystl::__lower_bound(first, last, val, comp, iterator_category(first));
+}
+
 template <class ForwardIterator, class T>
-bool binary_search(ForwardIterator first, ForwardIterator last,
-                   const T& val) {
-    if (first == last) return false;
-    ForwardIterator mid = (last + first) / 2U;
-    if (*mid == val) return true;
-    return binary_search(first, mid) || binary_search(mid, last);
+ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                            const T& val) {
+    return mystl::lower_bound(first, last, val, __less_op());
+}
+
+// 返回第一个大于 val 的位置
+template <class ForwardIterator, class T, class Compare>
+ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                            const T& val, Compare comp) {
+    return mystl::__upper_bound(first, last, val, comp, iterator_category(first));
+}
+
+template <class ForwardIterator, class T>
+ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                            const T& val) {
+    return mystl::upper_bound(first, last, val, __less_op());
+}
+
+// 与 val 等价的元素组成的区间
+template <class ForwardIterator, class T, class Compare>
+pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first, ForwardIterator last,
+                                                   const T& val, Compare comp) {
+    first = mystl::lower_bound(first, last, val, comp);
+    return pair<ForwardIterator, ForwardIterator>(first, mystl::upper_bound(first, last, val, comp));
+}
+
+template <class ForwardIterator, class T>
+pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first, ForwardIterator last,
+                                                   const T& val) {
+    return mystl::equal_range(first, last, val, __less_op());
 }
 
 template <class ForwardIterator, class T, class Compare>
 bool binary_search(ForwardIterator first, ForwardIterator last,
-                   const T& val, Compare comp);
+                   const T& val, Compare comp) {
+    first = mystl::lower_bound(first, last, val, comp);
+    return first != last && !comp(val, *first);
+}
+
+template <class ForwardIterator, class T>
+bool binary_search(ForwardIterator first, ForwardIterator last,
+                   const T& val) {
+    return mystl::binary_search(first, last, val, __less_op());
+}
 
 } // namespace mystl
 
@@ -0,0 +1,948 @@
+#ifndef MYSTL_BTREE_H_
+#define MYSTL_BTREE_H_
+
+#include <cstddef>
+#include <type_traits>
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h"
+#include "utility.h"
+
+namespace mystl {
+
+/*
+ * btree: B+ 树, btree_set/btree_map 的底层实现
+ * - 元素只存放在叶子里, 叶子之间双向链接; 内部结点只存分隔键和孩子指针
+ * - 每个结点约 NodeSize 字节 (默认 256, 即 4 条缓存行), 一个叶子放几十个小元素, 每个元素只摊到几个字节的额外开销;
+ *   查找时每层只有一两次缓存缺失, 树高也只有 rb_tree 的几分之一, 顺序遍历基本是连续访问
+ * - 分隔键满足: 孩子 i 中的键 <= keys[i] <= 孩子 i + 1 中的键; 删除元素时分隔键可以不变, 上述关系仍然成立
+ * - 插入和删除会在结点之间搬动元素, 之后所有迭代器都失效, 这一点与 rb_tree 不同
+ */
+namespace btree_detail {
+
+// 结点中能放下的槽位数, 至少为 Min
+template <std::size_t Bytes, std::size_t Header, std::size_t Slot, std::size_t Min>
+struct node_slots {
+    enum : std::size_t {
+        value = Bytes > Header && (Bytes - Header) / Slot > Min ? (Bytes - Header) / Slot : Min
+    };
+};
+
+struct node_base {
+    node_base* parent;       // 父结点, 根结点为空
+    unsigned short position; // 在父结点孩子数组中的下标
+    unsigned short count;    // 叶子中的元素个数, 内部结点中的分隔键个数
+    bool leaf;
+};
+
+template <class Value, std::size_t Slots>
+struct leaf_node : public node_base {
+    typedef Value value_type;
+    leaf_node* prev;
+    leaf_node* next;
+    typename std::aligned_storage<sizeof(Value), alignof(Value)>::type values[Slots];
+
+    Value* value(std::size_t i) {
+        return reinterpret_cast<Value*>(&values[i]);
+    }
+};
+
+template <class Key, std::size_t Slots>
+struct internal_node : public node_base {
+    typename std::aligned_storage<sizeof(Key), alignof(Key)>::type keys[Slots];
+    node_base* children[Slots + 1];
+
+    Key* key(std::size_t i) {
+        return reinterpret_cast<Key*>(&keys[i]);
+    }
+};
+
+// 把 src 处的对象移到未构造的 dst 处
+template <class T>
+inline void transfer(T* dst, T* src) {
+    mystl::construct(dst, mystl::move(*src));
+    mystl::destroy(src);
+}
+
+} // namespace btree_detail
+
+// btree 的迭代器: 叶子和叶子中的下标, end() 为最右叶子的末尾
+template <class Leaf, class Ref, class Ptr>
+struct btree_iterator {
+    typedef mystl::bidirectional_iterator_tag iterator_category;
+    typedef typename Leaf::value_type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef btree_iterator<Leaf, value_type&, value_type*> iterator;
+    typedef btree_iterator<Leaf, const value_type&, const value_type*> const_iterator;
+    typedef btree_iterator<Leaf, Ref, Ptr> Self;
+
+    Leaf* node;
+    int position;
+
+    btree_iterator() :
+        node(nullptr), position(0) {
+    }
+    btree_iterator(Leaf* x, int pos) :
+        node(x), position(pos) {
+    }
+    btree_iterator(const iterator& it) :
+        node(it.node), position(it.position) {
+    }
+
+    reference operator*() const {
+        return *node->value(position);
+    }
+    pointer operator->() const {
+        return node->value(position);
+    }
+
+    // 非根叶子至少有一个元素, 走到叶子末尾时跳到下一个叶子的开头
+    Self& operator++() {
+        if (++position == node->count && node->next != nullptr) {
+            node = node->next;
+            position = 0;
+        }
+        return *this;
+    }
+    Self operator++(int) {
+        Self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    Self& operator--() {
+        if (position == 0) {
+            node = node->prev;
+            position = node->count;
+        }
+        --position;
+        return *this;
+    }
+    Self operator--(int) {
+        Self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    friend bool operator==(const Self& x, const Self& y) {
+        return x.node == y.node && x.position == y.position;
+    }
+    friend bool operator!=(const Self& x, const Self& y) {
+        return !(x == y);
+    }
+};
+
+template <class Key, class Value, class KeyOfValue, class Compare,
+          class Alloc = mystl::allocator<Value>, std::size_t NodeSize = 256>
+class btree : private allocator_holder<Alloc> {
+    typedef allocator_holder<Alloc> holder_type;
+    using holder_type::get_alloc;
+    typedef btree_detail::node_base node_base;
+
+public:
+    // 叶子至少放 4 个元素, 内部结点至少放 3 个分隔键
+    enum : std::size_t {
+        leaf_slots = btree_detail::node_slots<NodeSize, sizeof(node_base) + 2 * sizeof(void*), sizeof(Value), 4>::value,
+        internal_slots = btree_detail::node_slots<NodeSize, sizeof(node_base) + sizeof(void*),
+                                                  sizeof(Key) + sizeof(void*), 3>::value
+    };
+
+    typedef btree_detail::leaf_node<Value, leaf_slots> leaf_node;
+    typedef btree_detail::internal_node<Key, internal_slots> internal_node;
+
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef Alloc allocator_type;
+
+    typedef btree_iterator<leaf_node, reference, pointer> iterator;
+    typedef btree_iterator<leaf_node, const_reference, const_pointer> const_iterator;
+    typedef mystl::reverse_iterator<iterator> reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+private:
+    // 元素少于下限时向兄弟借或与兄弟合并; 合并后不超过容量: (min - 1) + min <= slots, (min - 1) + 1 + min <= slots
+    enum : std::size_t {
+        leaf_min = leaf_slots / 2,
+        internal_min = internal_slots / 2
+    };
+    typedef typename allocator_traits<leaf_node, Alloc>::allocator_type leaf_allocator;
+    typedef typename allocator_traits<internal_node, Alloc>::allocator_type internal_allocator;
+    typedef allocator_traits<Value, Alloc> alloc_traits;
+
+    node_base* root_;
+    leaf_node* leftmost_;
+    leaf_node* rightmost_;
+    size_type node_count_;
+    Compare key_compare_;
+
+public:
+    btree() :
+        holder_type(Alloc()), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_compare_() {
+    }
+    btree(const Compare& comp, const allocator_type& a) :
+        holder_type(a), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_compare_(comp) {
+    }
+    explicit btree(const allocator_type& a) :
+        holder_type(a), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_compare_() {
+    }
+    btree(const btree& x) :
+        holder_type(alloc_traits::select_on_container_copy_construction(x.get_alloc())),
+        root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_compare_(x.key_compare_) {
+        copy_from(x);
+    }
+    btree(const btree& x, const allocator_type& a) :
+        holder_type(a), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_compare_(x.key_compare_) {
+        copy_from(x);
+    }
+    // 没有哨兵结点, 移动只交换指针
+    btree(btree&& x) noexcept :
+        holder_type(x.get_alloc()), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0),
+        key_compare_(x.key_compare_) {
+        swap_data(x);
+    }
+    btree(btree&& x, const allocator_type& a) :
+        holder_type(a), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), node_count_(0), key_compare_(x.key_compare_) {
+        if (get_alloc() == x.get_alloc()) {
+            swap_data(x);
+        } else {
+            move_from(x);
+        }
+    }
+    ~btree() {
+        clear();
+    }
+
+    btree& operator=(const btree& x) {
+        if (this != &x) {
+            clear();
+            alloc_traits::copy_assign(get_alloc(), x.get_alloc());
+            key_compare_ = x.key_compare_;
+            copy_from(x);
+        }
+        return *this;
+    }
+
+    btree& operator=(btree&& x) {
+        if (this == &x) {
+            return *this;
+        }
+        clear();
+        if (get_alloc() == x.get_alloc() || alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc_traits::move_assign(get_alloc(), x.get_alloc());
+            swap_data(x);
+        } else {
+            // 分配器不同且不传播, 只能逐个移动元素
+            key_compare_ = x.key_compare_;
+            move_from(x);
+        }
+        return *this;
+    }
+
+public:
+    // accessors:
+    Compare key_comp() const {
+        return key_compare_;
+    }
+    allocator_type get_allocator() const {
+        return get_alloc();
+    }
+    iterator begin() {
+        return root_ ? iterator(leftmost_, 0) : iterator();
+    }
+    const_iterator begin() const {
+        return root_ ? const_iterator(leftmost_, 0) : const_iterator();
+    }
+    iterator end() {
+        return root_ ? iterator(rightmost_, rightmost_->count) : iterator();
+    }
+    const_iterator end() const {
+        return root_ ? const_iterator(rightmost_, rightmost_->count) : const_iterator();
+    }
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+    bool empty() const {
+        return node_count_ == 0;
+    }
+    size_type size() const {
+        return node_count_;
+    }
+    size_type max_size() const {
+        return size_type(-1);
+    }
+
+    // 分配器不传播时, 两棵树的分配器必须相等
+    void swap(btree& t) {
+        MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || get_alloc() == t.get_alloc());
+        alloc_traits::swap(get_alloc(), t.get_alloc());
+        swap_data(t);
+    }
+
+public:
+    // insert/erase
+    template <class V>
+    mystl::pair<iterator, bool> insert_unique(V&& v) {
+        if (root_ == nullptr) {
+            return mystl::pair<iterator, bool>(insert_first(mystl::forward<V>(v)), true);
+        }
+        const iterator pos = descend(KeyOfValue()(v), std::false_type());
+        const iterator next = normalize(pos);
+        if (next != end() && !key_compare_(KeyOfValue()(v), KeyOfValue()(*next))) {
+            return mystl::pair<iterator, bool>(next, false);
+        }
+        return mystl::pair<iterator, bool>(insert_at(pos, mystl::forward<V>(v)), true);
+    }
+
+    // 相等的键插到最后
+    template <class V>
+    iterator insert_equal(V&& v) {
+        if (root_ == nullptr) {
+            return insert_first(mystl::forward<V>(v));
+        }
+        return insert_at(descend(KeyOfValue()(v), std::true_type()), mystl::forward<V>(v));
+    }
+
+    // 提示位置与 v 相邻时省去查找; 以 end() 为提示顺序插入时每次都追加到最右叶子
+    template <class V>
+    iterator insert_unique(const_iterator hint, V&& v) {
+        if (hint_fits(hint, KeyOfValue()(v), std::false_type())) {
+            return insert_at(iterator(hint.node, hint.position), mystl::forward<V>(v));
+        }
+        return insert_unique(mystl::forward<V>(v)).first;
+    }
+    template <class V>
+    iterator insert_equal(const_iterator hint, V&& v) {
+        if (hint_fits(hint, KeyOfValue()(v), std::true_type())) {
+            return insert_at(iterator(hint.node, hint.position), mystl::forward<V>(v));
+        }
+        return insert_equal(mystl::forward<V>(v));
+    }
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace_unique(Args&&... args) {
+        value_type v(mystl::forward<Args>(args)...);
+        return insert_unique(mystl::move(v));
+    }
+    template <class... Args>
+    iterator emplace_hint_unique(const_iterator hint, Args&&... args) {
+        value_type v(mystl::forward<Args>(args)...);
+        return insert_unique(hint, mystl::move(v));
+    }
+    template <class... Args>
+    iterator emplace_equal(Args&&... args) {
+        value_type v(mystl::forward<Args>(args)...);
+        return insert_equal(mystl::move(v));
+    }
+
+    // 有序区间每个元素都追加在最右端, 叶子被填满, 总共 O(n)
+    template <class InputIterator>
+    void insert_range_unique(InputIterator first, InputIterator last) {
+        for (; first != last; ++first)
+            insert_unique(end(), *first);
+    }
+    template <class InputIterator>
+    void insert_range_equal(InputIterator first, InputIterator last) {
+        for (; first != last; ++first)
+            insert_equal(end(), *first);
+    }
+    template <class InputIterator>
+    void assign_unique(InputIterator first, InputIterator last) {
+        clear();
+        insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    void assign_equal(InputIterator first, InputIterator last) {
+        clear();
+        insert_range_equal(first, last);
+    }
+
+    // 返回被删元素的下一个位置
+    iterator erase(const_iterator position);
+    size_type erase(const key_type& k);
+    iterator erase(const_iterator first, const_iterator last);
+    void clear() {
+        if (root_ != nullptr) {
+            destroy_subtree(root_);
+            root_ = nullptr;
+            leftmost_ = nullptr;
+            rightmost_ = nullptr;
+            node_count_ = 0;
+        }
+    }
+
+public:
+    // set operations:
+    iterator find(const key_type& k) {
+        iterator j = lower_bound(k);
+        return (j == end() || key_compare_(k, KeyOfValue()(*j))) ? end() : j;
+    }
+    const_iterator find(const key_type& k) const {
+        return const_cast<btree*>(this)->find(k);
+    }
+    size_type count(const key_type& k) const {
+        mystl::pair<const_iterator, const_iterator> p = equal_range(k);
+        return static_cast<size_type>(mystl::distance(p.first, p.second));
+    }
+    iterator lower_bound(const key_type& k) {
+        return root_ ? normalize(descend(k, std::false_type())) : end();
+    }
+    const_iterator lower_bound(const key_type& k) const {
+        return const_cast<btree*>(this)->lower_bound(k);
+    }
+    iterator upper_bound(const key_type& k) {
+        return root_ ? normalize(descend(k, std::true_type())) : end();
+    }
+    const_iterator upper_bound(const key_type& k) const {
+        return const_cast<btree*>(this)->upper_bound(k);
+    }
+    mystl::pair<iterator, iterator> equal_range(const key_type& k) {
+        return mystl::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+        return mystl::pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+    }
+
+public:
+    // Debugging.
+    bool verify() const;
+
+private:
+    leaf_node* new_leaf() {
+        leaf_node* x = leaf_allocator(get_alloc()).allocate(1);
+        x->parent = nullptr;
+        x->position = 0;
+        x->count = 0;
+        x->leaf = true;
+        x->prev = nullptr;
+        x->next = nullptr;
+        return x;
+    }
+    internal_node* new_internal() {
+        internal_node* x = internal_allocator(get_alloc()).allocate(1);
+        x->parent = nullptr;
+        x->position = 0;
+        x->count = 0;
+        x->leaf = false;
+        return x;
+    }
+    void free_node(node_base* x) {
+        if (x->leaf)
+            leaf_allocator(get_alloc()).deallocate(static_cast<leaf_node*>(x), 1);
+        else
+            internal_allocator(get_alloc()).deallocate(static_cast<internal_node*>(x), 1);
+    }
+
+    static void set_child(internal_node* p, size_type i, node_base* child) {
+        p->children[i] = child;
+        child->parent = p;
+        child->position = static_cast<unsigned short>(i);
+    }
+
+    // Upper 为 false_type 时 x < k 的继续往右, 为 true_type 时 x <= k 的继续往右
+    bool go_right(const key_type& x, const key_type& k, std::false_type) const {
+        return key_compare_(x, k);
+    }
+    bool go_right(const key_type& x, const key_type& k, std::true_type) const {
+        return !key_compare_(k, x);
+    }
+
+    // 从根走到叶子, 返回 lower_bound/upper_bound 在叶子中的位置, 下标可能等于叶子的元素个数
+    template <class Upper>
+    iterator descend(const key_type& k, Upper upper) const {
+        node_base* x = root_;
+        while (!x->leaf) {
+            internal_node* in = static_cast<internal_node*>(x);
+            size_type lo = 0;
+            size_type hi = in->count;
+            while (lo < hi) {
+                const size_type mid = (lo + hi) / 2;
+                if (go_right(*in->key(mid), k, upper))
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            x = in->children[lo];
+        }
+        leaf_node* leaf = static_cast<leaf_node*>(x);
+        size_type lo = 0;
+        size_type hi = leaf->count;
+        while (lo < hi) {
+            const size_type mid = (lo + hi) / 2;
+            if (go_right(KeyOfValue()(*leaf->value(mid)), k, upper))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return iterator(leaf, static_cast<int>(lo));
+    }
+
+    static iterator normalize(iterator it) {
+        if (it.position == it.node->count && it.node->next != nullptr) {
+            it.node = it.node->next;
+            it.position = 0;
+        }
+        return it;
+    }
+
+    // hint 的前一个元素 < k < *hint (Upper 时为 <=) 且两者在同一叶子中, 或 hint 为 end() 且 k 在最大元素之后
+    template <class Upper>
+    bool hint_fits(const_iterator hint, const key_type& k, Upper upper) const {
+        if (root_ == nullptr || hint.position == 0)
+            return false;
+        if (!go_right(KeyOfValue()(*hint.node->value(hint.position - 1)), k, upper))
+            return false;
+        if (hint.node == rightmost_ && hint.position == rightmost_->count)
+            return true;
+        if (hint.position == hint.node->count)
+            return false;
+        const key_type& next = KeyOfValue()(*hint.node->value(hint.position));
+        return Upper::value ? !key_compare_(next, k) : key_compare_(k, next);
+    }
+
+    template <class V>
+    iterator insert_first(V&& v) {
+        leaf_node* leaf = new_leaf();
+        try {
+            mystl::construct(leaf->value(0), mystl::forward<V>(v));
+        } catch (...) {
+            free_node(leaf);
+            throw;
+        }
+        leaf->count = 1;
+        root_ = leaf;
+        leftmost_ = leaf;
+        rightmost_ = leaf;
+        node_count_ = 1;
+        return iterator(leaf, 0);
+    }
+
+    template <class V>
+    iterator insert_at(iterator pos, V&& v);
+    leaf_node* split_leaf(leaf_node*& leaf, size_type& i);
+    void unsplit_leaf(leaf_node* left, leaf_node* right);
+    void insert_into_parent(node_base* left, const key_type& sep, node_base* right);
+    void insert_into_internal(internal_node* p, size_type i, const key_type& sep, node_base* right);
+    void erase_from_internal(internal_node* p, size_type i);
+    void rebalance_leaf(leaf_node*& leaf, size_type& i);
+    void rebalance_internal(internal_node* x);
+    void merge_leaves(leaf_node* left, leaf_node* right);
+    void merge_internal(internal_node* left, internal_node* right);
+    void destroy_subtree(node_base* x);
+    bool verify_node(node_base* x, int depth, int& leaf_depth, size_type& n, leaf_node*& prev,
+                     const key_type* lo, const key_type* hi) const;
+
+    void copy_from(const btree& x) {
+        try {
+            for (const_iterator it = x.begin(); it != x.end(); ++it)
+                insert_equal(end(), *it);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+    void move_from(btree& x) {
+        try {
+            for (iterator it = x.begin(); it != x.end(); ++it)
+                insert_equal(end(), mystl::move(*it));
+        } catch (...) {
+            clear();
+            throw;
+        }
+        x.clear();
+    }
+
+    // 只交换数据, 分配器不变; 调用方保证两者分配器相等
+    void swap_data(btree& t) {
+        mystl::swap(root_, t.root_);
+        mystl::swap(leftmost_, t.leftmost_);
+        mystl::swap(rightmost_, t.rightmost_);
+        mystl::swap(node_count_, t.node_count_);
+        mystl::swap(key_compare_, t.key_compare_);
+    }
+};
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, std::size_t NodeSize>
+inline void swap(btree<Key, Value, KeyOfValue, Compare, Alloc, NodeSize>& x,
+                 btree<Key, Value, KeyOfValue, Compare, Alloc, NodeSize>& y) {
+    x.swap(y);
+}
+
+// 在叶子 pos 处插入, 叶子满了先分裂, 新分出的叶子的第一个键作为分隔键插到父结点
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+template <class V>
+typename btree<Key, Value, KoV, Compare, Alloc, NodeSize>::iterator
+btree<Key, Value, KoV, Compare, Alloc, NodeSize>::insert_at(iterator pos, V&& v) {
+    leaf_node* leaf = pos.node;
+    size_type i = static_cast<size_type>(pos.position);
+    leaf_node* right = leaf->count == leaf_slots ? split_leaf(leaf, i) : nullptr;
+
+    for (size_type j = leaf->count; j > i; --j)
+        btree_detail::transfer(leaf->value(j), leaf->value(j - 1));
+    try {
+        mystl::construct(leaf->value(i), mystl::forward<V>(v));
+    } catch (...) {
+        for (size_type j = i; j < leaf->count; ++j)
+            btree_detail::transfer(leaf->value(j), leaf->value(j + 1));
+        if (right != nullptr)
+            unsplit_leaf(right->prev, right);
+        throw;
+    }
+    ++leaf->count;
+    ++node_count_;
+    if (right != nullptr)
+        insert_into_parent(right->prev, KoV()(*right->value(0)), right);
+    return iterator(leaf, static_cast<int>(i));
+}
+
+// 满叶子对半分; 在最右叶子末尾追加时左边保持满, 新叶子只放新元素, 这样顺序插入时叶子都是满的.
+// leaf/i 改为新元素应插入的叶子和下标, 返回新叶子
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+typename btree<Key, Value, KoV, Compare, Alloc, NodeSize>::leaf_node*
+btree<Key, Value, KoV, Compare, Alloc, NodeSize>::split_leaf(leaf_node*& leaf, size_type& i) {
+    const size_type keep = leaf == rightmost_ && i == leaf_slots ? leaf_slots : leaf_slots / 2;
+    leaf_node* right = new_leaf();
+    for (size_type j = keep; j < leaf->count; ++j)
+        btree_detail::transfer(right->value(j - keep), leaf->value(j));
+    right->count = static_cast<unsigned short>(leaf->count - keep);
+    leaf->count = static_cast<unsigned short>(keep);
+
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != nullptr)
+        leaf->next->prev = right;
+    else
+        rightmost_ = right;
+    leaf->next = right;
+
+    if (i > keep || keep == leaf_slots) {
+        leaf = right;
+        i -= keep;
+    }
+    return right;
+}
+
+// 插入失败时撤销分裂
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::unsplit_leaf(leaf_node* left, leaf_node* right) {
+    for (size_type j = 0; j < right->count; ++j)
+        btree_detail::transfer(left->value(left->count + j), right->value(j));
+    left->count = static_cast<unsigned short>(left->count + right->count);
+    left->next = right->next;
+    if (right->next != nullptr)
+        right->next->prev = left;
+    else
+        rightmost_ = left;
+    free_node(right);
+}
+
+// 父结点满了就从中间分裂, 中间的键继续向上插入; 根分裂时树长高一层
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::insert_into_parent(node_base* left, const key_type& sep,
+                                                                           node_base* right) {
+    if (left->parent == nullptr) {
+        internal_node* root = new_internal();
+        mystl::construct(root->key(0), sep);
+        set_child(root, 0, left);
+        set_child(root, 1, right);
+        root->count = 1;
+        root_ = root;
+        return;
+    }
+    internal_node* p = static_cast<internal_node*>(left->parent);
+    const size_type i = left->position;
+    if (p->count < internal_slots) {
+        insert_into_internal(p, i, sep, right);
+        return;
+    }
+
+    const size_type mid = internal_slots / 2;
+    internal_node* q = new_internal();
+    for (size_type j = mid + 1; j < p->count; ++j)
+        btree_detail::transfer(q->key(j - mid - 1), p->key(j));
+    for (size_type j = mid + 1; j <= p->count; ++j)
+        set_child(q, j - mid - 1, p->children[j]);
+    q->count = static_cast<unsigned short>(p->count - mid - 1);
+    p->count = static_cast<unsigned short>(mid);
+    key_type median(mystl::move(*p->key(mid)));
+    mystl::destroy(p->key(mid));
+
+    if (i <= mid)
+        insert_into_internal(p, i, sep, right);
+    else
+        insert_into_internal(q, i - mid - 1, sep, right);
+    insert_into_parent(p, median, q);
+}
+
+// 分隔键放在下标 i, right 放在孩子 i + 1
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::insert_into_internal(internal_node* p, size_type i,
+                                                                             const key_type& sep, node_base* right) {
+    for (size_type j = p->count; j > i; --j) {
+        btree_detail::transfer(p->key(j), p->key(j - 1));
+        set_child(p, j + 1, p->children[j]);
+    }
+    mystl::construct(p->key(i), sep);
+    set_child(p, i + 1, right);
+    ++p->count;
+}
+
+// 去掉孩子 i + 1 和它左边的分隔键, 分隔键已经析构或移走
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::erase_from_internal(internal_node* p, size_type i) {
+    for (size_type j = i + 1; j < p->count; ++j) {
+        btree_detail::transfer(p->key(j - 1), p->key(j));
+        set_child(p, j, p->children[j + 1]);
+    }
+    --p->count;
+}
+
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+typename btree<Key, Value, KoV, Compare, Alloc, NodeSize>::iterator
+btree<Key, Value, KoV, Compare, Alloc, NodeSize>::erase(const_iterator position) {
+    leaf_node* leaf = position.node;
+    size_type i = static_cast<size_type>(position.position);
+    mystl::destroy(leaf->value(i));
+    for (size_type j = i + 1; j < leaf->count; ++j)
+        btree_detail::transfer(leaf->value(j - 1), leaf->value(j));
+    --leaf->count;
+    --node_count_;
+
+    if (leaf == root_) {
+        if (leaf->count == 0) {
+            free_node(leaf);
+            root_ = nullptr;
+            leftmost_ = nullptr;
+            rightmost_ = nullptr;
+            return end();
+        }
+    } else if (leaf->count < leaf_min) {
+        rebalance_leaf(leaf, i);
+    }
+    return normalize(iterator(leaf, static_cast<int>(i)));
+}
+
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+typename btree<Key, Value, KoV, Compare, Alloc, NodeSize>::size_type
+btree<Key, Value, KoV, Compare, Alloc, NodeSize>::erase(const key_type& k) {
+    mystl::pair<iterator, iterator> p = equal_range(k);
+    const size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
+    erase(p.first, p.second);
+    return n;
+}
+
+// 删除会搬动元素, last 随之失效, 所以先数出个数
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+typename btree<Key, Value, KoV, Compare, Alloc, NodeSize>::iterator
+btree<Key, Value, KoV, Compare, Alloc, NodeSize>::erase(const_iterator first, const_iterator last) {
+    if (first == begin() && last == end()) {
+        clear();
+        return end();
+    }
+    iterator it(first.node, first.position);
+    for (difference_type n = mystl::distance(first, last); n > 0; --n)
+        it = erase(it);
+    return it;
+}
+
+// 叶子元素不足: 兄弟有富余就借一个, 否则合并后父结点少一个分隔键. leaf/i 跟着被删元素的下一个元素走
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::rebalance_leaf(leaf_node*& leaf, size_type& i) {
+    internal_node* p = static_cast<internal_node*>(leaf->parent);
+    const size_type pos = leaf->position;
+    leaf_node* left = pos > 0 ? static_cast<leaf_node*>(p->children[pos - 1]) : nullptr;
+    leaf_node* right = pos < p->count ? static_cast<leaf_node*>(p->children[pos + 1]) : nullptr;
+
+    if (left != nullptr && left->count > leaf_min) {
+        for (size_type j = leaf->count; j > 0; --j)
+            btree_detail::transfer(leaf->value(j), leaf->value(j - 1));
+        btree_detail::transfer(leaf->value(0), left->value(left->count - 1));
+        --left->count;
+        ++leaf->count;
+        *p->key(pos - 1) = KoV()(*leaf->value(0));
+        ++i;
+    } else if (right != nullptr && right->count > leaf_min) {
+        btree_detail::transfer(leaf->value(leaf->count), right->value(0));
+        for (size_type j = 1; j < right->count; ++j)
+            btree_detail::transfer(right->value(j - 1), right->value(j));
+        --right->count;
+        ++leaf->count;
+        *p->key(pos) = KoV()(*right->value(0));
+    } else if (left != nullptr) {
+        i += left->count;
+        merge_leaves(left, leaf);
+        leaf = left;
+        rebalance_internal(p);
+    } else {
+        merge_leaves(leaf, right);
+        rebalance_internal(p);
+    }
+}
+
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::merge_leaves(leaf_node* left, leaf_node* right) {
+    internal_node* p = static_cast<internal_node*>(right->parent);
+    const size_type pos = right->position;
+    unsplit_leaf(left, right);
+    mystl::destroy(p->key(pos - 1));
+    erase_from_internal(p, pos - 1);
+}
+
+// 内部结点分隔键不足: 经父结点从兄弟转一个孩子过来, 或与兄弟合并后继续向上; 根只剩一个孩子时树变矮一层
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::rebalance_internal(internal_node* x) {
+    while (x != root_) {
+        if (x->count >= internal_min)
+            return;
+        internal_node* p = static_cast<internal_node*>(x->parent);
+        const size_type pos = x->position;
+        internal_node* left = pos > 0 ? static_cast<internal_node*>(p->children[pos - 1]) : nullptr;
+        internal_node* right = pos < p->count ? static_cast<internal_node*>(p->children[pos + 1]) : nullptr;
+
+        if (left != nullptr && left->count > internal_min) {
+            set_child(x, x->count + 1, x->children[x->count]);
+            for (size_type j = x->count; j > 0; --j) {
+                btree_detail::transfer(x->key(j), x->key(j - 1));
+                set_child(x, j, x->children[j - 1]);
+            }
+            btree_detail::transfer(x->key(0), p->key(pos - 1));
+            set_child(x, 0, left->children[left->count]);
+            btree_detail::transfer(p->key(pos - 1), left->key(left->count - 1));
+            --left->count;
+            ++x->count;
+            return;
+        }
+        if (right != nullptr && right->count > internal_min) {
+            btree_detail::transfer(x->key(x->count), p->key(pos));
+            set_child(x, x->count + 1, right->children[0]);
+            btree_detail::transfer(p->key(pos), right->key(0));
+            for (size_type j = 1; j < right->count; ++j) {
+                btree_detail::transfer(right->key(j - 1), right->key(j));
+                set_child(right, j - 1, right->children[j]);
+            }
+            set_child(right, right->count - 1, right->children[right->count]);
+            --right->count;
+            ++x->count;
+            return;
+        }
+        if (left != nullptr)
+            merge_internal(left, x);
+        else
+            merge_internal(x, right);
+        x = p;
+    }
+    if (x->count == 0) {
+        root_ = x->children[0];
+        root_->parent = nullptr;
+        root_->position = 0;
+        free_node(x);
+    }
+}
+
+// 父结点中的分隔键下移到两者之间
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::merge_internal(internal_node* left, internal_node* right) {
+    internal_node* p = static_cast<internal_node*>(right->parent);
+    const size_type pos = right->position;
+    const size_type base = left->count + 1;
+    btree_detail::transfer(left->key(left->count), p->key(pos - 1));
+    for (size_type j = 0; j < right->count; ++j)
+        btree_detail::transfer(left->key(base + j), right->key(j));
+    for (size_type j = 0; j <= right->count; ++j)
+        set_child(left, base + j, right->children[j]);
+    left->count = static_cast<unsigned short>(base + right->count);
+    free_node(right);
+    erase_from_internal(p, pos - 1);
+}
+
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+void btree<Key, Value, KoV, Compare, Alloc, NodeSize>::destroy_subtree(node_base* x) {
+    if (x->leaf) {
+        leaf_node* leaf = static_cast<leaf_node*>(x);
+        for (size_type j = 0; j < leaf->count; ++j)
+            mystl::destroy(leaf->value(j));
+    } else {
+        internal_node* in = static_cast<internal_node*>(x);
+        for (size_type j = 0; j <= in->count; ++j)
+            destroy_subtree(in->children[j]);
+        for (size_type j = 0; j < in->count; ++j)
+            mystl::destroy(in->key(j));
+    }
+    free_node(x);
+}
+
+// 检查: 叶子同深度且按顺序链接, 父子指针一致, 分隔键约束子树中的键, 元素个数与 size() 一致
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+bool btree<Key, Value, KoV, Compare, Alloc, NodeSize>::verify() const {
+    if (root_ == nullptr)
+        return node_count_ == 0 && leftmost_ == nullptr && rightmost_ == nullptr;
+    if (root_->parent != nullptr)
+        return false;
+    int leaf_depth = -1;
+    size_type n = 0;
+    leaf_node* prev = nullptr;
+    if (!verify_node(root_, 0, leaf_depth, n, prev, nullptr, nullptr))
+        return false;
+    return n == node_count_ && prev == rightmost_ && rightmost_->next == nullptr;
+}
+
+template <class Key, class Value, class KoV, class Compare, class Alloc, std::size_t NodeSize>
+bool btree<Key, Value, KoV, Compare, Alloc, NodeSize>::verify_node(node_base* x, int depth, int& leaf_depth,
+                                                                    size_type& n, leaf_node*& prev,
+                                                                    const key_type* lo, const key_type* hi) const {
+    if (x->leaf) {
+        leaf_node* leaf = static_cast<leaf_node*>(x);
+        if (leaf_depth < 0)
+            leaf_depth = depth;
+        if (leaf_depth != depth || leaf->count == 0 || leaf->count > leaf_slots || leaf->prev != prev)
+            return false;
+        if (prev != nullptr ? prev->next != leaf : leftmost_ != leaf)
+            return false;
+        for (size_type j = 0; j < leaf->count; ++j) {
+            const key_type& k = KoV()(*leaf->value(j));
+            if ((lo != nullptr && key_compare_(k, *lo)) || (hi != nullptr && key_compare_(*hi, k)))
+                return false;
+            if (j > 0 && key_compare_(k, KoV()(*leaf->value(j - 1))))
+                return false;
+        }
+        n += leaf->count;
+        prev = leaf;
+        return true;
+    }
+    internal_node* in = static_cast<internal_node*>(x);
+    if (in->count == 0 || in->count > internal_slots)
+        return false;
+    for (size_type j = 0; j <= in->count; ++j) {
+        node_base* child = in->children[j];
+        if (child->parent != in || child->position != j)
+            return false;
+        if (j > 0 && j < in->count && key_compare_(*in->key(j), *in->key(j - 1)))
+            return false;
+        const key_type* clo = j == 0 ? lo : in->key(j - 1);
+        const key_type* chi = j == in->count ? hi : in->key(j);
+        if (!verify_node(child, depth + 1, leaf_depth, n, prev, clo, chi))
+            return false;
+    }
+    return true;
+}
+
+} // namespace mystl
+
+#endif // MYSTL_BTREE_H_
@@ -0,0 +1,351 @@
+#ifndef MYSTL_FLAT_TREE_H_
+#define MYSTL_FLAT_TREE_H_
+
+#include <cstddef>
+#include "iterator.h"
+#include "allocator.h"
+#include "functional.h"
+#include "functexcept.h"
+#include "utility.h"
+#include "vector.h"
+#include "algorithm.h"
+#include "sort.h"
+
+namespace mystl {
+
+/*
+ * flat_tree: flat_set/flat_map 的底层实现, 元素按键严格递增存放在一个 mystl::vector 里
+ * - 查找是连续内存上的二分, 遍历是顺序扫描, 每个元素没有结点开销
+ * - 单个插入和删除要搬动后面的元素, O(n); 区间插入先把新元素追加到末尾排序去重,
+ *   再与原有元素原地归并, 一次插入 m 个元素为 O(m log m + n), 不逐个搬动
+ * - 插入和删除之后所有迭代器都失效
+ * 查找函数接受任意键类型 K, 是否对外开放异构查找由 flat_set/flat_map 决定
+ */
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+class flat_tree {
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using container_type = mystl::vector<Value, Alloc>;
+
+    using pointer = typename container_type::pointer;
+    using const_pointer = typename container_type::const_pointer;
+    using reference = typename container_type::reference;
+    using const_reference = typename container_type::const_reference;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+private:
+    // 二分查找用的比较: 元素在左 (lower_bound) 或在右 (upper_bound), 另一边是任意键
+    struct value_less_key {
+        const Compare& comp;
+        template <class K>
+        bool operator()(const Value& v, const K& k) const {
+            return comp(KeyOfValue()(v), k);
+        }
+    };
+    struct key_less_value {
+        const Compare& comp;
+        template <class K>
+        bool operator()(const K& k, const Value& v) const {
+            return comp(k, KeyOfValue()(v));
+        }
+    };
+    struct value_less_value {
+        const Compare& comp;
+        bool operator()(const Value& x, const Value& y) const {
+            return comp(KeyOfValue()(x), KeyOfValue()(y));
+        }
+    };
+
+public:
+    flat_tree() :
+        c_(), key_compare_() {
+    }
+    explicit flat_tree(const Compare& comp, const Alloc& alloc = Alloc()) :
+        c_(alloc), key_compare_(comp) {
+    }
+    explicit flat_tree(const Alloc& alloc) :
+        c_(alloc), key_compare_() {
+    }
+    // 接管 c 的存储, 不拷贝元素; c 无序时排序去重
+    flat_tree(container_type&& c, const Compare& comp) :
+        c_(mystl::move(c)), key_compare_(comp) {
+        sort_unique_tail(0);
+    }
+    // 接管 c 的存储, c 必须已按 comp 严格递增
+    flat_tree(sorted_unique_t, container_type&& c, const Compare& comp) :
+        c_(mystl::move(c)), key_compare_(comp) {
+        MYSTL_DEBUG(is_strictly_sorted());
+    }
+    flat_tree(const flat_tree& x) = default;
+    flat_tree(const flat_tree& x, const Alloc& alloc) :
+        c_(x.c_, alloc), key_compare_(x.key_compare_) {
+    }
+    flat_tree(flat_tree&& x) = default;
+    flat_tree(flat_tree&& x, const Alloc& alloc) :
+        c_(mystl::move(x.c_), alloc), key_compare_(x.key_compare_) {
+    }
+
+    flat_tree& operator=(const flat_tree& x) = default;
+    flat_tree& operator=(flat_tree&& x) = default;
+
+public:
+    // accessors:
+    Compare key_comp() const {
+        return key_compare_;
+    }
+    allocator_type get_allocator() const {
+        return c_.get_allocator();
+    }
+    iterator begin() noexcept {
+        return c_.begin();
+    }
+    const_iterator begin() const noexcept {
+        return c_.begin();
+    }
+    iterator end() noexcept {
+        return c_.end();
+    }
+    const_iterator end() const noexcept {
+        return c_.end();
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+    bool empty() const noexcept {
+        return c_.empty();
+    }
+    size_type size() const noexcept {
+        return c_.size();
+    }
+    size_type max_size() const noexcept {
+        return c_.max_size();
+    }
+    size_type capacity() const noexcept {
+        return c_.capacity();
+    }
+    void reserve(size_type n) {
+        c_.reserve(n);
+    }
+    void shrink_to_fit() {
+        c_.shrink_to_fit();
+    }
+
+    void swap(flat_tree& t) {
+        c_.swap(t.c_);
+        mystl::swap(key_compare_, t.key_compare_);
+    }
+
+    // 交出底层的有序数组, 之后自身为空
+    container_type extract() {
+        container_type c(mystl::move(c_));
+        c_.clear();
+        return c;
+    }
+    // 换上一个已按 comp 严格递增的数组, 不拷贝元素
+    void replace(container_type&& c) {
+        c_ = mystl::move(c);
+        MYSTL_DEBUG(is_strictly_sorted());
+    }
+
+public:
+    // insert/erase
+    template <class V>
+    mystl::pair<iterator, bool> insert_unique(V&& v) {
+        iterator pos = lower_bound(KeyOfValue()(v));
+        if (pos != end() && !key_compare_(KeyOfValue()(v), KeyOfValue()(*pos))) {
+            return mystl::pair<iterator, bool>(pos, false);
+        }
+        return mystl::pair<iterator, bool>(c_.insert(pos, mystl::forward<V>(v)), true);
+    }
+    // hint 恰好是插入位置时省去二分
+    template <class V>
+    iterator insert_unique(const_iterator hint, V&& v) {
+        const key_type& k = KeyOfValue()(v);
+        if ((hint == begin() || key_compare_(KeyOfValue()(*(hint - 1)), k)) &&
+            (hint == end() || key_compare_(k, KeyOfValue()(*hint)))) {
+            return c_.insert(hint, mystl::forward<V>(v));
+        }
+        return insert_unique(mystl::forward<V>(v)).first;
+    }
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace_unique(Args&&... args) {
+        value_type v(mystl::forward<Args>(args)...);
+        return insert_unique(mystl::move(v));
+    }
+    template <class... Args>
+    iterator emplace_hint_unique(const_iterator hint, Args&&... args) {
+        value_type v(mystl::forward<Args>(args)...);
+        return insert_unique(hint, mystl::move(v));
+    }
+
+    // 追加到末尾, 稳定排序后去重, 再与原有元素归并; 键相等时保留原有元素, 新元素中保留靠前的
+    template <class InputIterator>
+    void insert_range_unique(InputIterator first, InputIterator last) {
+        const size_type n = size();
+        c_.append(first, last);
+        sort_unique_tail(n);
+    }
+    // [first, last) 已按 comp 严格递增, 省去排序
+    template <class InputIterator>
+    void insert_range_unique(sorted_unique_t, InputIterator first, InputIterator last) {
+        const size_type n = size();
+        c_.append(first, last);
+        MYSTL_DEBUG(mystl::is_sorted(c_.begin() + n, c_.end(), value_less_value{key_compare_}));
+        merge_tail_unique(n);
+    }
+    template <class InputIterator>
+    void assign_unique(InputIterator first, InputIterator last) {
+        clear();
+        insert_range_unique(first, last);
+    }
+
+    iterator erase(const_iterator position) {
+        return c_.erase(const_cast<iterator>(position));
+    }
+    template <class K>
+    size_type erase(const K& k) {
+        mystl::pair<iterator, iterator> p = equal_range(k);
+        const size_type n = static_cast<size_type>(p.second - p.first);
+        c_.erase(p.first, p.second);
+        return n;
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        return c_.erase(const_cast<iterator>(first), const_cast<iterator>(last));
+    }
+    void clear() noexcept {
+        c_.clear();
+    }
+
+public:
+    // 查找, k 可以是任意能与键比较的类型
+    template <class K>
+    iterator find(const K& k) {
+        iterator pos = lower_bound(k);
+        return pos != end() && !key_compare_(k, KeyOfValue()(*pos)) ? pos : end();
+    }
+    template <class K>
+    const_iterator find(const K& k) const {
+        const_iterator pos = lower_bound(k);
+        return pos != end() && !key_compare_(k, KeyOfValue()(*pos)) ? pos : end();
+    }
+    template <class K>
+    size_type count(const K& k) const {
+        mystl::pair<const_iterator, const_iterator> p = equal_range(k);
+        return static_cast<size_type>(p.second - p.first);
+    }
+    template <class K>
+    iterator lower_bound(const K& k) {
+        return mystl::lower_bound(begin(), end(), k, value_less_key{key_compare_});
+    }
+    template <class K>
+    const_iterator lower_bound(const K& k) const {
+        return mystl::lower_bound(begin(), end(), k, value_less_key{key_compare_});
+    }
+    template <class K>
+    iterator upper_bound(const K& k) {
+        return mystl::upper_bound(begin(), end(), k, key_less_value{key_compare_});
+    }
+    template <class K>
+    const_iterator upper_bound(const K& k) const {
+        return mystl::upper_bound(begin(), end(), k, key_less_value{key_compare_});
+    }
+    // 键唯一时只需一次 lower_bound; 异构比较下可能有多个元素与 k 等价, 再在后面找上界
+    template <class K>
+    mystl::pair<iterator, iterator> equal_range(const K& k) {
+        iterator first = lower_bound(k);
+        return mystl::pair<iterator, iterator>(first, mystl::upper_bound(first, end(), k, key_less_value{key_compare_}));
+    }
+    template <class K>
+    mystl::pair<const_iterator, const_iterator> equal_range(const K& k) const {
+        const_iterator first = lower_bound(k);
+        return mystl::pair<const_iterator, const_iterator>(
+            first, mystl::upper_bound(first, end(), k, key_less_value{key_compare_}));
+    }
+
+    // Debugging.
+    bool is_strictly_sorted() const {
+        for (const_iterator it = begin(); it != end() && it + 1 != end(); ++it) {
+            if (!key_compare_(KeyOfValue()(*it), KeyOfValue()(*(it + 1)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // 就地去掉有序区间中的重复元素, 相等的只留第一个, 返回新的末尾
+    iterator unique_sorted(iterator first, iterator last) {
+        if (first == last) {
+            return last;
+        }
+        iterator result = first;
+        while (++first != last) {
+            if (key_compare_(KeyOfValue()(*result), KeyOfValue()(*first)) && ++result != first) {
+                *result = mystl::move(*first);
+            }
+        }
+        return ++result;
+    }
+
+    // [0, n) 有序, [n, size()) 为新追加的无序元素; 比较抛出异常时丢弃新元素, 原有元素不变
+    void sort_unique_tail(size_type n) {
+        try {
+            mystl::stable_sort(c_.begin() + n, c_.end(), value_less_value{key_compare_});
+            c_.erase(unique_sorted(c_.begin() + n, c_.end()), c_.end());
+        } catch (...) {
+            c_.erase(c_.begin() + n, c_.end());
+            throw;
+        }
+        merge_tail_unique(n);
+    }
+
+    // [0, n) 和 [n, size()) 各自严格递增, 归并后去掉与原有元素重复的新元素
+    // 归并中比较抛出异常时元素次序已乱, 清空容器
+    void merge_tail_unique(size_type n) {
+        if (n == 0 || n == size()) {
+            return;
+        }
+        const value_less_value comp{key_compare_};
+        // 新元素都大于原有元素时 (常见的按序追加) 不用归并
+        if (!comp(c_[n], c_[n - 1]) && comp(c_[n - 1], c_[n])) {
+            return;
+        }
+        try {
+            // 重复只可能出现在第一个新元素在原有元素中的位置之后
+            const size_type from = static_cast<size_type>(
+                mystl::lower_bound(c_.begin(), c_.begin() + n, KeyOfValue()(c_[n]), value_less_key{key_compare_}) -
+                c_.begin());
+            mystl::inplace_merge(c_.begin() + from, c_.begin() + n, c_.end(), comp);
+            c_.erase(unique_sorted(c_.begin() + from, c_.end()), c_.end());
+        } catch (...) {
+            c_.clear();
+            throw;
+        }
+    }
+
+private:
+    container_type c_;
+    Compare key_compare_;
+};
+
+} // namespace mystl
+
+#endif // MYSTL_FLAT_TREE_H_
@@ -4,25 +4,17 @@
 // Hashtable class, used to implement the hashed associative containers
 // hash_set, hash_map, hash_multiset, and hash_multimap.
 
+#include <cstddef>
+
 #include "vector.h"
 #include "iterator.h"
 #include "algorithm.h"
 #include "functional.h"
 #include "hash_fun.h"
+#include "utility.h"
 
 namespace mystl {
 
-using mystl::size_t;
-using mystl::ptrdiff_t;
-using mystl::forward_iterator_tag;
-using mystl::input_iterator_tag;
-using mystl::_Construct;
-using mystl::_Destroy;
-using mystl::distance;
-using mystl::vector;
-using mystl::mystl::pair;
-using mystl::iterator_category;
-
 template <class Val>
 struct Hashtable_node {
     Hashtable_node* next;
@@ -242,6 +234,7 @@ private:
     typedef typename Alloc::template rebind<Node>::other NodeAlloc;
     typedef typename Alloc::template rebind<Node*>::other NodeptrAlloc;
     typedef vector<Node*, NodeptrAlloc> Vector_type;
+    typedef allocator_traits<Node, NodeAlloc> alloc_traits;
 
     NodeAlloc node_allocator;
 
@@ -297,9 +290,9 @@ public:
     }
 
     hashtable(const hashtable& ht) :
-        node_allocator(ht.get_allocator()), hash(ht.hash),
+        node_allocator(alloc_traits::select_on_container_copy_construction(ht.node_allocator)), hash(ht.hash),
         equals(ht.equals), get_key(ht.get_key),
-        buckets(ht.get_allocator()), num_elements(0) {
+        buckets(NodeptrAlloc(node_allocator)), num_elements(0) {
         copy_from(ht);
     }
 
@@ -307,6 +300,8 @@ public:
     operator=(const hashtable& ht) {
         if (&ht != this) {
             clear();
+            // 节点已全部释放, 可以直接换用 ht 的分配器; 桶数组由 vector 自己管理
+            alloc_traits::copy_assign(node_allocator, ht.node_allocator);
             hash = ht.hash;
             equals = ht.equals;
             get_key = ht.get_key;
@@ -329,13 +324,15 @@ public:
         return size_type(-1);
     }
 
-    _GLIBCXX_NODISCARD bool
+    bool
     empty() const {
         return size() == 0;
     }
 
     void
     swap(hashtable& ht) {
+        MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || node_allocator == ht.node_allocator);
+        alloc_traits::swap(node_allocator, ht.node_allocator);
         mystl::swap(hash, ht.hash);
         mystl::swap(equals, ht.equals);
         mystl::swap(get_key, ht.get_key);
@@ -466,41 +463,65 @@ public:
 
     iterator
     find(const key_type& key) {
-        size_type n = bkt_num_key(key);
-        Node* first;
-        for (first = buckets[n];
-             first && !equals(get_key(first->val), key);
-             first = first->next) {}
-        return iterator(first, this);
+        return iterator(find_node(key), this);
     }
 
     const_iterator
     find(const key_type& key) const {
-        size_type n = bkt_num_key(key);
-        const Node* first;
-        for (first = buckets[n];
-             first && !equals(get_key(first->val), key);
-             first = first->next) {}
-        return const_iterator(first, this);
+        return const_iterator(find_node(key), this);
     }
 
     size_type
     count(const key_type& key) const {
-        const size_type n = bkt_num_key(key);
-        size_type result = 0;
+        return count_key(key);
+    }
 
-        for (const Node* cur = buckets[n]; cur;
-             cur = cur->next)
-            if (equals(get_key(cur->val), key))
-                ++result;
-        return result;
+    mystl::pair<iterator, iterator>
+    equal_range(const key_type& key) {
+        return equal_range_key(key);
+    }
+
+    mystl::pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const {
+        return equal_range_key(key);
+    }
+
+    // 异构查找: hasher 和 key_equal 都定义了 is_transparent 时, 直接用 K 计算哈希和比较, 不构造 key_type
+    // 两者必须对等价的 K 和 key_type 给出相同的哈希值
+    template <class K, class H = HashFcn, class E = EqualKey,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    iterator
+    find(const K& key) {
+        return iterator(find_node(key), this);
+    }
+
+    template <class K, class H = HashFcn, class E = EqualKey,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    const_iterator
+    find(const K& key) const {
+        return const_iterator(find_node(key), this);
+    }
+
+    template <class K, class H = HashFcn, class E = EqualKey,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    size_type
+    count(const K& key) const {
+        return count_key(key);
     }
 
+    template <class K, class H = HashFcn, class E = EqualKey,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
     mystl::pair<iterator, iterator>
-    equal_range(const key_type& key);
+    equal_range(const K& key) {
+        return equal_range_key(key);
+    }
 
+    template <class K, class H = HashFcn, class E = EqualKey,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
     mystl::pair<const_iterator, const_iterator>
-    equal_range(const key_type& key) const;
+    equal_range(const K& key) const {
+        return equal_range_key(key);
+    }
 
     size_type
     erase(const key_type& key);
@@ -535,7 +556,8 @@ private:
         num_elements = 0;
     }
 
-    size_type bkt_num_key(const key_type& key) const {
+    template <class K>
+    size_type bkt_num_key(const K& key) const {
         return bkt_num_key(key, buckets.size());
     }
 
@@ -543,10 +565,41 @@ private:
         return bkt_num_key(get_key(obj));
     }
 
-    size_type bkt_num_key(const key_type& key, size_t n) const {
+    template <class K>
+    size_type bkt_num_key(const K& key, size_t n) const {
         return hash(key) % n;
     }
 
+    template <class K>
+    Node* find_node(const K& key) const {
+        size_type n = bkt_num_key(key);
+        Node* first;
+        for (first = buckets[n];
+             first && !equals(get_key(first->val), key);
+             first = first->next) {}
+        return first;
+    }
+
+    template <class K>
+    size_type count_key(const K& key) const {
+        const size_type n = bkt_num_key(key);
+        size_type result = 0;
+
+        for (const Node* cur = buckets[n]; cur;
+             cur = cur->next)
+            if (equals(get_key(cur->val), key))
+                ++result;
+        return result;
+    }
+
+    template <class K>
+    mystl::pair<iterator, iterator>
+    equal_range_key(const K& key);
+
+    template <class K>
+    mystl::pair<const_iterator, const_iterator>
+    equal_range_key(const K& key) const;
+
     size_type bkt_num(const value_type& obj, size_t n) const {
         return bkt_num_key(get_key(obj), n);
     }
@@ -559,7 +612,7 @@ private:
             return n;
         } catch (...) {
             put_node(n);
-            throw_exception_again;
+            throw;
         }
     }
 
@@ -736,10 +789,11 @@ hashtable<Val, Key, HF, Ex, Eq, All>::
 }
 
 template <class Val, class Key, class HF, class Ex, class Eq, class All>
+template <class K>
 mystl::pair<typename hashtable<Val, Key, HF, Ex, Eq, All>::iterator,
             typename hashtable<Val, Key, HF, Ex, Eq, All>::iterator>
 hashtable<Val, Key, HF, Ex, Eq, All>::
-    equal_range(const key_type& key) {
+    equal_range_key(const K& key) {
     typedef mystl::pair<iterator, iterator> Pii;
     const size_type n = bkt_num_key(key);
 
@@ -760,10 +814,11 @@ hashtable<Val, Key, HF, Ex, Eq, All>::
 }
 
 template <class Val, class Key, class HF, class Ex, class Eq, class All>
+template <class K>
 mystl::pair<typename hashtable<Val, Key, HF, Ex, Eq, All>::const_iterator,
             typename hashtable<Val, Key, HF, Ex, Eq, All>::const_iterator>
 hashtable<Val, Key, HF, Ex, Eq, All>::
-    equal_range(const key_type& key) const {
+    equal_range_key(const K& key) const {
     typedef mystl::pair<const_iterator, const_iterator> Pii;
     const size_type n = bkt_num_key(key);
 
@@ -930,7 +985,7 @@ void hashtable<Val, Key, HF, Ex, Eq, All>::
                         tmp[bucket] = next;
                     }
                 }
-                throw_exception_again;
+                throw;
             }
         }
     }
@@ -1012,7 +1067,7 @@ void hashtable<Val, Key, HF, Ex, Eq, All>::
         num_elements = ht.num_elements;
     } catch (...) {
         clear();
-        throw_exception_again;
+        throw;
     }
 }
 
@@ -21,7 +21,7 @@ void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
     using DistanceType = typename iterator_traits<RandomAccessIterator>::difference_type;
 
     ValueType value = mystl::move(*(last - 1));
-    push_heap_aux(first, DistanceType((last - first) - 1), DistanceType(0), mystl::move(value), mystl::less<ValueType>());
+    mystl::push_heap_aux(first, DistanceType((last - first) - 1), DistanceType(0), mystl::move(value), mystl::less<ValueType>());
 }
 
 template <typename RandomAccessIterator, typename Compare>
@@ -30,7 +30,7 @@ void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare co
     using DistanceType = typename iterator_traits<RandomAccessIterator>::difference_type;
 
     ValueType value = mystl::move(*(last - 1));
-    push_heap_aux(first, DistanceType((last - first) - 1), DistanceType(0), mystl::move(value), comp);
+    mystl::push_heap_aux(first, DistanceType((last - first) - 1), DistanceType(0), mystl::move(value), comp);
 }
 
 template <typename RandomAccessIterator, typename Distance, typename T, typename Compare>
@@ -45,11 +45,13 @@ void adjust_heap(RandomAccessIterator first, Distance holeIndex, Distance len, T
         *(first + holeIndex) = mystl::move(*(first + secondChild));
         holeIndex = secondChild;
     }
-    if (secondChild == len) {
+    // 长度为偶数时最后一个父节点只有左孩子
+    if ((len & 1) == 0 && secondChild == (len - 2) / 2) {
+        secondChild = 2 * (secondChild + 1);
         *(first + holeIndex) = mystl::move(*(first + (secondChild - 1)));
         holeIndex = secondChild - 1;
     }
-    push_heap_aux(first, holeIndex, topIndex, mystl::move(value), comp);
+    mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value), comp);
 }
 
 template <typename RandomAccessIterator>
@@ -57,8 +59,10 @@ void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
     using ValueType = typename iterator_traits<RandomAccessIterator>::value_type;
     using DistanceType = typename iterator_traits<RandomAccessIterator>::difference_type;
     if (last - first > 1) {
+        // 堆顶放到末尾, 原来的末尾元素从堆顶开始下沉
         ValueType value = mystl::move(*(last - 1));
-        adjust_heap(first, DistanceType(0), DistanceType(last - first), mystl::move(value), mystl::less<ValueType>());
+        *(last - 1) = mystl::move(*first);
+        mystl::adjust_heap(first, DistanceType(0), DistanceType(last - first - 1), mystl::move(value), mystl::less<ValueType>());
     }
 }
 
@@ -67,22 +71,24 @@ void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare com
     using ValueType = typename iterator_traits<RandomAccessIterator>::value_type;
     using DistanceType = typename iterator_traits<RandomAccessIterator>::difference_type;
     if (last - first > 1) {
+        // 堆顶放到末尾, 原来的末尾元素从堆顶开始下沉
         ValueType value = mystl::move(*(last - 1));
-        adjust_heap(first, DistanceType(0), DistanceType(last - first), mystl::move(value), comp);
+        *(last - 1) = mystl::move(*first);
+        mystl::adjust_heap(first, DistanceType(0), DistanceType(last - first - 1), mystl::move(value), comp);
     }
 }
 
 template <typename RandomAccessIterator>
 void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
     while (last - first > 1) {
-        pop_heap(first, last--);
+        mystl::pop_heap(first, last--);
     }
 }
 
 template <typename RandomAccessIterator, typename Compare>
 void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
     while (last - first > 1) {
-        pop_heap(first, last--, comp);
+        mystl::pop_heap(first, last--, comp);
     }
 }
 
@@ -98,7 +104,7 @@ void make_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Compar
 
     while (true) {
         ValueType value = mystl::move(*(first + parent));
-        mystl::adjust_heap(first, parent, len, value, comp);
+        mystl::adjust_heap(first, parent, len, mystl::move(value), comp);
         if (parent == 0) {
             return;
         }
@@ -110,12 +116,12 @@ template <typename RandomAccessIterator>
 void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
     using ValueType = typename iterator_traits<RandomAccessIterator>::value_type;
 
-    make_heap_aux(first, last, mystl::less<ValueType>());
+    mystl::make_heap_aux(first, last, mystl::less<ValueType>());
 }
 
 template <typename RandomAccessIterator, typename Compare>
 void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-    make_heap_aux(first, last, comp);
+    mystl::make_heap_aux(first, last, comp);
 }
 } // namespace mystl
 
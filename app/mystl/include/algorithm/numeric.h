@@ -1,10 +1,16 @@
 #ifndef MYSTL_NUMERIC_H_
 #define MYSTL_NUMERIC_H_
 
+#include <type_traits>
+#include "utility.h"
+#include "iterator.h"
+#include "functional.h"
+#include "simd.h"
+
 namespace mystl {
 
 template <typename InputIterator, typename T>
-T accumulate(InputIterator first, InputIterator last, T init) {
+T __accumulate(InputIterator first, InputIterator last, T init, std::false_type) {
     while (first != last) {
         init = init + *first;
         ++first;
@@ -12,6 +18,17 @@ T accumulate(InputIterator first, InputIterator last, T init) {
     return init;
 }
 
+template <typename U, typename T>
+T __accumulate(U* first, U* last, T init, std::true_type) {
+    return simd::sum<T>(first, last, init);
+}
+
+// 连续区间上的 32/64 位整数求和使用 SIMD; 浮点数保持逐个相加的顺序, 结果不变
+template <typename InputIterator, typename T>
+T accumulate(InputIterator first, InputIterator last, T init) {
+    return mystl::__accumulate(first, last, init, simd::is_simd_sum_range<InputIterator, T>());
+}
+
 template <typename InputIterator, typename T, typename BinaryOperation>
 T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation binary_op) {
     while (first != last) {
@@ -117,6 +134,101 @@ T inner_product(InputIterator1 first1, InputIterator1 last1,
     return init;
 }
 
+/*
+ * reduce/transform_reduce/inclusive_scan/exclusive_scan
+ * 与 accumulate/inner_product/partial_sum 的区别是不规定运算的结合顺序, binary_op 需要满足结合律;
+ * 多线程版本见 parallel.h, 每个线程在自己的分块上调用这里的单线程版本
+ */
+template <typename InputIterator, typename T, typename BinaryOperation>
+T reduce(InputIterator first, InputIterator last, T init, BinaryOperation binary_op) {
+    while (first != last) {
+        init = binary_op(init, *first);
+        ++first;
+    }
+    return init;
+}
+
+// 求和时可以用 accumulate 的 SIMD 实现
+template <typename InputIterator, typename T>
+T reduce(InputIterator first, InputIterator last, T init, mystl::plus<T>) {
+    return mystl::accumulate(first, last, init);
+}
+
+template <typename InputIterator, typename T>
+T reduce(InputIterator first, InputIterator last, T init) {
+    return mystl::accumulate(first, last, init);
+}
+
+template <typename InputIterator>
+typename iterator_traits<InputIterator>::value_type reduce(InputIterator first, InputIterator last) {
+    return mystl::reduce(first, last, typename iterator_traits<InputIterator>::value_type());
+}
+
+template <typename InputIterator, typename T, typename BinaryOperation, typename UnaryOperation>
+T transform_reduce(InputIterator first, InputIterator last, T init,
+                   BinaryOperation reduce_op, UnaryOperation transform_op) {
+    while (first != last) {
+        init = reduce_op(init, transform_op(*first));
+        ++first;
+    }
+    return init;
+}
+
+template <typename InputIterator1, typename InputIterator2, typename T,
+          typename BinaryOperation1, typename BinaryOperation2>
+T transform_reduce(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, T init,
+                   BinaryOperation1 reduce_op, BinaryOperation2 transform_op) {
+    return mystl::inner_product(first1, last1, first2, init, reduce_op, transform_op);
+}
+
+template <typename InputIterator1, typename InputIterator2, typename T>
+T transform_reduce(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, T init) {
+    return mystl::inner_product(first1, last1, first2, init);
+}
+
+// 第 i 个输出为 init 与前 i + 1 个元素之和
+template <typename InputIterator, typename OutputIterator, typename BinaryOperation, typename T>
+OutputIterator inclusive_scan(InputIterator first, InputIterator last, OutputIterator result,
+                              BinaryOperation binary_op, T init) {
+    while (first != last) {
+        init = binary_op(init, *first);
+        *result = init;
+        ++first;
+        ++result;
+    }
+    return result;
+}
+
+template <typename InputIterator, typename OutputIterator, typename BinaryOperation>
+OutputIterator inclusive_scan(InputIterator first, InputIterator last, OutputIterator result,
+                              BinaryOperation binary_op) {
+    return mystl::partial_sum(first, last, result, binary_op);
+}
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator inclusive_scan(InputIterator first, InputIterator last, OutputIterator result) {
+    return mystl::partial_sum(first, last, result);
+}
+
+// 第 i 个输出为 init 与前 i 个元素之和, 不含第 i 个元素; 允许 result == first
+template <typename InputIterator, typename OutputIterator, typename T, typename BinaryOperation>
+OutputIterator exclusive_scan(InputIterator first, InputIterator last, OutputIterator result,
+                              T init, BinaryOperation binary_op) {
+    while (first != last) {
+        T next = binary_op(init, *first);
+        *result = init;
+        init = mystl::move(next);
+        ++first;
+        ++result;
+    }
+    return result;
+}
+
+template <typename InputIterator, typename OutputIterator, typename T>
+OutputIterator exclusive_scan(InputIterator first, InputIterator last, OutputIterator result, T init) {
+    return mystl::exclusive_scan(first, last, result, init, mystl::plus<T>());
+}
+
 } // namespace mystl
 
 #endif // MYSTL_NUMERIC_H_
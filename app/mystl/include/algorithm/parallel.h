@@ -0,0 +1,465 @@
+#ifndef MYSTL_PARALLEL_H_
+#define MYSTL_PARALLEL_H_
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include "utility.h"
+#include "iterator.h"
+#include "functional.h"
+#include "algorithm.h"
+#include "sort.h"
+#include "numeric.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+namespace mystl {
+
+/*
+ * 多线程算法, 只用 std::thread, 每次调用临时创建线程, 不维护线程池
+ * threads 为 0 时取 std::thread::hardware_concurrency(); 区间太小时退化为单线程版本
+ */
+namespace parallel_detail {
+
+// 每个线程至少分到这么多元素才值得开线程
+enum {
+    MIN_ELEMENTS_PER_THREAD = 1 << 14,
+    CACHELINE_SIZE = 64
+};
+
+// 每个线程的中间结果独占一条缓存行, 相邻线程写各自的结果时不会伪共享
+template <class T>
+struct alignas(CACHELINE_SIZE) padded {
+    T value;
+
+    explicit padded(const T& v) :
+        value(v) {
+    }
+};
+
+// 把 n 个元素等分成 parts 块时第 t 块的起点
+inline std::ptrdiff_t block_begin(std::ptrdiff_t n, std::size_t parts, std::size_t t) {
+    return n * static_cast<std::ptrdiff_t>(t) / static_cast<std::ptrdiff_t>(parts);
+}
+
+inline std::size_t resolve_threads(std::size_t threads, std::size_t n) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+    }
+    const std::size_t limit = n / MIN_ELEMENTS_PER_THREAD;
+    if (threads > limit) threads = limit;
+    return threads == 0 ? 1 : threads;
+}
+
+// 用 threads 个线程(含调用线程)执行 f(0) ... f(tasks - 1), 第 t 个线程执行下标 t, t + threads, ...
+// 任务中抛出的第一个异常在所有线程结束后重新抛出
+template <class Function>
+void run_tasks(std::size_t tasks, std::size_t threads, Function f) {
+    if (threads > tasks) threads = tasks;
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < tasks; ++i) {
+            f(i);
+        }
+        return;
+    }
+    mystl::vector<std::exception_ptr> errors(threads);
+    auto worker = [&](std::size_t t) {
+        try {
+            for (std::size_t i = t; i < tasks; i += threads) {
+                f(i);
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    mystl::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    try {
+        for (std::size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(worker, t);
+        }
+    } catch (...) {
+        // 线程创建失败: 等已经启动的线程结束, 剩下的任务由调用线程补上
+        for (std::size_t t = workers.size() + 1; t < threads; ++t) {
+            worker(t);
+        }
+    }
+    worker(0);
+    for (std::size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    for (std::size_t t = 0; t < threads; ++t) {
+        if (errors[t]) std::rethrow_exception(errors[t]);
+    }
+}
+
+// merge path: 归并 a[0, a_len) 和 b[0, b_len) 时, 输出的前 diag 个元素里有多少个来自 a
+// 相等时先取 a 的元素, 与 merge 的稳定性一致
+template <class Iterator1, class Iterator2, class Size, class Compare>
+Size merge_path_split(Iterator1 a, Size a_len, Iterator2 b, Size b_len, Size diag, Compare comp) {
+    Size lo = diag > b_len ? diag - b_len : 0;
+    Size hi = diag < a_len ? diag : a_len;
+    while (lo < hi) {
+        const Size mid = lo + (hi - lo) / 2;
+        if (comp(b[diag - mid - 1], a[mid])) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+OutputIterator move_merge(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                          OutputIterator result, Compare comp) {
+    while (first1 != last1 && first2 != last2) {
+        if (comp(*first2, *first1)) {
+            *result = mystl::move(*first2);
+            ++first2;
+        } else {
+            *result = mystl::move(*first1);
+            ++first1;
+        }
+        ++result;
+    }
+    result = mystl::move(first1, last1, result);
+    return mystl::move(first2, last2, result);
+}
+
+// 一轮归并: 相邻的两段有序区间合成一段, 写到 dest 的相同位置
+// 每对区间按输出长度切成若干片, 整轮共约 threads 片, 最后几轮只剩一两对时仍能用满所有线程
+template <class SrcIterator, class DestIterator, class Compare>
+void merge_round(SrcIterator src, DestIterator dest, const mystl::vector<std::ptrdiff_t>& bounds,
+                 mystl::vector<std::ptrdiff_t>& next_bounds, std::size_t threads, Compare comp) {
+    struct piece {
+        std::ptrdiff_t a_first, a_last, b_first, b_last, out;
+    };
+    const std::ptrdiff_t total = bounds.back();
+    mystl::vector<piece> pieces;
+    next_bounds.clear();
+    next_bounds.push_back(0);
+    for (std::size_t r = 0; r + 1 < bounds.size(); r += 2) {
+        const std::ptrdiff_t a_first = bounds[r];
+        const std::ptrdiff_t mid = bounds[r + 1];
+        const std::ptrdiff_t b_last = r + 2 < bounds.size() ? bounds[r + 2] : mid;
+        const std::ptrdiff_t a_len = mid - a_first;
+        const std::ptrdiff_t b_len = b_last - mid;
+        const std::ptrdiff_t len = a_len + b_len;
+        std::ptrdiff_t parts = static_cast<std::ptrdiff_t>(threads) * len / total;
+        if (parts < 1) parts = 1;
+        std::ptrdiff_t prev_i = 0;
+        std::ptrdiff_t prev_diag = 0;
+        for (std::ptrdiff_t p = 1; p <= parts; ++p) {
+            const std::ptrdiff_t diag = p == parts ? len : len / parts * p;
+            const std::ptrdiff_t i = p == parts ? a_len : merge_path_split(src + a_first, a_len, src + mid, b_len, diag, comp);
+            pieces.push_back(piece{a_first + prev_i, a_first + i, mid + (prev_diag - prev_i), mid + (diag - i),
+                                   a_first + prev_diag});
+            prev_i = i;
+            prev_diag = diag;
+        }
+        next_bounds.push_back(b_last);
+    }
+    run_tasks(pieces.size(), threads, [&](std::size_t k) {
+        const piece& p = pieces[k];
+        move_merge(src + p.a_first, src + p.a_last, src + p.b_first, src + p.b_last, dest + p.out, comp);
+    });
+}
+
+// 申请 n 个元素的缓冲区, 并把 [first, first + n) 移动构造进去, 析构时销毁
+// 构造之后数据在缓冲区里, [first, first + n) 只剩移动过的对象
+template <class T>
+class construct_buffer {
+public:
+    template <class RandomAccessIterator>
+    construct_buffer(RandomAccessIterator first, std::size_t n) :
+        buffer_(mystl::allocator<T>::allocate(n)), size_(n) {
+        try {
+            mystl::uninitialized_move(first, first + n, buffer_);
+        } catch (...) {
+            mystl::allocator<T>::deallocate(buffer_, size_);
+            throw;
+        }
+    }
+
+    ~construct_buffer() {
+        mystl::destroy(buffer_, buffer_ + size_);
+        mystl::allocator<T>::deallocate(buffer_, size_);
+    }
+
+    construct_buffer(const construct_buffer&) = delete;
+    construct_buffer& operator=(const construct_buffer&) = delete;
+
+    T* data() const noexcept {
+        return buffer_;
+    }
+
+private:
+    T* buffer_;
+    std::size_t size_;
+};
+
+} // namespace parallel_detail
+
+/*
+ * parallel_sort: 把区间切成 threads 段, 各线程用 mystl::sort 排好自己的一段,
+ * 再用 merge path 把归并拆给所有线程, 两两归并 log2(threads) 轮; 不稳定
+ * 需要与区间等长的临时缓冲区
+ */
+template <class RandomAccessIterator, class Compare>
+void parallel_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp, std::size_t threads = 0) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    const std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    threads = parallel_detail::resolve_threads(threads, static_cast<std::size_t>(n));
+    if (threads == 1) {
+        mystl::sort(first, last, comp);
+        return;
+    }
+
+    mystl::vector<std::ptrdiff_t> bounds;
+    for (std::size_t t = 0; t <= threads; ++t) {
+        bounds.push_back(static_cast<std::ptrdiff_t>(n * static_cast<std::ptrdiff_t>(t) / static_cast<std::ptrdiff_t>(threads)));
+    }
+    parallel_detail::run_tasks(threads, threads, [&](std::size_t t) {
+        mystl::sort(first + bounds[t], first + bounds[t + 1], comp);
+    });
+
+    // 元素已移进缓冲区, 第一轮从缓冲区归并回原区间
+    parallel_detail::construct_buffer<T> buffer(first, static_cast<std::size_t>(n));
+    mystl::vector<std::ptrdiff_t> next_bounds;
+    bool in_buffer = true;
+    while (bounds.size() > 2) {
+        if (in_buffer) {
+            parallel_detail::merge_round(buffer.data(), first, bounds, next_bounds, threads, comp);
+        } else {
+            parallel_detail::merge_round(first, buffer.data(), bounds, next_bounds, threads, comp);
+        }
+        bounds.swap(next_bounds);
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer) {
+        T* const data = buffer.data();
+        parallel_detail::run_tasks(threads, threads, [&](std::size_t t) {
+            const std::ptrdiff_t b = n * static_cast<std::ptrdiff_t>(t) / static_cast<std::ptrdiff_t>(threads);
+            const std::ptrdiff_t e = n * static_cast<std::ptrdiff_t>(t + 1) / static_cast<std::ptrdiff_t>(threads);
+            mystl::move(data + b, data + e, first + b);
+        });
+    }
+}
+
+template <class RandomAccessIterator>
+void parallel_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::parallel_sort(first, last, mystl::less<T>());
+}
+
+/*
+ * parallel_merge: 把有序的 [first1, last1) 与 [first2, last2) 归并到 result, 稳定;
+ * 输出按 merge path 等分给各线程, 每段独立归并
+ */
+template <class RandomAccessIterator1, class RandomAccessIterator2, class RandomAccessIterator3, class Compare>
+RandomAccessIterator3 parallel_merge(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+                                     RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                                     RandomAccessIterator3 result, Compare comp, std::size_t threads = 0) {
+    const std::ptrdiff_t len1 = last1 - first1;
+    const std::ptrdiff_t len2 = last2 - first2;
+    const std::ptrdiff_t n = len1 + len2;
+    threads = parallel_detail::resolve_threads(threads, static_cast<std::size_t>(n));
+    const std::ptrdiff_t parts = static_cast<std::ptrdiff_t>(threads);
+    parallel_detail::run_tasks(threads, threads, [&](std::size_t t) {
+        const std::ptrdiff_t d0 = n * static_cast<std::ptrdiff_t>(t) / parts;
+        const std::ptrdiff_t d1 = n * static_cast<std::ptrdiff_t>(t + 1) / parts;
+        const std::ptrdiff_t i0 = parallel_detail::merge_path_split(first1, len1, first2, len2, d0, comp);
+        const std::ptrdiff_t i1 = parallel_detail::merge_path_split(first1, len1, first2, len2, d1, comp);
+        RandomAccessIterator1 a = first1 + i0;
+        RandomAccessIterator1 a_last = first1 + i1;
+        RandomAccessIterator2 b = first2 + (d0 - i0);
+        RandomAccessIterator2 b_last = first2 + (d1 - i1);
+        RandomAccessIterator3 out = result + d0;
+        while (a != a_last && b != b_last) {
+            if (comp(*b, *a)) {
+                *out = *b;
+                ++b;
+            } else {
+                *out = *a;
+                ++a;
+            }
+            ++out;
+        }
+        out = mystl::copy(a, a_last, out);
+        mystl::copy(b, b_last, out);
+    });
+    return result + n;
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2, class RandomAccessIterator3>
+RandomAccessIterator3 parallel_merge(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+                                     RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                                     RandomAccessIterator3 result) {
+    using T = typename iterator_traits<RandomAccessIterator1>::value_type;
+    return mystl::parallel_merge(first1, last1, first2, last2, result, mystl::less<T>());
+}
+
+/*
+ * parallel_reduce/parallel_transform_reduce: 每个线程归约自己的一块, 结果写在独占缓存行的槽里,
+ * 最后由调用线程按块的顺序合并; binary_op 需要满足结合律, 不要求交换律
+ */
+namespace parallel_detail {
+
+// block_reduce(b, e) 归约一个非空的块
+template <class RandomAccessIterator, class T, class BinaryOperation, class BlockReduce>
+T reduce_blocks(RandomAccessIterator first, std::ptrdiff_t n, T init, BinaryOperation reduce_op, std::size_t threads,
+                BlockReduce block_reduce) {
+    mystl::vector<padded<T>> partials(threads, padded<T>(init));
+    run_tasks(threads, threads, [&](std::size_t t) {
+        partials[t].value = block_reduce(first + block_begin(n, threads, t), first + block_begin(n, threads, t + 1));
+    });
+    for (std::size_t t = 0; t < threads; ++t) {
+        init = reduce_op(init, partials[t].value);
+    }
+    return init;
+}
+
+} // namespace parallel_detail
+
+template <class RandomAccessIterator, class T, class BinaryOperation, class UnaryOperation>
+T parallel_transform_reduce(RandomAccessIterator first, RandomAccessIterator last, T init,
+                            BinaryOperation reduce_op, UnaryOperation transform_op, std::size_t threads = 0) {
+    const std::ptrdiff_t n = last - first;
+    threads = parallel_detail::resolve_threads(threads, static_cast<std::size_t>(n < 0 ? 0 : n));
+    if (threads == 1) {
+        return mystl::transform_reduce(first, last, init, reduce_op, transform_op);
+    }
+    // 每块以自己的第一个元素为初值
+    return parallel_detail::reduce_blocks(first, n, init, reduce_op, threads,
+                                          [&](RandomAccessIterator b, RandomAccessIterator e) {
+                                              T acc = transform_op(*b);
+                                              return mystl::transform_reduce(++b, e, mystl::move(acc), reduce_op,
+                                                                             transform_op);
+                                          });
+}
+
+template <class RandomAccessIterator, class T, class BinaryOperation>
+T parallel_reduce(RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation binary_op,
+                  std::size_t threads = 0) {
+    const std::ptrdiff_t n = last - first;
+    threads = parallel_detail::resolve_threads(threads, static_cast<std::size_t>(n < 0 ? 0 : n));
+    if (threads == 1) {
+        return mystl::reduce(first, last, init, binary_op);
+    }
+    return parallel_detail::reduce_blocks(first, n, init, binary_op, threads,
+                                          [&](RandomAccessIterator b, RandomAccessIterator e) {
+                                              T acc(*b);
+                                              return mystl::reduce(++b, e, mystl::move(acc), binary_op);
+                                          });
+}
+
+template <class RandomAccessIterator, class T>
+T parallel_reduce(RandomAccessIterator first, RandomAccessIterator last, T init) {
+    return mystl::parallel_reduce(first, last, init, mystl::plus<T>());
+}
+
+/*
+ * parallel_inclusive_scan/parallel_exclusive_scan: 分块两趟
+ * 1. 各线程求出除最后一块外每块的总和
+ * 2. 调用线程对块总和做前缀和, 得到每块的进位
+ * 3. 各线程带着进位扫描自己的块并写出结果
+ * 第 3 步每块只读写自己的区间, 允许 result == first
+ */
+namespace parallel_detail {
+
+template <class RandomAccessIterator, class OutputIterator, class BinaryOperation, class T>
+void scan_blocks(RandomAccessIterator first, std::ptrdiff_t n, OutputIterator result, BinaryOperation binary_op,
+                 const T* init, bool inclusive, std::size_t threads) {
+    // 第 1 步: 块总和, 以块的第一个元素为初值
+    mystl::vector<padded<T>> carries(threads, padded<T>(T(*first)));
+    run_tasks(threads - 1, threads, [&](std::size_t t) {
+        RandomAccessIterator b = first + block_begin(n, threads, t);
+        RandomAccessIterator e = first + block_begin(n, threads, t + 1);
+        T acc(*b);
+        carries[t].value = mystl::reduce(++b, e, mystl::move(acc), binary_op);
+    });
+    // 第 2 步: 块数很少, 进位由调用线程顺序求出: 块总和就地换成进位, 即第 t 块之前所有元素(和 init)的总和
+    // 没有 init 时第 0 块没有进位, 从第 1 块开始
+    T running = init != nullptr ? *init : carries[0].value;
+    for (std::size_t k = init != nullptr ? 0 : 1; k < threads; ++k) {
+        T sum = mystl::move(carries[k].value);
+        carries[k].value = running;
+        if (k + 1 < threads) running = binary_op(running, sum);
+    }
+    // 第 3 步
+    run_tasks(threads, threads, [&](std::size_t t) {
+        RandomAccessIterator b = first + block_begin(n, threads, t);
+        RandomAccessIterator e = first + block_begin(n, threads, t + 1);
+        OutputIterator out = result + block_begin(n, threads, t);
+        const bool has_carry = t > 0 || init != nullptr;
+        if (inclusive) {
+            if (has_carry) {
+                mystl::inclusive_scan(b, e, out, binary_op, carries[t].value);
+            } else {
+                mystl::inclusive_scan(b, e, out, binary_op);
+            }
+        } else {
+            mystl::exclusive_scan(b, e, out, carries[t].value, binary_op);
+        }
+    });
+}
+
+} // namespace parallel_detail
+
+template <class RandomAccessIterator, class OutputIterator, class BinaryOperation, class T>
+OutputIterator parallel_inclusive_scan(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                       BinaryOperation binary_op, T init, std::size_t threads = 0) {
+    const std::ptrdiff_t n = last - first;
+    threads = parallel_detail::resolve_threads(threads, static_cast<std::size_t>(n < 0 ? 0 : n));
+    if (threads == 1) {
+        return mystl::inclusive_scan(first, last, result, binary_op, init);
+    }
+    parallel_detail::scan_blocks(first, n, result, binary_op, &init, true, threads);
+    return result + n;
+}
+
+template <class RandomAccessIterator, class OutputIterator, class BinaryOperation>
+OutputIterator parallel_inclusive_scan(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                       BinaryOperation binary_op) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    const std::ptrdiff_t n = last - first;
+    const std::size_t threads = parallel_detail::resolve_threads(0, static_cast<std::size_t>(n < 0 ? 0 : n));
+    if (threads == 1) {
+        return mystl::inclusive_scan(first, last, result, binary_op);
+    }
+    parallel_detail::scan_blocks(first, n, result, binary_op, static_cast<const T*>(nullptr), true, threads);
+    return result + n;
+}
+
+template <class RandomAccessIterator, class OutputIterator>
+OutputIterator parallel_inclusive_scan(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    return mystl::parallel_inclusive_scan(first, last, result, mystl::plus<T>());
+}
+
+template <class RandomAccessIterator, class OutputIterator, class T, class BinaryOperation>
+OutputIterator parallel_exclusive_scan(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                       T init, BinaryOperation binary_op, std::size_t threads = 0) {
+    const std::ptrdiff_t n = last - first;
+    threads = parallel_detail::resolve_threads(threads, static_cast<std::size_t>(n < 0 ? 0 : n));
+    if (threads == 1) {
+        return mystl::exclusive_scan(first, last, result, init, binary_op);
+    }
+    parallel_detail::scan_blocks(first, n, result, binary_op, &init, false, threads);
+    return result + n;
+}
+
+template <class RandomAccessIterator, class OutputIterator, class T>
+OutputIterator parallel_exclusive_scan(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                       T init) {
+    return mystl::parallel_exclusive_scan(first, last, result, init, mystl::plus<T>());
+}
+
+} // namespace mystl
+
+#endif // MYSTL_PARALLEL_H_
@@ -0,0 +1,329 @@
+#ifndef MYSTL_RADIX_SORT_H_
+#define MYSTL_RADIX_SORT_H_
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "utility.h"
+#include "iterator.h"
+#include "functional.h"
+#include "algorithm.h"
+#include "sort.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace mystl {
+
+/*
+ * 基数排序, 不做比较, 都是稳定排序
+ * - radix_sort: LSD, 键为整数或 IEEE 浮点数, 每趟按一个字节分桶; 所有元素某个字节都相同时跳过这一趟
+ * - msd_radix_sort: MSD, 键为字节串(std::string 这类有 size()/operator[] 的类型或 const char*)
+ * 键由 key 函数对象从元素中取出, 默认 identity; 排序 pair 时可以用 select1st
+ * 需要与区间等长的临时缓冲区, 由 mystl::allocator 申请
+ */
+namespace radix_detail {
+
+enum {
+    RADIX_BITS = 8,
+    RADIX_SIZE = 1 << RADIX_BITS,
+    // 元素少时分桶的固定开销不划算, 改用插入排序
+    SMALL_SORT_THRESHOLD = 64
+};
+
+template <class Key, bool IsFloat = std::is_floating_point<Key>::value>
+struct key_traits;
+
+// 整数: 有符号数翻转符号位后按无符号数比较即可
+template <class Key>
+struct key_traits<Key, false> {
+    static_assert(std::is_integral<Key>::value, "radix_sort key must be an integral or floating-point type");
+    using unsigned_type = typename std::make_unsigned<Key>::type;
+
+    static unsigned_type to_unsigned(Key k) noexcept {
+        return std::is_signed<Key>::value
+                   ? static_cast<unsigned_type>(static_cast<unsigned_type>(k) ^ (unsigned_type(1) << (sizeof(Key) * CHAR_BIT - 1)))
+                   : static_cast<unsigned_type>(k);
+    }
+};
+
+template <std::size_t Size>
+struct unsigned_of_size;
+
+template <>
+struct unsigned_of_size<4> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct unsigned_of_size<8> {
+    using type = std::uint64_t;
+};
+
+// IEEE 浮点数: 正数翻转符号位, 负数翻转所有位; -0.0 排在 0.0 之前, NaN 按符号位排在两端
+template <class Key>
+struct key_traits<Key, true> {
+    static_assert(std::numeric_limits<Key>::is_iec559, "radix_sort requires IEEE floating-point keys");
+    using unsigned_type = typename unsigned_of_size<sizeof(Key)>::type;
+
+    static unsigned_type to_unsigned(Key k) noexcept {
+        unsigned_type u;
+        std::memcpy(&u, &k, sizeof(Key));
+        const unsigned_type sign = unsigned_type(1) << (sizeof(Key) * CHAR_BIT - 1);
+        return (u & sign) ? static_cast<unsigned_type>(~u) : static_cast<unsigned_type>(u | sign);
+    }
+};
+
+// 与区间等长的缓冲区; 平凡复制的类型直接当作已构造使用,
+// 其余类型把区间的元素移动构造进来, 之后区间里只剩被移走的对象, 由 holds_input 标明
+template <class T, bool Trivial = std::is_trivially_copyable<T>::value>
+class radix_buffer;
+
+template <class T>
+class radix_buffer<T, true> {
+public:
+    static constexpr bool holds_input = false;
+
+    template <class RandomAccessIterator>
+    radix_buffer(RandomAccessIterator, std::size_t n) :
+        buffer_(mystl::allocator<T>::allocate(n)), size_(n) {
+    }
+
+    ~radix_buffer() {
+        mystl::allocator<T>::deallocate(buffer_, size_);
+    }
+
+    radix_buffer(const radix_buffer&) = delete;
+    radix_buffer& operator=(const radix_buffer&) = delete;
+
+    T* data() const noexcept {
+        return buffer_;
+    }
+
+private:
+    T* buffer_;
+    std::size_t size_;
+};
+
+template <class T>
+class radix_buffer<T, false> {
+public:
+    static constexpr bool holds_input = true;
+
+    template <class RandomAccessIterator>
+    radix_buffer(RandomAccessIterator first, std::size_t n) :
+        buffer_(mystl::allocator<T>::allocate(n)), size_(n) {
+        try {
+            mystl::uninitialized_move(first, first + n, buffer_);
+        } catch (...) {
+            mystl::allocator<T>::deallocate(buffer_, size_);
+            throw;
+        }
+    }
+
+    ~radix_buffer() {
+        mystl::destroy(buffer_, buffer_ + size_);
+        mystl::allocator<T>::deallocate(buffer_, size_);
+    }
+
+    radix_buffer(const radix_buffer&) = delete;
+    radix_buffer& operator=(const radix_buffer&) = delete;
+
+    T* data() const noexcept {
+        return buffer_;
+    }
+
+private:
+    T* buffer_;
+    std::size_t size_;
+};
+
+template <class KeyOfValue, class Traits>
+struct key_less {
+    KeyOfValue key;
+    template <class T>
+    bool operator()(const T& a, const T& b) const {
+        return Traits::to_unsigned(key(a)) < Traits::to_unsigned(key(b));
+    }
+};
+
+// 按第 shift 位开始的字节把 src 分桶搬到 dest
+template <class SrcIterator, class DestIterator, class KeyOfValue, class Traits>
+void scatter(SrcIterator src, std::size_t n, DestIterator dest, const std::size_t* count, unsigned shift,
+             KeyOfValue& key, Traits) {
+    std::size_t offset[RADIX_SIZE];
+    std::size_t sum = 0;
+    for (std::size_t d = 0; d < RADIX_SIZE; ++d) {
+        offset[d] = sum;
+        sum += count[d];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t d = static_cast<std::size_t>((Traits::to_unsigned(key(src[i])) >> shift) & (RADIX_SIZE - 1));
+        dest[offset[d]++] = mystl::move(src[i]);
+    }
+}
+
+/*
+ * msd_radix_sort 用: 第 depth 个字节对应的桶, 0 表示字符串已经结束
+ */
+inline std::size_t byte_at(const char* s, std::size_t depth) noexcept {
+    return static_cast<unsigned char>(s[depth]) == 0 ? 0 : static_cast<std::size_t>(static_cast<unsigned char>(s[depth])) + 1;
+}
+
+inline std::size_t byte_at(char* s, std::size_t depth) noexcept {
+    return byte_at(static_cast<const char*>(s), depth);
+}
+
+template <class String>
+std::size_t byte_at(const String& s, std::size_t depth) {
+    return depth < static_cast<std::size_t>(s.size()) ? static_cast<std::size_t>(static_cast<unsigned char>(s[depth])) + 1 : 0;
+}
+
+// 前 depth 个字节已经相同, 从 depth 开始逐字节比较
+template <class KeyOfValue>
+struct suffix_less {
+    KeyOfValue key;
+    std::size_t depth;
+    template <class T>
+    bool operator()(const T& a, const T& b) const {
+        for (std::size_t d = depth;; ++d) {
+            const std::size_t x = byte_at(key(a), d);
+            const std::size_t y = byte_at(key(b), d);
+            if (x != y) return x < y;
+            if (x == 0) return false;
+        }
+    }
+};
+
+template <class RandomAccessIterator, class T, class KeyOfValue>
+void msd_sort(RandomAccessIterator first, std::size_t n, T* buffer, std::size_t depth, KeyOfValue& key) {
+    const std::size_t BUCKETS = RADIX_SIZE + 1;
+    while (n > 1) {
+        if (n < SMALL_SORT_THRESHOLD) {
+            sort_detail::insertion_sort(first, first + n, suffix_less<KeyOfValue>{key, depth});
+            return;
+        }
+        std::size_t count[BUCKETS] = {};
+        for (std::size_t i = 0; i < n; ++i) {
+            ++count[byte_at(key(first[i]), depth)];
+        }
+        // 所有元素在这个字节上都相同: 不用搬动, 直接看下一个字节
+        const std::size_t first_bucket = byte_at(key(first[0]), depth);
+        if (count[first_bucket] == n) {
+            if (first_bucket == 0) return;
+            ++depth;
+            continue;
+        }
+
+        std::size_t offset[BUCKETS];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            offset[b] = sum;
+            sum += count[b];
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t b = byte_at(key(first[i]), depth);
+            buffer[offset[b]++] = mystl::move(first[i]);
+        }
+        mystl::move(buffer, buffer + n, first);
+
+        // 已经结束的字符串(桶 0)不用再排; 最大的桶留给循环处理, 其余递归, 递归深度为 O(log n)
+        std::size_t largest = 1;
+        for (std::size_t b = 2; b < BUCKETS; ++b) {
+            if (count[b] > count[largest]) largest = b;
+        }
+        std::size_t begin = count[0];
+        std::size_t largest_begin = 0;
+        for (std::size_t b = 1; b < BUCKETS; ++b) {
+            if (b == largest) {
+                largest_begin = begin;
+            } else if (count[b] > 1) {
+                msd_sort(first + begin, count[b], buffer + begin, depth + 1, key);
+            }
+            begin += count[b];
+        }
+        first += largest_begin;
+        buffer += largest_begin;
+        n = count[largest];
+        ++depth;
+    }
+}
+
+} // namespace radix_detail
+
+template <class RandomAccessIterator, class KeyOfValue>
+void radix_sort(RandomAccessIterator first, RandomAccessIterator last, KeyOfValue key) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    using Key = typename std::decay<decltype(key(*first))>::type;
+    using Traits = radix_detail::key_traits<Key>;
+    using U = typename Traits::unsigned_type;
+    const unsigned PASSES = sizeof(U);
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < radix_detail::SMALL_SORT_THRESHOLD) {
+        sort_detail::insertion_sort(first, last, radix_detail::key_less<KeyOfValue, Traits>{key});
+        return;
+    }
+
+    // 一趟统计出所有字节的直方图
+    std::size_t count[PASSES][radix_detail::RADIX_SIZE] = {};
+    for (std::size_t i = 0; i < n; ++i) {
+        U u = Traits::to_unsigned(key(first[i]));
+        for (unsigned p = 0; p < PASSES; ++p) {
+            ++count[p][u & (radix_detail::RADIX_SIZE - 1)];
+            u = static_cast<U>(u >> radix_detail::RADIX_BITS);
+        }
+    }
+
+    const U first_key = Traits::to_unsigned(key(*first));
+    radix_detail::radix_buffer<T> buffer(first, n);
+    bool in_buffer = radix_detail::radix_buffer<T>::holds_input;
+    for (unsigned p = 0; p < PASSES; ++p) {
+        const unsigned shift = p * radix_detail::RADIX_BITS;
+        const std::size_t digit = static_cast<std::size_t>((first_key >> shift) & (radix_detail::RADIX_SIZE - 1));
+        if (count[p][digit] == n) continue;
+        if (in_buffer) {
+            radix_detail::scatter(buffer.data(), n, first, count[p], shift, key, Traits());
+        } else {
+            radix_detail::scatter(first, n, buffer.data(), count[p], shift, key, Traits());
+        }
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer) {
+        mystl::move(buffer.data(), buffer.data() + n, first);
+    }
+}
+
+template <class RandomAccessIterator>
+void radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::radix_sort(first, last, mystl::identity<T>());
+}
+
+template <class RandomAccessIterator, class KeyOfValue>
+void msd_radix_sort(RandomAccessIterator first, RandomAccessIterator last, KeyOfValue key) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < radix_detail::SMALL_SORT_THRESHOLD) {
+        sort_detail::insertion_sort(first, last, radix_detail::suffix_less<KeyOfValue>{key, 0});
+        return;
+    }
+    radix_detail::radix_buffer<T> buffer(first, n);
+    if (radix_detail::radix_buffer<T>::holds_input) {
+        mystl::move(buffer.data(), buffer.data() + n, first);
+    }
+    radix_detail::msd_sort(first, n, buffer.data(), 0, key);
+}
+
+template <class RandomAccessIterator>
+void msd_radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::msd_radix_sort(first, last, mystl::identity<T>());
+}
+
+} // namespace mystl
+
+#endif // MYSTL_RADIX_SORT_H_
@@ -1,6 +1,7 @@
 #ifndef MYSTL_RB_TREE_H_
 #define MYSTL_RB_TREE_H_
 
+#include <type_traits>
 #include "iterator.h"
 #include "algorithm.h"
 #include "allocator.h"
@@ -382,15 +383,21 @@ rb_tree_rebalance_for_erase(rb_tree_node_base* z,
     return y;
 }
 
+// 保存节点分配器实例, 无状态时借助空基类优化不占空间
 template <class Tp, class Alloc>
-struct rb_tree_base {
+struct rb_tree_base
+    : private allocator_holder<typename allocator_traits<rb_tree_node<Tp>, Alloc>::allocator_type> {
     typedef Alloc allocator_type;
     allocator_type get_allocator() const {
-        return allocator_type();
+        return allocator_type(get_alloc());
     }
 
-    rb_tree_base(const allocator_type&) :
-        header(0) {
+    rb_tree_base(const allocator_type& a) :
+        holder_type(Alloc_Type(a)), header(0) {
+        header = get_node();
+    }
+    rb_tree_base(Alloc&& a) :
+        holder_type(Alloc_Type(mystl::move(a))), header(0) {
         header = get_node();
     }
     ~rb_tree_base() {
@@ -398,19 +405,114 @@ struct rb_tree_base {
     }
 
 protected:
-    rb_tree_node<Tp>* header;
-
     typedef typename allocator_traits<rb_tree_node<Tp>, Alloc>::allocator_type Alloc_Type;
+    typedef allocator_holder<Alloc_Type> holder_type;
+    using holder_type::get_alloc;
+
+    rb_tree_node<Tp>* header;
 
     rb_tree_node<Tp>* get_node() {
-        return Alloc_Type::allocate(1);
+        return get_alloc().allocate(1);
     }
     void put_node(rb_tree_node<Tp>* p) {
-        Alloc_Type::deallocate(p, 1);
+        get_alloc().deallocate(p, 1);
     }
 };
 
-#endif /* STL_USE_mystl_ALLOCATORS */
+/*
+ * 结点句柄: 持有一个从 rb_tree 上摘下来的结点 (extract), 可以再插回同类型的树 (insert),
+ * 整个过程不释放也不重新申请结点; 句柄析构时若仍持有结点, 用原来的分配器释放
+ * key() 返回可修改的键, 摘下来改键再插回, 就地完成改键
+ */
+template <class Value, class KeyOfValue, class NodeAlloc>
+class rb_tree_node_handle : private allocator_holder<NodeAlloc> {
+    template <class, class, class, class, class>
+    friend class rb_tree;
+    typedef allocator_holder<NodeAlloc> holder_type;
+    typedef rb_tree_node<Value>* link_type;
+    using holder_type::get_alloc;
+
+public:
+    typedef Value value_type;
+    typedef typename std::remove_const<typename std::remove_reference<
+        decltype(KeyOfValue()(std::declval<Value&>()))>::type>::type key_type;
+
+    rb_tree_node_handle() noexcept :
+        holder_type(), node_(0) {
+    }
+    rb_tree_node_handle(rb_tree_node_handle&& x) noexcept :
+        holder_type(mystl::move(x.get_alloc())), node_(x.node_) {
+        x.node_ = 0;
+    }
+    rb_tree_node_handle& operator=(rb_tree_node_handle&& x) noexcept {
+        if (this != &x) {
+            reset();
+            get_alloc() = mystl::move(x.get_alloc());
+            node_ = x.node_;
+            x.node_ = 0;
+        }
+        return *this;
+    }
+    rb_tree_node_handle(const rb_tree_node_handle&) = delete;
+    rb_tree_node_handle& operator=(const rb_tree_node_handle&) = delete;
+    ~rb_tree_node_handle() {
+        reset();
+    }
+
+    bool empty() const noexcept {
+        return node_ == 0;
+    }
+    explicit operator bool() const noexcept {
+        return node_ != 0;
+    }
+
+    value_type& value() const {
+        return node_->value_field;
+    }
+    // map 的键是 const 的; 结点不在树上, 改键不会破坏有序性
+    key_type& key() const {
+        return const_cast<key_type&>(KeyOfValue()(node_->value_field));
+    }
+    template <class V = Value>
+    typename V::second_type& mapped() const {
+        return node_->value_field.second;
+    }
+
+    void swap(rb_tree_node_handle& x) noexcept {
+        mystl::swap(get_alloc(), x.get_alloc());
+        mystl::swap(node_, x.node_);
+    }
+
+private:
+    rb_tree_node_handle(link_type node, const NodeAlloc& alloc) :
+        holder_type(alloc), node_(node) {
+    }
+
+    link_type release() noexcept {
+        link_type node = node_;
+        node_ = 0;
+        return node;
+    }
+
+    void reset() noexcept {
+        if (node_ != 0) {
+            mystl::destroy(&node_->value_field);
+            get_alloc().deallocate(node_, 1);
+            node_ = 0;
+        }
+    }
+
+private:
+    link_type node_;
+};
+
+// 插入结点句柄的结果: 键已存在时 inserted 为 false, 结点原样留在 node 中
+template <class Iterator, class NodeType>
+struct rb_tree_insert_return {
+    Iterator position;
+    bool inserted;
+    NodeType node;
+};
 
 // rb_tree 数据结构
 template <class Key, class Value, class KeyOfValue, class Compare,
@@ -442,7 +544,10 @@ public:
 protected:
     using Base::get_node;
     using Base::put_node;
+    using Base::get_alloc;
     using Base::header; // header，实现上的技巧
+    typedef typename Base::Alloc_Type node_allocator;
+    typedef allocator_traits<rb_tree_node, node_allocator> alloc_traits;
 
 protected:
     // 创建一个节点
@@ -452,6 +557,7 @@ protected:
             construct(&tmp->value_field, x); // 构造内容
         } catch (...) {
             put_node(tmp);
+            throw;
         }
         return tmp;
     }
@@ -542,11 +648,30 @@ public:
     typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
     typedef mystl::reverse_iterator<iterator> reverse_iterator;
 
+    typedef rb_tree_node_handle<value_type, KeyOfValue, node_allocator> node_type;
+    typedef rb_tree_insert_return<iterator, node_type> insert_return_type;
+
 private:
     iterator insert(base_ptr x, base_ptr y, const value_type& v);
+    iterator link_node(base_ptr x, base_ptr y, link_type z);
+    mystl::pair<base_ptr, base_ptr> get_insert_unique_pos(const key_type& k);
+    link_type unlink_node(base_ptr z);
     link_type copy(link_type x, link_type p);
     void erase(link_type x);
 
+    template <class InputIterator>
+    link_type build_sorted(InputIterator& first, size_type n, int depth, int max_depth);
+    template <class InputIterator>
+    void assign_sorted(InputIterator first, size_type n);
+    template <class InputIterator>
+    void insert_range_unique(InputIterator first, InputIterator last, mystl::input_iterator_tag);
+    template <class ForwardIterator>
+    void insert_range_unique(ForwardIterator first, ForwardIterator last, mystl::forward_iterator_tag);
+    template <class InputIterator>
+    void insert_range_equal(InputIterator first, InputIterator last, mystl::input_iterator_tag);
+    template <class ForwardIterator>
+    void insert_range_equal(ForwardIterator first, ForwardIterator last, mystl::forward_iterator_tag);
+
 public:
     // allocation/deallocation
     rb_tree() :
@@ -563,10 +688,51 @@ public:
         Base(a), node_count(0), key_compare(comp) {
         empty_initialize();
     }
+
+    explicit rb_tree(const allocator_type& a) :
+        Base(a), node_count(0), key_compare() {
+        empty_initialize();
+    }
     // 初始化
     rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) :
-        Base(x.get_allocator()),
+        Base(allocator_type(alloc_traits::select_on_container_copy_construction(x.get_alloc()))),
         node_count(0), key_compare(x.key_compare) {
+        copy_initialize(x);
+    }
+
+    rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x, const allocator_type& a) :
+        Base(a), node_count(0), key_compare(x.key_compare) {
+        copy_initialize(x);
+    }
+
+    // x 换上新申请的 header, 仍然可用
+    rb_tree(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&& x) :
+        Base(x.get_allocator()), node_count(0), key_compare(x.key_compare) {
+        empty_initialize();
+        swap_data(x);
+    }
+
+    rb_tree(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&& x, const allocator_type& a) :
+        Base(a), node_count(0), key_compare(x.key_compare) {
+        if (get_alloc() == x.get_alloc()) {
+            empty_initialize();
+            swap_data(x);
+        } else {
+            copy_initialize(x);
+            x.clear();
+        }
+    }
+
+    ~rb_tree() {
+        clear();
+    }
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
+    operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x);
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
+    operator=(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&& x);
+
+private:
+    void copy_initialize(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
         if (x.root() == 0)
             empty_initialize();
         else {
@@ -577,13 +743,25 @@ public:
         }
         node_count = x.node_count;
     }
-    ~rb_tree() {
+
+    // 只交换数据, 分配器不变; 调用方保证两者分配器相等
+    void swap_data(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t) {
+        mystl::swap(header, t.header);
+        mystl::swap(node_count, t.node_count);
+        mystl::swap(key_compare, t.key_compare);
+    }
+
+    // 换用 from 的分配器前, 先用旧分配器释放 header, 再用新分配器申请
+    template <class Assign>
+    void replace_allocator(Assign assign) {
         clear();
+        put_node(header);
+        header = 0;
+        assign();
+        header = get_node();
+        empty_initialize();
     }
-    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
-    operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x);
 
-private:
     void empty_initialize() {
         color(header) = rb_tree_red; // used to distinguish header from
                                      // root, in iterator.operator++
@@ -631,10 +809,11 @@ public:
         return size_type(-1);
     }
 
+    // 分配器不传播时, 两棵树的分配器必须相等
     void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t) {
-        mystl::swap(header, t.header);
-        mystl::swap(node_count, t.node_count);
-        mystl::swap(key_compare, t.key_compare);
+        MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || get_alloc() == t.get_alloc());
+        alloc_traits::swap(get_alloc(), t.get_alloc());
+        swap_data(t);
     }
 
 public:
@@ -645,14 +824,49 @@ public:
     iterator insert_unique(iterator position, const value_type& x); // 将 x 插入到 RB-tree 唯一
     iterator insert_equal(iterator position, const value_type& x);  // 将 x 插入到 RB-tree，允许重复
 
+    // 空树上插入有序区间时线性建树, 否则逐个以 end() 为提示插入
     template <class InputIterator>
-    void insert_range_unique(InputIterator first, InputIterator last);
+    void insert_range_unique(InputIterator first, InputIterator last) {
+        insert_range_unique(first, last, typename iterator_traits<InputIterator>::iterator_category());
+    }
     template <class InputIterator>
-    void insert_range_equal(InputIterator first, InputIterator last);
+    void insert_range_equal(InputIterator first, InputIterator last) {
+        insert_range_equal(first, last, typename iterator_traits<InputIterator>::iterator_category());
+    }
+    // 调用方保证区间有序, 空树上省去检查
+    template <class InputIterator>
+    void insert_range_unique(sorted_unique_t, InputIterator first, InputIterator last);
+    template <class InputIterator>
+    void insert_range_equal(sorted_equivalent_t, InputIterator first, InputIterator last);
+
+    template <class InputIterator>
+    void assign_unique(InputIterator first, InputIterator last) {
+        clear();
+        insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    void assign_equal(InputIterator first, InputIterator last) {
+        clear();
+        insert_range_equal(first, last);
+    }
 
-    void erase(iterator position);
+    // 结点句柄: 摘下和挂上结点只调整指针, 不申请也不释放内存
+    node_type extract(const_iterator position) {
+        return node_type(unlink_node(position.node), get_alloc());
+    }
+    node_type extract(const key_type& k) {
+        iterator position = find(k);
+        return position == end() ? node_type() : extract(position);
+    }
+    insert_return_type insert_unique(node_type&& nh);
+    iterator insert_equal(node_type&& nh);
+    // 把 source 中的结点逐个挂到本树; 键已存在的结点留在 source 中. 两棵树的分配器必须相等
+    void merge_unique(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& source);
+    void merge_equal(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& source);
+
+    iterator erase(const_iterator position);
     size_type erase(const key_type& x);
-    void erase(iterator first, iterator last);
+    iterator erase(const_iterator first, const_iterator last);
     void erase(const key_type* first, const key_type* last);
     void clear() {
         if (node_count != 0) {
@@ -666,15 +880,25 @@ public:
 
 public:
     // set operations:
-    iterator find(const key_type& x);
-    const_iterator find(const key_type& x) const;
-    size_type count(const key_type& x) const;
-    iterator lower_bound(const key_type& x);
-    const_iterator lower_bound(const key_type& x) const;
-    iterator upper_bound(const key_type& x);
-    const_iterator upper_bound(const key_type& x) const;
-    mystl::pair<iterator, iterator> equal_range(const key_type& x);
-    mystl::pair<const_iterator, const_iterator> equal_range(const key_type& x) const;
+    // x 可以是任意能用 key_compare 与键比较的类型, 是否对外开放异构查找由 set/map 决定
+    template <class K>
+    iterator find(const K& x);
+    template <class K>
+    const_iterator find(const K& x) const;
+    template <class K>
+    size_type count(const K& x) const;
+    template <class K>
+    iterator lower_bound(const K& x);
+    template <class K>
+    const_iterator lower_bound(const K& x) const;
+    template <class K>
+    iterator upper_bound(const K& x);
+    template <class K>
+    const_iterator upper_bound(const K& x) const;
+    template <class K>
+    mystl::pair<iterator, iterator> equal_range(const K& x);
+    template <class K>
+    mystl::pair<const_iterator, const_iterator> equal_range(const K& x) const;
 
 public:
     // Debugging.
@@ -745,6 +969,9 @@ template <class Key, class Value, class KeyOfValue,
 rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
 rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
     if (this != &x) {
+        if (alloc_traits::propagate_on_container_copy_assignment::value && get_alloc() != x.get_alloc()) {
+            replace_allocator([this, &x]() { alloc_traits::copy_assign(get_alloc(), x.get_alloc()); });
+        }
         // Note that Key may be a constant type.
         clear();
         node_count = 0;
@@ -763,17 +990,44 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::operator=(const rb_tree<Key, Va
     return *this;
 }
 
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::operator=(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&& x) {
+    if (this == &x) {
+        return *this;
+    }
+    if (get_alloc() == x.get_alloc()) {
+        clear();
+        swap_data(x);
+    } else if (alloc_traits::propagate_on_container_move_assignment::value) {
+        replace_allocator([this, &x]() { alloc_traits::move_assign(get_alloc(), x.get_alloc()); });
+        swap_data(x);
+    } else {
+        // 分配器不同且不传播, 只能逐个复制节点
+        *this = static_cast<const rb_tree&>(x);
+        x.clear();
+    }
+    return *this;
+}
+
 // RB-tree 元素插入操作，KeyOfValue 为仿函数
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
 rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert(base_ptr x_, base_ptr y_, const Value& v) {
+    return link_node(x_, y_, create_node(v));
+}
+
+// 把已构造好的结点 z 挂到 y 下面, x 非空时挂在左边, 然后调整平衡
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_node(base_ptr x_, base_ptr y_, link_type z) {
     link_type x = (link_type)x_;
     link_type y = (link_type)y_;
-    link_type z;
 
-    if (y == header || x != 0 || key_compare(KeyOfValue()(v), key(y))) {
-        z = create_node(v);
+    if (y == header || x != 0 || key_compare(key(z), key(y))) {
         left(y) = z; // also makes leftmost() = z
                      //    when y == header
         if (y == header) {
@@ -782,7 +1036,6 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert(base_ptr x_, base_ptr y_
         } else if (y == leftmost())
             leftmost() = z; // maintain leftmost() pointing to min node
     } else {
-        z = create_node(v);
         right(y) = z;
         if (y == rightmost())
             rightmost() = z; // maintain rightmost() pointing to max node
@@ -816,23 +1069,10 @@ template <class Key, class Value, class KeyOfValue,
 mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator,
             bool>
 rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const Value& v) {
-    link_type y = header;
-    link_type x = root();
-    bool comp = true;
-    while (x != 0) {
-        y = x;
-        comp = key_compare(KeyOfValue()(v), key(x));
-        x = comp ? left(x) : right(x);
-    }
-    iterator j = iterator(y);
-    if (comp)
-        if (j == begin())
-            return mystl::pair<iterator, bool>(insert(x, y, v), true);
-        else
-            --j;
-    if (key_compare(key(j.node), KeyOfValue()(v)))
-        return mystl::pair<iterator, bool>(insert(x, y, v), true);
-    return mystl::pair<iterator, bool>(j, false);
+    mystl::pair<base_ptr, base_ptr> pos = get_insert_unique_pos(KeyOfValue()(v));
+    if (pos.second == 0)
+        return mystl::pair<iterator, bool>(iterator((link_type)pos.first), false);
+    return mystl::pair<iterator, bool>(insert(pos.first, pos.second, v), true);
 }
 
 template <class Key, class Val, class KeyOfValue,
@@ -895,30 +1135,256 @@ rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::insert_equal(iterator position, c
     }
 }
 
+// 按中序从 first 依次取 n 个值建出子树, 每个节点左右子树的大小至多差 1, 所以除最深一层外各层都是满的;
+// 最深一层 (max_depth) 染红, 其余染黑, 从根到任一空链接经过的黑节点数都是 max_depth
+template <class Key, class Val, class KoV, class Cmp, class Alloc>
+template <class InputIterator>
+typename rb_tree<Key, Val, KoV, Cmp, Alloc>::link_type
+rb_tree<Key, Val, KoV, Cmp, Alloc>::build_sorted(InputIterator& first, size_type n, int depth, int max_depth) {
+    if (n == 0)
+        return 0;
+    const size_type left_n = (n - 1) / 2;
+    link_type l = build_sorted(first, left_n, depth + 1, max_depth);
+    link_type x;
+    try {
+        x = create_node(*first);
+    } catch (...) {
+        erase(l);
+        throw;
+    }
+    ++first;
+    color(x) = depth == max_depth && depth != 0 ? rb_tree_red : rb_tree_black;
+    left(x) = l;
+    right(x) = 0;
+    if (l) parent(l) = x;
+    try {
+        right(x) = build_sorted(first, n - 1 - left_n, depth + 1, max_depth);
+    } catch (...) {
+        erase(x);
+        throw;
+    }
+    if (right(x)) parent(right(x)) = x;
+    return x;
+}
+
+// 空树上从 n 个有序值建树, 节点按键的顺序连续申请, O(n)
 template <class Key, class Val, class KoV, class Cmp, class Alloc>
 template <class InputIterator>
-void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_equal(InputIterator first, InputIterator last) {
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::assign_sorted(InputIterator first, size_type n) {
+    if (n == 0)
+        return;
+    int max_depth = 0;
+    for (size_type m = n; m > 1; m >>= 1)
+        ++max_depth;
+    root() = build_sorted(first, n, 0, max_depth);
+    parent(root()) = header;
+    leftmost() = minimum(root());
+    rightmost() = maximum(root());
+    node_count = n;
+}
+
+// 有序输入每次都落在最右端, 以 end() 为提示省去查找, 重新平衡均摊 O(1)
+template <class Key, class Val, class KoV, class Cmp, class Alloc>
+template <class InputIterator>
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_equal(InputIterator first, InputIterator last,
+                                                             mystl::input_iterator_tag) {
     for (; first != last; ++first)
-        insert_equal(*first);
+        insert_equal(end(), *first);
+}
+
+template <class Key, class Val, class KoV, class Cmp, class Alloc>
+template <class ForwardIterator>
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_equal(ForwardIterator first, ForwardIterator last,
+                                                             mystl::forward_iterator_tag) {
+    if (node_count == 0) {
+        size_type n = 0;
+        bool sorted = true;
+        ForwardIterator prev = first;
+        for (ForwardIterator it = first; it != last && sorted; prev = it, ++it, ++n) {
+            sorted = n == 0 || !key_compare(KoV()(*it), KoV()(*prev));
+        }
+        if (sorted) {
+            assign_sorted(first, n);
+            return;
+        }
+    }
+    insert_range_equal(first, last, mystl::input_iterator_tag());
 }
 
 template <class Key, class Val, class KoV, class Cmp, class Alloc>
 template <class InputIterator>
-void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_unique(InputIterator first, InputIterator last) {
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_unique(InputIterator first, InputIterator last,
+                                                              mystl::input_iterator_tag) {
     for (; first != last; ++first)
-        insert_unique(*first);
+        insert_unique(end(), *first);
+}
+
+template <class Key, class Val, class KoV, class Cmp, class Alloc>
+template <class ForwardIterator>
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_unique(ForwardIterator first, ForwardIterator last,
+                                                              mystl::forward_iterator_tag) {
+    if (node_count == 0) {
+        size_type n = 0;
+        bool sorted = true;
+        ForwardIterator prev = first;
+        for (ForwardIterator it = first; it != last && sorted; prev = it, ++it, ++n) {
+            sorted = n == 0 || key_compare(KoV()(*prev), KoV()(*it));
+        }
+        if (sorted) {
+            assign_sorted(first, n);
+            return;
+        }
+    }
+    insert_range_unique(first, last, mystl::input_iterator_tag());
+}
+
+template <class Key, class Val, class KoV, class Cmp, class Alloc>
+template <class InputIterator>
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_unique(sorted_unique_t, InputIterator first,
+                                                              InputIterator last) {
+    using category = typename iterator_traits<InputIterator>::iterator_category;
+    if (node_count == 0 && std::is_base_of<mystl::forward_iterator_tag, category>::value)
+        assign_sorted(first, static_cast<size_type>(mystl::distance(first, last)));
+    else
+        insert_range_unique(first, last, mystl::input_iterator_tag());
+}
+
+template <class Key, class Val, class KoV, class Cmp, class Alloc>
+template <class InputIterator>
+void rb_tree<Key, Val, KoV, Cmp, Alloc>::insert_range_equal(sorted_equivalent_t, InputIterator first,
+                                                             InputIterator last) {
+    using category = typename iterator_traits<InputIterator>::iterator_category;
+    if (node_count == 0 && std::is_base_of<mystl::forward_iterator_tag, category>::value)
+        assign_sorted(first, static_cast<size_type>(mystl::distance(first, last)));
+    else
+        insert_range_equal(first, last, mystl::input_iterator_tag());
+}
+
+// 找键 k 的插入位置: 返回 (x, y) 供 link_node 使用; 键已存在时 y 为空, x 为已有结点
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+mystl::pair<rb_tree_node_base*, rb_tree_node_base*>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::get_insert_unique_pos(const Key& k) {
+    link_type y = header;
+    link_type x = root();
+    bool comp = true;
+    while (x != 0) {
+        y = x;
+        comp = key_compare(k, key(x));
+        x = comp ? left(x) : right(x);
+    }
+    iterator j = iterator(y);
+    if (comp) {
+        if (j == begin())
+            return mystl::pair<base_ptr, base_ptr>(x, y);
+        --j;
+    }
+    if (key_compare(key(j.node), k))
+        return mystl::pair<base_ptr, base_ptr>(x, y);
+    return mystl::pair<base_ptr, base_ptr>(j.node, 0);
 }
 
+// 从树上摘下结点 z 并调整平衡, 不析构也不释放
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
-inline void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator position) {
+inline typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::unlink_node(base_ptr z) {
     link_type y =
-        (link_type)rb_tree_rebalance_for_erase(position.node,
+        (link_type)rb_tree_rebalance_for_erase(z,
                                                header->parent,
                                                header->left,
                                                header->right);
-    destroy_node(y);
     --node_count;
+    return y;
+}
+
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_return_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(node_type&& nh) {
+    insert_return_type ret;
+    if (nh.empty()) {
+        ret.position = end();
+        ret.inserted = false;
+        return ret;
+    }
+    MYSTL_DEBUG(get_alloc() == nh.get_alloc());
+    mystl::pair<base_ptr, base_ptr> pos = get_insert_unique_pos(key(nh.node_));
+    if (pos.second == 0) {
+        ret.position = iterator((link_type)pos.first);
+        ret.inserted = false;
+        ret.node = mystl::move(nh);
+        return ret;
+    }
+    ret.position = link_node(pos.first, pos.second, nh.release());
+    ret.inserted = true;
+    return ret;
+}
+
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(node_type&& nh) {
+    if (nh.empty()) {
+        return end();
+    }
+    MYSTL_DEBUG(get_alloc() == nh.get_alloc());
+    link_type y = header;
+    link_type x = root();
+    while (x != 0) {
+        y = x;
+        x = key_compare(key(nh.node_), key(x)) ? left(x) : right(x);
+    }
+    return link_node(x, y, nh.release());
+}
+
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::merge_unique(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& source) {
+    if (&source == this) {
+        return;
+    }
+    MYSTL_DEBUG(get_alloc() == source.get_alloc());
+    for (iterator it = source.begin(); it != source.end();) {
+        iterator next = it;
+        ++next;
+        mystl::pair<base_ptr, base_ptr> pos = get_insert_unique_pos(key(it.node));
+        if (pos.second != 0) {
+            link_node(pos.first, pos.second, source.unlink_node(it.node));
+        }
+        it = next;
+    }
+}
+
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::merge_equal(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& source) {
+    if (&source == this) {
+        return;
+    }
+    MYSTL_DEBUG(get_alloc() == source.get_alloc());
+    for (iterator it = source.begin(); it != source.end();) {
+        iterator next = it;
+        ++next;
+        link_type y = header;
+        link_type x = root();
+        while (x != 0) {
+            y = x;
+            x = key_compare(key(it.node), key(x)) ? left(x) : right(x);
+        }
+        link_node(x, y, source.unlink_node(it.node));
+        it = next;
+    }
+}
+
+template <class Key, class Value, class KeyOfValue,
+          class Compare, class Alloc>
+inline typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const_iterator position) {
+    iterator next((link_type)position.node);
+    ++next;
+    destroy_node(unlink_node(position.node));
+    return next;
 }
 
 template <class Key, class Value, class KeyOfValue,
@@ -926,8 +1392,7 @@ template <class Key, class Value, class KeyOfValue,
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
 rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const Key& x) {
     mystl::pair<iterator, iterator> p = equal_range(x);
-    size_type n = 0;
-    distance(p.first, p.second, n);
+    size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
     erase(p.first, p.second);
     return n;
 }
@@ -975,11 +1440,14 @@ void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(link_type x) {
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
-void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator first, iterator last) {
-    if (first == begin() && last == end())
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const_iterator first, const_iterator last) {
+    if (first == begin() && last == end()) {
         clear();
-    else
-        while (first != last) erase(first++);
+        return end();
+    }
+    while (first != last) first = erase(first);
+    return iterator((link_type)last.node);
 }
 
 template <class Key, class Value, class KeyOfValue,
@@ -991,8 +1459,9 @@ void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const Key* first, co
 // find 查找
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const K& k) {
     link_type y = header; // Last node which is not less than k.
     link_type x = root(); // Current node.
 
@@ -1010,8 +1479,9 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) {
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::const_iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) const {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const K& k) const {
     link_type y = header; /* Last node which is not less than k. */
     link_type x = root(); /* Current node. */
 
@@ -1029,18 +1499,19 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) const {
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::count(const Key& k) const {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::count(const K& k) const {
     mystl::pair<const_iterator, const_iterator> p = equal_range(k);
-    size_type n = 0;
-    distance(p.first, p.second, n);
+    size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
     return n;
 }
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const Key& k) {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const K& k) {
     link_type y = header; /* Last node which is not less than k. */
     link_type x = root(); /* Current node. */
 
@@ -1055,8 +1526,9 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const Key& k) {
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::const_iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const Key& k) const {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const K& k) const {
     link_type y = header; /* Last node which is not less than k. */
     link_type x = root(); /* Current node. */
 
@@ -1071,8 +1543,9 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const Key& k) const
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const Key& k) {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const K& k) {
     link_type y = header; /* Last node which is greater than k. */
     link_type x = root(); /* Current node. */
 
@@ -1087,8 +1560,9 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const Key& k) {
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::const_iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const Key& k) const {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const K& k) const {
     link_type y = header; /* Last node which is greater than k. */
     link_type x = root(); /* Current node. */
 
@@ -1103,16 +1577,18 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const Key& k) const
 
 template <class Key, class Value, class KeyOfValue,
           class Compare, class Alloc>
+template <class K>
 inline mystl::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator,
                    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator>
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::equal_range(const Key& k) {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::equal_range(const K& k) {
     return mystl::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
 }
 
 template <class Key, class Value, class KoV, class Compare, class Alloc>
+template <class K>
 inline mystl::pair<typename rb_tree<Key, Value, KoV, Compare, Alloc>::const_iterator,
                    typename rb_tree<Key, Value, KoV, Compare, Alloc>::const_iterator>
-rb_tree<Key, Value, KoV, Compare, Alloc>::equal_range(const Key& k) const {
+rb_tree<Key, Value, KoV, Compare, Alloc>::equal_range(const K& k) const {
     return mystl::pair<const_iterator, const_iterator>(lower_bound(k),
                                                        upper_bound(k));
 }
@@ -1162,4 +1638,5 @@ bool rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::rb_verify() const {
 
     return true;
 }
-}
\ No newline at end of file
+}
+#endif // !MYSTL_RB_TREE_H_
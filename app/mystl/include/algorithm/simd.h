@@ -0,0 +1,477 @@
+#ifndef MYSTL_SIMD_H_
+#define MYSTL_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 为 1 时 find/count/min_element/max_element/accumulate 在连续的算术类型区间上使用 SSE2/AVX2,
+// 为 0 时全部走通用实现. 只支持 GCC/Clang 的 x86 目标: SSE2 是 x86-64 的基线指令集,
+// AVX2 在编译时打开(-mavx2)就直接使用, 否则运行时检测 CPU 后选择
+#ifndef MYSTL_SIMD
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define MYSTL_SIMD 1
+#else
+#define MYSTL_SIMD 0
+#endif
+#endif
+
+#if MYSTL_SIMD
+#include <immintrin.h>
+#endif
+
+namespace mystl {
+namespace simd {
+
+// 元素在向量寄存器中的解释方式; 整数比较相等只看位模式, 有无符号共用一种
+enum lane_kind {
+    LANE_NONE,
+    LANE_I8,
+    LANE_I16,
+    LANE_I32,
+    LANE_I64,
+    LANE_F32,
+    LANE_F64
+};
+
+template <class T, class = void>
+struct lane_of : std::integral_constant<int, LANE_NONE> {};
+
+template <class T>
+struct lane_of<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+    : std::integral_constant<int, sizeof(T) == 1U ? LANE_I8 : sizeof(T) == 2U ? LANE_I16 : sizeof(T) == 4U ? LANE_I32 : sizeof(T) == 8U ? LANE_I64 : LANE_NONE> {};
+
+template <>
+struct lane_of<float> : std::integral_constant<int, LANE_F32> {};
+
+template <>
+struct lane_of<double> : std::integral_constant<int, LANE_F64> {};
+
+// [first, last) 是指向 T 的指针区间(vector、array 的迭代器就是指针), 并且 T 有对应的向量实现
+template <class Iterator, class T>
+struct is_simd_range : std::false_type {};
+
+template <class U, class T>
+struct is_simd_range<U*, T>
+    : std::integral_constant<bool, MYSTL_SIMD && std::is_same<typename std::remove_cv<U>::type, T>::value
+                                       && !std::is_volatile<U>::value && lane_of<T>::value != LANE_NONE> {};
+
+// min/max 只对整数提供: 浮点数的 NaN 与 operator< 的语义对不上
+template <class Iterator>
+struct is_simd_minmax_range : std::false_type {};
+
+template <class U>
+struct is_simd_minmax_range<U*>
+    : std::integral_constant<bool, MYSTL_SIMD && std::is_integral<U>::value && !std::is_same<U, bool>::value
+                                       && !std::is_volatile<U>::value && sizeof(U) <= 4U> {};
+
+// 求和只对 32/64 位整数提供: 整数加法的结果与求和顺序无关, 浮点数换顺序会改变舍入结果
+template <class Iterator, class T>
+struct is_simd_sum_range : std::false_type {};
+
+template <class U, class T>
+struct is_simd_sum_range<U*, T>
+    : std::integral_constant<bool, MYSTL_SIMD && std::is_same<typename std::remove_cv<U>::type, T>::value
+                                       && std::is_integral<T>::value && (sizeof(T) == 4U || sizeof(T) == 8U)
+                                       && !std::is_volatile<U>::value> {};
+
+#if MYSTL_SIMD
+
+#if defined(__AVX2__)
+inline bool has_avx2() {
+    return true;
+}
+#else
+inline bool has_avx2() {
+    static const bool has = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return has;
+}
+#endif
+
+#define MYSTL_TARGET_AVX2 __attribute__((target("avx2")))
+
+// 把 val 重复填满一个向量寄存器
+template <class T>
+__m128i splat128(const T& val) {
+    unsigned char bytes[16];
+    for (std::size_t i = 0; i < 16U; i += sizeof(T)) {
+        std::memcpy(bytes + i, &val, sizeof(T));
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 __m256i splat256(const T& val) {
+    unsigned char bytes[32];
+    for (std::size_t i = 0; i < 32U; i += sizeof(T)) {
+        std::memcpy(bytes + i, &val, sizeof(T));
+    }
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+}
+
+// 按元素比较相等, 相等的元素所有字节置 1, 之后统一用 movemask_epi8 取出字节掩码
+template <int Lane>
+struct eq128;
+
+template <>
+struct eq128<LANE_I8> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_cmpeq_epi8(a, b);
+    }
+};
+
+template <>
+struct eq128<LANE_I16> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_cmpeq_epi16(a, b);
+    }
+};
+
+template <>
+struct eq128<LANE_I32> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_cmpeq_epi32(a, b);
+    }
+};
+
+// SSE2 没有 64 位比较, 两个 32 位半边都相等才算相等
+template <>
+struct eq128<LANE_I64> {
+    static __m128i apply(__m128i a, __m128i b) {
+        const __m128i eq = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+};
+
+template <>
+struct eq128<LANE_F32> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+};
+
+template <>
+struct eq128<LANE_F64> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+};
+
+template <int Lane>
+struct eq256;
+
+template <>
+struct eq256<LANE_I8> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+};
+
+template <>
+struct eq256<LANE_I16> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi16(a, b);
+    }
+};
+
+template <>
+struct eq256<LANE_I32> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+};
+
+template <>
+struct eq256<LANE_I64> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+};
+
+template <>
+struct eq256<LANE_F32> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+};
+
+template <>
+struct eq256<LANE_F64> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+};
+
+/*
+ * find / count
+ */
+template <class T>
+const T* find_sse2(const T* first, const T* last, const T& val) {
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    const __m128i needle = splat128(val);
+    for (; last - first >= lanes; first += lanes) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq128<lane_of<T>::value>::apply(block, needle)));
+        if (mask != 0U) {
+            return first + __builtin_ctz(mask) / sizeof(T);
+        }
+    }
+    for (; first != last; ++first) {
+        if (*first == val) { return first; }
+    }
+    return last;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 const T* find_avx2(const T* first, const T* last, const T& val) {
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    const __m256i needle = splat256(val);
+    for (; last - first >= lanes; first += lanes) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const unsigned mask =
+            static_cast<unsigned>(_mm256_movemask_epi8(eq256<lane_of<T>::value>::apply(block, needle)));
+        if (mask != 0U) {
+            return first + __builtin_ctz(mask) / sizeof(T);
+        }
+    }
+    for (; first != last; ++first) {
+        if (*first == val) { return first; }
+    }
+    return last;
+}
+
+template <class T>
+const T* find(const T* first, const T* last, const T& val) {
+    return has_avx2() ? find_avx2(first, last, val) : find_sse2(first, last, val);
+}
+
+template <class T>
+std::ptrdiff_t count_sse2(const T* first, const T* last, const T& val) {
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    const __m128i needle = splat128(val);
+    std::ptrdiff_t bytes = 0;
+    for (; last - first >= lanes; first += lanes) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        bytes += __builtin_popcount(
+            static_cast<unsigned>(_mm_movemask_epi8(eq128<lane_of<T>::value>::apply(block, needle))));
+    }
+    std::ptrdiff_t n = bytes / static_cast<std::ptrdiff_t>(sizeof(T));
+    for (; first != last; ++first) {
+        if (*first == val) { ++n; }
+    }
+    return n;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 std::ptrdiff_t count_avx2(const T* first, const T* last, const T& val) {
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    const __m256i needle = splat256(val);
+    std::ptrdiff_t bytes = 0;
+    for (; last - first >= lanes; first += lanes) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        bytes += __builtin_popcount(
+            static_cast<unsigned>(_mm256_movemask_epi8(eq256<lane_of<T>::value>::apply(block, needle))));
+    }
+    std::ptrdiff_t n = bytes / static_cast<std::ptrdiff_t>(sizeof(T));
+    for (; first != last; ++first) {
+        if (*first == val) { ++n; }
+    }
+    return n;
+}
+
+template <class T>
+std::ptrdiff_t count(const T* first, const T* last, const T& val) {
+    return has_avx2() ? count_avx2(first, last, val) : count_sse2(first, last, val);
+}
+
+/*
+ * min / max: 先求出最值, 再查找它第一次出现的位置; SSE2 缺少 32 位整数的 min/max, 只实现 AVX2 版本
+ */
+template <class T, bool Signed = std::is_signed<T>::value, std::size_t Size = sizeof(T)>
+struct minmax256;
+
+#define MYSTL_SIMD_MINMAX256(Signed, Size, MinOp, MaxOp)              \
+    template <class T>                                                \
+    struct minmax256<T, Signed, Size> {                               \
+        MYSTL_TARGET_AVX2 static __m256i min(__m256i a, __m256i b) {  \
+            return MinOp(a, b);                                       \
+        }                                                             \
+        MYSTL_TARGET_AVX2 static __m256i max(__m256i a, __m256i b) {  \
+            return MaxOp(a, b);                                       \
+        }                                                             \
+    };
+
+MYSTL_SIMD_MINMAX256(true, 1U, _mm256_min_epi8, _mm256_max_epi8)
+MYSTL_SIMD_MINMAX256(false, 1U, _mm256_min_epu8, _mm256_max_epu8)
+MYSTL_SIMD_MINMAX256(true, 2U, _mm256_min_epi16, _mm256_max_epi16)
+MYSTL_SIMD_MINMAX256(false, 2U, _mm256_min_epu16, _mm256_max_epu16)
+MYSTL_SIMD_MINMAX256(true, 4U, _mm256_min_epi32, _mm256_max_epi32)
+MYSTL_SIMD_MINMAX256(false, 4U, _mm256_min_epu32, _mm256_max_epu32)
+
+#undef MYSTL_SIMD_MINMAX256
+
+// 调用方保证区间非空; Max 为 true 时求最大值
+template <bool Max, class T>
+MYSTL_TARGET_AVX2 T extreme_avx2(const T* first, const T* last) {
+    using ops = minmax256<T>;
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    T best = *first;
+    if (last - first >= lanes) {
+        __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        for (first += lanes; last - first >= lanes; first += lanes) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            acc = Max ? ops::max(acc, block) : ops::min(acc, block);
+        }
+        T tmp[32 / sizeof(T)];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp), acc);
+        best = tmp[0];
+        for (std::ptrdiff_t i = 1; i < lanes; ++i) {
+            if (Max ? best < tmp[i] : tmp[i] < best) { best = tmp[i]; }
+        }
+    }
+    for (; first != last; ++first) {
+        if (Max ? best < *first : *first < best) { best = *first; }
+    }
+    return best;
+}
+
+// 不支持 AVX2 时返回 nullptr, 由调用方走通用实现
+template <bool Max, class T>
+const T* extreme_element(const T* first, const T* last) {
+    if (!has_avx2()) {
+        return nullptr;
+    }
+    if (first == last) {
+        return last;
+    }
+    const T best = extreme_avx2<Max>(first, last);
+    return find_avx2(first, last, best);
+}
+
+/*
+ * 整数求和, 按无符号数回绕相加, 与逐个相加的结果相同
+ */
+template <std::size_t Size>
+struct add128;
+
+template <>
+struct add128<4U> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_add_epi32(a, b);
+    }
+};
+
+template <>
+struct add128<8U> {
+    static __m128i apply(__m128i a, __m128i b) {
+        return _mm_add_epi64(a, b);
+    }
+};
+
+template <std::size_t Size>
+struct add256;
+
+template <>
+struct add256<4U> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_add_epi32(a, b);
+    }
+};
+
+template <>
+struct add256<8U> {
+    MYSTL_TARGET_AVX2 static __m256i apply(__m256i a, __m256i b) {
+        return _mm256_add_epi64(a, b);
+    }
+};
+
+template <class T>
+T wrapping_add(T a, T b) {
+    using U = typename std::make_unsigned<T>::type;
+    const U sum = static_cast<U>(static_cast<U>(a) + static_cast<U>(b));
+    T result;
+    std::memcpy(&result, &sum, sizeof(T));
+    return result;
+}
+
+// 两个累加寄存器交替使用, 隐藏加法的延迟
+template <class T>
+T sum_sse2(const T* first, const T* last, T init) {
+    const std::ptrdiff_t lanes = 16 / sizeof(T);
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    for (; last - first >= 2 * lanes; first += 2 * lanes) {
+        acc0 = add128<sizeof(T)>::apply(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+        acc1 = add128<sizeof(T)>::apply(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + lanes)));
+    }
+    T tmp[16 / sizeof(T)];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), add128<sizeof(T)>::apply(acc0, acc1));
+    for (std::ptrdiff_t i = 0; i < lanes; ++i) {
+        init = wrapping_add(init, tmp[i]);
+    }
+    for (; first != last; ++first) {
+        init = wrapping_add(init, *first);
+    }
+    return init;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 T sum_avx2(const T* first, const T* last, T init) {
+    const std::ptrdiff_t lanes = 32 / sizeof(T);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    for (; last - first >= 2 * lanes; first += 2 * lanes) {
+        acc0 = add256<sizeof(T)>::apply(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)));
+        acc1 = add256<sizeof(T)>::apply(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + lanes)));
+    }
+    T tmp[32 / sizeof(T)];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp), add256<sizeof(T)>::apply(acc0, acc1));
+    for (std::ptrdiff_t i = 0; i < lanes; ++i) {
+        init = wrapping_add(init, tmp[i]);
+    }
+    for (; first != last; ++first) {
+        init = wrapping_add(init, *first);
+    }
+    return init;
+}
+
+template <class T>
+T sum(const T* first, const T* last, T init) {
+    return has_avx2() ? sum_avx2(first, last, init) : sum_sse2(first, last, init);
+}
+
+#undef MYSTL_TARGET_AVX2
+
+#else // !MYSTL_SIMD
+
+// 未启用时这些函数不会被调用, 只为让分派代码能够编译
+template <class T>
+const T* find(const T*, const T* last, const T&) {
+    return last;
+}
+
+template <class T>
+std::ptrdiff_t count(const T*, const T*, const T&) {
+    return 0;
+}
+
+template <bool Max, class T>
+const T* extreme_element(const T*, const T*) {
+    return nullptr;
+}
+
+template <class T>
+T sum(const T*, const T*, T init) {
+    return init;
+}
+
+#endif // MYSTL_SIMD
+
+} // namespace simd
+} // namespace mystl
+
+#endif // MYSTL_SIMD_H_
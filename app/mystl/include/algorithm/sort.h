@@ -0,0 +1,806 @@
+#ifndef MYSTL_SORT_H_
+#define MYSTL_SORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include "utility.h"
+#include "iterator.h"
+#include "functional.h"
+#include "algorithm.h"
+#include "heap.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace mystl {
+
+/*
+ * sort: pattern-defeating quicksort (Orson Peters, pdqsort)
+ * - 小区间用插入排序
+ * - 大区间用 ninther 选轴, 算术类型加默认比较器时用 BlockQuicksort 的无分支划分
+ * - 与轴相等的元素很多时把它们集中到左边一次跳过
+ * - 划分严重不平衡时打乱若干元素; 次数超过 log2(n) 后退化为 heap.h 的堆排序, 保证 O(n log n)
+ * - 划分后两边已经有序时(升序、降序等模式)用有限步数的插入排序直接结束
+ */
+namespace sort_detail {
+
+enum {
+    INSERTION_SORT_THRESHOLD = 24,
+    NINTHER_THRESHOLD = 128,
+    PARTIAL_INSERTION_SORT_LIMIT = 8,
+    BLOCK_SIZE = 64,
+    CACHELINE_SIZE = 64
+};
+
+template <class Compare, class T>
+struct is_default_compare : std::false_type {};
+
+template <class T>
+struct is_default_compare<mystl::less<T>, T> : std::true_type {};
+
+template <class T>
+struct is_default_compare<mystl::greater<T>, T> : std::true_type {};
+
+// 比较只是一条指令、没有副作用时才值得做成无分支
+template <class RandomAccessIterator, class Compare>
+struct use_branchless_partition
+    : std::integral_constant<bool, std::is_arithmetic<typename iterator_traits<RandomAccessIterator>::value_type>::value
+                                       && is_default_compare<Compare, typename iterator_traits<RandomAccessIterator>::value_type>::value> {};
+
+template <class Size>
+int log2(Size n) {
+    int log = 0;
+    while (n >>= 1) {
+        ++log;
+    }
+    return log;
+}
+
+template <class RandomAccessIterator, class Compare>
+void insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    if (first == last) return;
+    for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+        RandomAccessIterator sift = cur;
+        RandomAccessIterator sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+        }
+    }
+}
+
+// 调用方保证 *(first - 1) 不大于区间内任何元素, 可以省掉边界检查
+template <class RandomAccessIterator, class Compare>
+void unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    if (first == last) return;
+    for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+        RandomAccessIterator sift = cur;
+        RandomAccessIterator sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+        }
+    }
+}
+
+// 移动次数超过上限就放弃, 返回区间是否已经排好
+template <class RandomAccessIterator, class Compare>
+bool partial_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    if (first == last) return true;
+    std::size_t limit = 0;
+    for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+        RandomAccessIterator sift = cur;
+        RandomAccessIterator sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+            limit += static_cast<std::size_t>(cur - sift);
+        }
+        if (limit > PARTIAL_INSERTION_SORT_LIMIT) return false;
+    }
+    return true;
+}
+
+template <class RandomAccessIterator, class Compare>
+void sort2(RandomAccessIterator a, RandomAccessIterator b, Compare comp) {
+    if (comp(*b, *a)) mystl::iter_swap(a, b);
+}
+
+template <class RandomAccessIterator, class Compare>
+void sort3(RandomAccessIterator a, RandomAccessIterator b, RandomAccessIterator c, Compare comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+inline unsigned char* align_cacheline(unsigned char* p) {
+    std::uintptr_t ip = reinterpret_cast<std::uintptr_t>(p);
+    ip = (ip + CACHELINE_SIZE - 1) & ~static_cast<std::uintptr_t>(CACHELINE_SIZE - 1);
+    return reinterpret_cast<unsigned char*>(ip);
+}
+
+// 按记录的偏移交换左右两侧放错的元素; 两侧个数不等时用轮换代替交换, 少一半的移动
+template <class RandomAccessIterator>
+void swap_offsets(RandomAccessIterator first, RandomAccessIterator last, unsigned char* offsets_l,
+                  unsigned char* offsets_r, std::size_t num, bool use_swaps) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    if (use_swaps) {
+        for (std::size_t i = 0; i < num; ++i) {
+            mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+    } else if (num > 0) {
+        RandomAccessIterator l = first + offsets_l[0];
+        RandomAccessIterator r = last - offsets_r[0];
+        T tmp(mystl::move(*l));
+        *l = mystl::move(*r);
+        for (std::size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = mystl::move(*l);
+            r = last - offsets_r[i];
+            *l = mystl::move(*r);
+        }
+        *r = mystl::move(tmp);
+    }
+}
+
+// 以 *first 为轴划分, 与轴相等的元素放在右边; 返回轴的最终位置, 以及划分前是否已经分好
+// 无分支版本: 先成块比较并把放错的偏移记在缓冲区里, 再统一交换, 比较结果不再导致分支预测失败
+template <class RandomAccessIterator, class Compare>
+pair<RandomAccessIterator, bool> partition_right_branchless(RandomAccessIterator begin, RandomAccessIterator end,
+                                                            Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    T pivot(mystl::move(*begin));
+    RandomAccessIterator first = begin;
+    RandomAccessIterator last = end;
+
+    // 轴是三数取中得到的, 左边一定有不小于轴的元素作为哨兵; 右边只有第一次找不到时才需要检查边界
+    while (comp(*++first, pivot)) {}
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+    } else {
+        while (!comp(*--last, pivot)) {}
+    }
+
+    const bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        mystl::iter_swap(first, last);
+        ++first;
+
+        unsigned char offsets_l_storage[BLOCK_SIZE + CACHELINE_SIZE];
+        unsigned char offsets_r_storage[BLOCK_SIZE + CACHELINE_SIZE];
+        unsigned char* offsets_l = align_cacheline(offsets_l_storage);
+        unsigned char* offsets_r = align_cacheline(offsets_r_storage);
+        RandomAccessIterator offsets_l_base = first;
+        RandomAccessIterator offsets_r_base = last;
+        std::size_t num_l = 0;
+        std::size_t num_r = 0;
+        std::size_t start_l = 0;
+        std::size_t start_r = 0;
+
+        while (first < last) {
+            // 剩余不足两块时把未知区间分给需要的一侧
+            const std::size_t num_unknown = static_cast<std::size_t>(last - first);
+            const std::size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            const std::size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            if (left_split >= BLOCK_SIZE) {
+                for (std::size_t i = 0; i < BLOCK_SIZE;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++);
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++);
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++);
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++);
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                }
+            } else {
+                for (std::size_t i = 0; i < left_split;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++);
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                }
+            }
+
+            if (right_split >= BLOCK_SIZE) {
+                for (std::size_t i = 0; i < BLOCK_SIZE;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i);
+                    num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i);
+                    num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i);
+                    num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i);
+                    num_r += comp(*--last, pivot);
+                }
+            } else {
+                for (std::size_t i = 0; i < right_split;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i);
+                    num_r += comp(*--last, pivot);
+                }
+            }
+
+            const std::size_t num = num_l < num_r ? num_l : num_r;
+            swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num,
+                         num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+
+        // 一侧还有剩余的放错元素, 逐个交换到中间
+        if (num_l) {
+            offsets_l += start_l;
+            while (num_l--) {
+                mystl::iter_swap(offsets_l_base + offsets_l[num_l], --last);
+            }
+            first = last;
+        }
+        if (num_r) {
+            offsets_r += start_r;
+            while (num_r--) {
+                mystl::iter_swap(offsets_r_base - offsets_r[num_r], first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    RandomAccessIterator pivot_pos = first - 1;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return pair<RandomAccessIterator, bool>(pivot_pos, already_partitioned);
+}
+
+template <class RandomAccessIterator, class Compare>
+pair<RandomAccessIterator, bool> partition_right(RandomAccessIterator begin, RandomAccessIterator end, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    T pivot(mystl::move(*begin));
+    RandomAccessIterator first = begin;
+    RandomAccessIterator last = end;
+
+    while (comp(*++first, pivot)) {}
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+    } else {
+        while (!comp(*--last, pivot)) {}
+    }
+
+    const bool already_partitioned = first >= last;
+    while (first < last) {
+        mystl::iter_swap(first, last);
+        while (comp(*++first, pivot)) {}
+        while (!comp(*--last, pivot)) {}
+    }
+
+    RandomAccessIterator pivot_pos = first - 1;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return pair<RandomAccessIterator, bool>(pivot_pos, already_partitioned);
+}
+
+// 与 partition_right 相反, 与轴相等的元素放在左边; 用于把大量重复的元素一次跳过
+template <class RandomAccessIterator, class Compare>
+RandomAccessIterator partition_left(RandomAccessIterator begin, RandomAccessIterator end, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    T pivot(mystl::move(*begin));
+    RandomAccessIterator first = begin;
+    RandomAccessIterator last = end;
+
+    while (comp(pivot, *--last)) {}
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {}
+    } else {
+        while (!comp(pivot, *++first)) {}
+    }
+
+    while (first < last) {
+        mystl::iter_swap(first, last);
+        while (comp(pivot, *--last)) {}
+        while (!comp(pivot, *++first)) {}
+    }
+
+    RandomAccessIterator pivot_pos = last;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return pivot_pos;
+}
+
+template <class RandomAccessIterator, class Compare>
+pair<RandomAccessIterator, bool> partition_right(RandomAccessIterator begin, RandomAccessIterator end, Compare comp,
+                                                 std::true_type) {
+    return partition_right_branchless(begin, end, comp);
+}
+
+template <class RandomAccessIterator, class Compare>
+pair<RandomAccessIterator, bool> partition_right(RandomAccessIterator begin, RandomAccessIterator end, Compare comp,
+                                                 std::false_type) {
+    return partition_right(begin, end, comp);
+}
+
+// leftmost 为 false 时 *(begin - 1) 是上一次划分的轴, 不大于区间内的任何元素
+template <class RandomAccessIterator, class Compare, class Branchless>
+void pdqsort_loop(RandomAccessIterator begin, RandomAccessIterator end, Compare comp, int bad_allowed,
+                  bool leftmost, Branchless branchless) {
+    using diff_t = typename iterator_traits<RandomAccessIterator>::difference_type;
+
+    // 较大的一半用循环处理, 递归深度为 O(log n)
+    while (true) {
+        const diff_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost) {
+                insertion_sort(begin, end, comp);
+            } else {
+                unguarded_insertion_sort(begin, end, comp);
+            }
+            return;
+        }
+
+        // 选轴: 大区间用 ninther(三组三数取中再取中), 否则三数取中; 轴放在 begin
+        const diff_t s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + s2, end - 1, comp);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            mystl::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // 轴与左边界上一次的轴相等: 区间里与它相等的元素都集中到左边, 不再参与排序
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        const pair<RandomAccessIterator, bool> part_result = partition_right(begin, end, comp, branchless);
+        const RandomAccessIterator pivot_pos = part_result.first;
+        const bool already_partitioned = part_result.second;
+
+        const diff_t l_size = pivot_pos - begin;
+        const diff_t r_size = end - (pivot_pos + 1);
+        const bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            // 不平衡的次数太多, 改用堆排序
+            if (--bad_allowed == 0) {
+                mystl::make_heap(begin, end, comp);
+                mystl::sort_heap(begin, end, comp);
+                return;
+            }
+
+            // 打乱若干元素, 破坏导致不平衡的模式
+            if (l_size >= INSERTION_SORT_THRESHOLD) {
+                mystl::iter_swap(begin, begin + l_size / 4);
+                mystl::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > NINTHER_THRESHOLD) {
+                    mystl::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    mystl::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    mystl::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    mystl::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= INSERTION_SORT_THRESHOLD) {
+                mystl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                mystl::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > NINTHER_THRESHOLD) {
+                    mystl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    mystl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    mystl::iter_swap(end - 2, end - (1 + r_size / 4));
+                    mystl::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, comp)
+                   && partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // 划分前已经分好, 两边也几乎有序
+            return;
+        }
+
+        pdqsort_loop(begin, pivot_pos, comp, bad_allowed, leftmost, branchless);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+/*
+ * stable_sort 用的临时缓冲区: 申请失败时逐次减半, 最后可能为空
+ */
+template <class T>
+class temporary_buffer {
+public:
+    explicit temporary_buffer(std::ptrdiff_t requested) :
+        buffer_(nullptr), size_(0) {
+        while (requested > 0) {
+            try {
+                buffer_ = mystl::allocator<T>::allocate(static_cast<std::size_t>(requested));
+                size_ = requested;
+                return;
+            } catch (const std::bad_alloc&) {
+                requested /= 2;
+            }
+        }
+    }
+
+    ~temporary_buffer() {
+        if (buffer_ != nullptr) {
+            mystl::allocator<T>::deallocate(buffer_, static_cast<std::size_t>(size_));
+        }
+    }
+
+    temporary_buffer(const temporary_buffer&) = delete;
+    temporary_buffer& operator=(const temporary_buffer&) = delete;
+
+    T* data() const noexcept {
+        return buffer_;
+    }
+
+    std::ptrdiff_t size() const noexcept {
+        return size_;
+    }
+
+private:
+    T* buffer_;
+    std::ptrdiff_t size_;
+};
+
+enum {
+    STABLE_CHUNK_SIZE = 32
+};
+
+// 左半段移到缓冲区, 再与右半段归并回原处; 相等时先取左边的元素, 保证稳定
+// 比较抛出异常时把缓冲区中剩余的元素移回空位
+template <class RandomAccessIterator, class T, class Compare>
+void merge_with_buffer(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, T* buffer,
+                       Compare comp) {
+    T* const buffer_end = mystl::uninitialized_move(first, middle, buffer);
+    T* b = buffer;
+    RandomAccessIterator out = first;
+    RandomAccessIterator r = middle;
+    try {
+        while (b != buffer_end && r != last) {
+            if (comp(*r, *b)) {
+                *out = mystl::move(*r);
+                ++r;
+            } else {
+                *out = mystl::move(*b);
+                ++b;
+            }
+            ++out;
+        }
+    } catch (...) {
+        mystl::move(b, buffer_end, out);
+        mystl::destroy(buffer, buffer_end);
+        throw;
+    }
+    mystl::move(b, buffer_end, out);
+    mystl::destroy(buffer, buffer_end);
+}
+
+// 右半段移到缓冲区, 从后往前与左半段归并; 右段较短时用, 缓冲区只需放下右段
+// 相等时先放右边的元素到末尾, 同样稳定
+template <class RandomAccessIterator, class T, class Compare>
+void merge_backward_with_buffer(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last,
+                                T* buffer, Compare comp) {
+    T* const buffer_end = mystl::uninitialized_move(middle, last, buffer);
+    T* b = buffer_end;
+    RandomAccessIterator out = last;
+    RandomAccessIterator l = middle;
+    try {
+        while (b != buffer && l != first) {
+            if (comp(*(b - 1), *(l - 1))) {
+                *--out = mystl::move(*--l);
+            } else {
+                *--out = mystl::move(*--b);
+            }
+        }
+    } catch (...) {
+        mystl::move_backward(buffer, b, out);
+        mystl::destroy(buffer, buffer_end);
+        throw;
+    }
+    mystl::move_backward(buffer, b, out);
+    mystl::destroy(buffer, buffer_end);
+}
+
+// 缓冲区至少能放下一半元素
+template <class RandomAccessIterator, class T, class Compare>
+void merge_sort_with_buffer(RandomAccessIterator first, RandomAccessIterator last, T* buffer, Compare comp) {
+    const auto len = last - first;
+    if (len <= STABLE_CHUNK_SIZE) {
+        insertion_sort(first, last, comp);
+        return;
+    }
+    const RandomAccessIterator middle = first + len / 2;
+    merge_sort_with_buffer(first, middle, buffer, comp);
+    merge_sort_with_buffer(middle, last, buffer, comp);
+    // 两段已经首尾有序, 不用归并
+    if (!comp(*middle, *(middle - 1))) return;
+    merge_with_buffer(first, middle, last, buffer, comp);
+}
+
+// 没有缓冲区时用旋转做原地归并, O(n log n) 次比较, O(n log^2 n) 次移动
+template <class BidirectionalIterator, class Distance, class Compare>
+void merge_without_buffer(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last,
+                          Distance len1, Distance len2, Compare comp) {
+    if (len1 == 0 || len2 == 0) return;
+    if (len1 + len2 == 2) {
+        if (comp(*middle, *first)) mystl::iter_swap(first, middle);
+        return;
+    }
+    BidirectionalIterator first_cut = first;
+    BidirectionalIterator second_cut = middle;
+    Distance len11 = 0;
+    Distance len22 = 0;
+    if (len1 > len2) {
+        len11 = len1 / 2;
+        mystl::advance(first_cut, len11);
+        second_cut = mystl::lower_bound(middle, last, *first_cut, comp);
+        len22 = mystl::distance(middle, second_cut);
+    } else {
+        len22 = len2 / 2;
+        mystl::advance(second_cut, len22);
+        first_cut = mystl::upper_bound(first, middle, *second_cut, comp);
+        len11 = mystl::distance(first, first_cut);
+    }
+    const BidirectionalIterator new_middle = mystl::rotate(first_cut, middle, second_cut);
+    merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+    merge_without_buffer(new_middle, second_cut, last, len1 - len11, len2 - len22, comp);
+}
+
+template <class RandomAccessIterator, class Compare>
+void inplace_stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    const auto len = last - first;
+    if (len <= STABLE_CHUNK_SIZE) {
+        insertion_sort(first, last, comp);
+        return;
+    }
+    const RandomAccessIterator middle = first + len / 2;
+    inplace_stable_sort(first, middle, comp);
+    inplace_stable_sort(middle, last, comp);
+    merge_without_buffer(first, middle, last, middle - first, last - middle, comp);
+}
+
+
+// 把 [middle, last) 中比堆顶小的元素换进堆, 结束后 [first, middle) 是最小的 middle - first 个元素组成的堆
+template <class RandomAccessIterator, class Compare>
+void heap_select(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    using diff_t = typename iterator_traits<RandomAccessIterator>::difference_type;
+    mystl::make_heap(first, middle, comp);
+    const diff_t len = middle - first;
+    for (RandomAccessIterator i = middle; i < last; ++i) {
+        if (comp(*i, *first)) {
+            T value = mystl::move(*i);
+            *i = mystl::move(*first);
+            mystl::adjust_heap(first, diff_t(0), len, mystl::move(value), comp);
+        }
+    }
+}
+
+// introselect: 与 pdqsort 相同的选轴和划分, 每轮只继续处理 nth 所在的一侧;
+// 划分次数超过 2 * log2(n) 时改用堆选择, 保证 O(n log n)
+template <class RandomAccessIterator, class Compare, class Branchless>
+void introselect(RandomAccessIterator begin, RandomAccessIterator nth, RandomAccessIterator end, Compare comp,
+                 int depth_limit, Branchless branchless) {
+    using diff_t = typename iterator_traits<RandomAccessIterator>::difference_type;
+    const RandomAccessIterator origin = begin;
+    while (end - begin > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit-- == 0) {
+            heap_select(begin, nth + 1, end, comp);
+            mystl::iter_swap(begin, nth);
+            return;
+        }
+        const diff_t size = end - begin;
+        const diff_t s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + s2, end - 1, comp);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            mystl::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // 轴与左边界之前的轴相等: 与它相等的元素都集中到左边, nth 落在其中时就已经就位
+        if (begin != origin && !comp(*(begin - 1), *begin)) {
+            const RandomAccessIterator pivot_pos = partition_left(begin, end, comp);
+            if (nth <= pivot_pos) return;
+            begin = pivot_pos + 1;
+            continue;
+        }
+
+        const RandomAccessIterator pivot_pos = partition_right(begin, end, comp, branchless).first;
+        if (pivot_pos == nth) return;
+        if (nth < pivot_pos) {
+            end = pivot_pos;
+        } else {
+            begin = pivot_pos + 1;
+        }
+    }
+    insertion_sort(begin, end, comp);
+}
+
+} // namespace sort_detail
+
+template <class RandomAccessIterator, class Compare>
+void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    if (last - first < 2) return;
+    sort_detail::pdqsort_loop(first, last, comp, sort_detail::log2(last - first), true,
+                              sort_detail::use_branchless_partition<RandomAccessIterator, Compare>());
+}
+
+template <class RandomAccessIterator>
+void sort(RandomAccessIterator first, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::sort(first, last, mystl::less<T>());
+}
+
+// 归并排序, 相等元素保持原来的相对顺序; 申请一半长度的临时缓冲区, 申请不到时原地归并
+template <class RandomAccessIterator, class Compare>
+void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    const auto len = last - first;
+    if (len <= sort_detail::STABLE_CHUNK_SIZE) {
+        sort_detail::insertion_sort(first, last, comp);
+        return;
+    }
+    const auto half = len - len / 2;
+    sort_detail::temporary_buffer<T> buffer(half);
+    if (buffer.size() >= half) {
+        sort_detail::merge_sort_with_buffer(first, last, buffer.data(), comp);
+    } else {
+        sort_detail::inplace_stable_sort(first, last, comp);
+    }
+}
+
+template <class RandomAccessIterator>
+void stable_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::stable_sort(first, last, mystl::less<T>());
+}
+
+/*
+ * partial_sort: 把最小的 middle - first 个元素按序放在 [first, middle), 其余元素次序不定
+ * 在前 middle - first 个元素上建堆, 逐个筛选后面的元素, 最后堆排序; O(n log k)
+ */
+template <class RandomAccessIterator, class Compare>
+void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp) {
+    if (first == middle) return;
+    sort_detail::heap_select(first, middle, last, comp);
+    mystl::sort_heap(first, middle, comp);
+}
+
+template <class RandomAccessIterator>
+void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::partial_sort(first, middle, last, mystl::less<T>());
+}
+
+// 把 [first, last) 中最小的若干个元素按序复制到 [result_first, result_last), 返回输出的末尾;
+// 输入只需遍历一次
+template <class InputIterator, class RandomAccessIterator, class Compare>
+RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last, RandomAccessIterator result_first,
+                                       RandomAccessIterator result_last, Compare comp) {
+    using diff_t = typename iterator_traits<RandomAccessIterator>::difference_type;
+    if (result_first == result_last) return result_last;
+    RandomAccessIterator result_real_last = result_first;
+    while (first != last && result_real_last != result_last) {
+        *result_real_last = *first;
+        ++result_real_last;
+        ++first;
+    }
+    mystl::make_heap(result_first, result_real_last, comp);
+    const diff_t len = result_real_last - result_first;
+    while (first != last) {
+        if (comp(*first, *result_first)) {
+            mystl::adjust_heap(result_first, diff_t(0), len,
+                               typename iterator_traits<RandomAccessIterator>::value_type(*first), comp);
+        }
+        ++first;
+    }
+    mystl::sort_heap(result_first, result_real_last, comp);
+    return result_real_last;
+}
+
+template <class InputIterator, class RandomAccessIterator>
+RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last, RandomAccessIterator result_first,
+                                       RandomAccessIterator result_last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    return mystl::partial_sort_copy(first, last, result_first, result_last, mystl::less<T>());
+}
+
+/*
+ * nth_element: 让 *nth 成为排序后应在该位置的元素, 前面的都不大于它, 后面的都不小于它
+ * 平均 O(n), 最坏 O(n log n)
+ */
+template <class RandomAccessIterator, class Compare>
+void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last, Compare comp) {
+    if (first == last || nth == last) return;
+    sort_detail::introselect(first, nth, last, comp, 2 * sort_detail::log2(last - first),
+                             sort_detail::use_branchless_partition<RandomAccessIterator, Compare>());
+}
+
+template <class RandomAccessIterator>
+void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::nth_element(first, nth, last, mystl::less<T>());
+}
+
+/*
+ * inplace_merge: 把相邻的有序区间 [first, middle) 和 [middle, last) 合并成一个有序区间, 稳定
+ * 先跳过已经就位的首尾两段, 再把较短的一段移到临时缓冲区归并, O(n) 次比较;
+ * 申请不到缓冲区时用旋转原地归并
+ */
+template <class RandomAccessIterator, class Compare>
+void inplace_merge(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    if (first == middle || middle == last || !comp(*middle, *(middle - 1))) return;
+    first = mystl::upper_bound(first, middle, *middle, comp);
+    last = mystl::lower_bound(middle, last, *(middle - 1), comp);
+    const auto len1 = middle - first;
+    const auto len2 = last - middle;
+    sort_detail::temporary_buffer<T> buffer(len1 < len2 ? len1 : len2);
+    if (len1 <= len2 && buffer.size() >= len1) {
+        sort_detail::merge_with_buffer(first, middle, last, buffer.data(), comp);
+    } else if (len2 < len1 && buffer.size() >= len2) {
+        sort_detail::merge_backward_with_buffer(first, middle, last, buffer.data(), comp);
+    } else {
+        sort_detail::merge_without_buffer(first, middle, last, len1, len2, comp);
+    }
+}
+
+template <class RandomAccessIterator>
+void inplace_merge(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last) {
+    using T = typename iterator_traits<RandomAccessIterator>::value_type;
+    mystl::inplace_merge(first, middle, last, mystl::less<T>());
+}
+
+template <class ForwardIterator, class Compare>
+bool is_sorted(ForwardIterator first, ForwardIterator last, Compare comp) {
+    if (first == last) return true;
+    ForwardIterator next = first;
+    while (++next != last) {
+        if (comp(*next, *first)) return false;
+        first = next;
+    }
+    return true;
+}
+
+template <class ForwardIterator>
+bool is_sorted(ForwardIterator first, ForwardIterator last) {
+    using T = typename iterator_traits<ForwardIterator>::value_type;
+    return mystl::is_sorted(first, last, mystl::less<T>());
+}
+
+} // namespace mystl
+
+#endif // MYSTL_SORT_H_
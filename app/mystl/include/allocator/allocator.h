@@ -3,9 +3,11 @@
 
 #include "construct.h"
 #include "my_allocator.h"
+#include "utility.h"
 
 #include <cstddef>
 #include <memory>
+#include <type_traits>
 
 namespace mystl {
 template <typename T>
@@ -32,24 +34,37 @@ public:
     allocator(const allocator<U>&){};
     ~allocator() = default;
 
-    static pointer address(reference x) const {
+    static pointer address(reference x) {
         return &x;
     }
 
-    static const_pointer address(const_reference x) const {
+    static const_pointer address(const_reference x) {
         return &x;
     }
 
+    // 超过 operator new 默认对齐的类型走对齐分配
     static pointer allocate(size_type n) {
+        if (OVER_ALIGNED) {
+            return reinterpret_cast<pointer>(
+                mystl::MyAllocator::GetInstance()->AllocateAligned(n * sizeof(value_type), alignof(value_type)));
+        }
         return reinterpret_cast<pointer>(mystl::MyAllocator::GetInstance()->Allocate(n * sizeof(value_type)));
     }
 
+    // 不带尺寸的释放无法找回超对齐大块的原始地址, 只用于普通对齐的类型
     static void deallocate(pointer ptr) {
+        static_assert(!OVER_ALIGNED, "over-aligned types must use deallocate(ptr, n)");
         mystl::MyAllocator::GetInstance()->Deallocate(reinterpret_cast<unsigned char*>(ptr));
     }
 
-    static void deallocate(pointer ptr, size_type /*size*/) {
-        deallocate(ptr);
+    // 带尺寸的释放, n 必须与 allocate 时一致
+    static void deallocate(pointer ptr, size_type n) {
+        if (OVER_ALIGNED) {
+            mystl::MyAllocator::GetInstance()->DeallocateAligned(reinterpret_cast<unsigned char*>(ptr),
+                                                                 n * sizeof(value_type), alignof(value_type));
+            return;
+        }
+        mystl::MyAllocator::GetInstance()->Deallocate(reinterpret_cast<unsigned char*>(ptr), n * sizeof(value_type));
     }
 
     static void construct(pointer ptr, const T& value) {
@@ -68,8 +83,44 @@ public:
     static void destroy(pointer first, pointer last) {
         mystl::destroy(first, last);
     }
+
+private:
+    static constexpr bool OVER_ALIGNED = alignof(T) > alignof(std::max_align_t);
 };
 
+// 无状态, 任意两个实例都相等
+template <class T, class U>
+inline bool operator==(const allocator<T>&, const allocator<U>&) {
+    return true;
+}
+
+template <class T, class U>
+inline bool operator!=(const allocator<T>&, const allocator<U>&) {
+    return false;
+}
+
+// 分配器没有定义 propagate_on_container_xxx 时默认为 false_type, 即分配器跟随容器实例不变
+template <typename Alloc, typename = std::void_t<>>
+struct propagate_on_copy_assignment : std::false_type {};
+
+template <typename Alloc>
+struct propagate_on_copy_assignment<Alloc, std::void_t<typename Alloc::propagate_on_container_copy_assignment>>
+    : Alloc::propagate_on_container_copy_assignment {};
+
+template <typename Alloc, typename = std::void_t<>>
+struct propagate_on_move_assignment : std::false_type {};
+
+template <typename Alloc>
+struct propagate_on_move_assignment<Alloc, std::void_t<typename Alloc::propagate_on_container_move_assignment>>
+    : Alloc::propagate_on_container_move_assignment {};
+
+template <typename Alloc, typename = std::void_t<>>
+struct propagate_on_swap : std::false_type {};
+
+template <typename Alloc>
+struct propagate_on_swap<Alloc, std::void_t<typename Alloc::propagate_on_container_swap>>
+    : Alloc::propagate_on_container_swap {};
+
 /*
  *@brief allocator traits
  */
@@ -81,6 +132,47 @@ struct allocator_traits {
     // 萃取分配器,将其绑定到新类型上
     using allocator_type = typename Alloc::template rebind<T>::other;
 
+    // 容器拷贝赋值、移动赋值、交换时是否连同分配器一起传播
+    using propagate_on_container_copy_assignment = typename propagate_on_copy_assignment<Alloc>::type;
+    using propagate_on_container_move_assignment = typename propagate_on_move_assignment<Alloc>::type;
+    using propagate_on_container_swap = typename propagate_on_swap<Alloc>::type;
+
+    // 拷贝构造容器时使用的分配器
+    static Alloc select_on_container_copy_construction(const Alloc& alloc) {
+        return alloc;
+    }
+
+    static void copy_assign(Alloc& to, const Alloc& from) {
+        copy_assign(to, from, propagate_on_container_copy_assignment());
+    }
+
+    static void move_assign(Alloc& to, Alloc& from) {
+        move_assign(to, from, propagate_on_container_move_assignment());
+    }
+
+    static void swap(Alloc& a, Alloc& b) {
+        swap(a, b, propagate_on_container_swap());
+    }
+
+private:
+    static void copy_assign(Alloc& to, const Alloc& from, std::true_type) {
+        to = from;
+    }
+    static void copy_assign(Alloc&, const Alloc&, std::false_type) {
+    }
+
+    static void move_assign(Alloc& to, Alloc& from, std::true_type) {
+        to = mystl::move(from);
+    }
+    static void move_assign(Alloc&, Alloc&, std::false_type) {
+    }
+
+    static void swap(Alloc& a, Alloc& b, std::true_type) {
+        mystl::swap(a, b);
+    }
+    static void swap(Alloc&, Alloc&, std::false_type) {
+    }
+
     // using allocator_category = random_access_allocator_tag;
     // using value_type = Iterator;
     // using difference_type = ptrdiff_t;
@@ -91,6 +183,26 @@ struct allocator_traits {
 template <typename T, typename Alloc>
 const bool allocator_traits<T, Alloc>::instanceless_;
 
+/*
+ *@brief 容器保存分配器实例的基类, 无状态的分配器借助空基类优化不占空间
+ */
+template <typename Alloc>
+class allocator_holder : private Alloc {
+public:
+    allocator_holder() = default;
+    explicit allocator_holder(const Alloc& alloc) :
+        Alloc(alloc) {
+    }
+
+    Alloc& get_alloc() noexcept {
+        return *this;
+    }
+
+    const Alloc& get_alloc() const noexcept {
+        return *this;
+    }
+};
+
 } // namespace mystl
 
 #endif // MYSTL_ALLOCATOR_H_
@@ -0,0 +1,248 @@
+#ifndef MYSTL_ARENA_H_
+#define MYSTL_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "construct.h"
+#include "functexcept.h"
+#include "utility.h"
+
+namespace mystl {
+// 单调增长的内存区: 分配只移动指针, 单个对象的释放什么也不做, Reset 时一次性回收全部内存
+// 适合请求处理中构建、用完即整体丢弃的临时容器
+class Arena {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 4096;
+    static constexpr std::size_t MAX_BLOCK_SIZE = 1 << 20;
+
+    explicit Arena(std::size_t blockSize = DEFAULT_BLOCK_SIZE) :
+        initBlockSize_(blockSize), nextBlockSize_(blockSize) {
+    }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() {
+        Release();
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+        unsigned char* p = AlignUp(cur_, align);
+        if (p == nullptr || p + bytes > end_) {
+            NewBlock(bytes + align);
+            p = AlignUp(cur_, align);
+        }
+        cur_ = p + bytes;
+        used_ += bytes;
+        return p;
+    }
+
+    // 保留最近申请的一块内存, 其余全部归还; 之前分配出去的对象全部失效
+    void Reset() {
+        if (head_ == nullptr) {
+            return;
+        }
+        FreeBlocks(head_->next);
+        head_->next = nullptr;
+        cur_ = head_->Data();
+        used_ = 0;
+        nextBlockSize_ = initBlockSize_;
+    }
+
+    // 归还全部内存
+    void Release() {
+        FreeBlocks(head_);
+        head_ = nullptr;
+        cur_ = nullptr;
+        end_ = nullptr;
+        used_ = 0;
+        nextBlockSize_ = initBlockSize_;
+    }
+
+    // 已分配出去的字节数(不含对齐浪费)
+    std::size_t BytesUsed() const {
+        return used_;
+    }
+
+    // 持有的内存块总字节数
+    std::size_t BytesReserved() const {
+        std::size_t bytes = 0;
+        for (Block* block = head_; block != nullptr; block = block->next) {
+            bytes += block->size;
+        }
+        return bytes;
+    }
+
+    // 当前线程 ArenaScope 指定的 Arena, 没有时为 nullptr
+    static Arena* Current() {
+        return CurrentRef();
+    }
+
+private:
+    friend class ArenaScope;
+
+    struct Block {
+        Block* next;
+        std::size_t size;
+
+        unsigned char* Data() {
+            return reinterpret_cast<unsigned char*>(this + 1);
+        }
+    };
+
+    static Arena*& CurrentRef() {
+        static thread_local Arena* current = nullptr;
+        return current;
+    }
+
+    static unsigned char* AlignUp(unsigned char* p, std::size_t align) {
+        const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<unsigned char*>((addr + align - 1) & ~(align - 1));
+    }
+
+    // 块大小按两倍增长到 MAX_BLOCK_SIZE, 超大的请求单独占一块
+    void NewBlock(std::size_t minBytes) {
+        std::size_t size = nextBlockSize_;
+        if (size < minBytes) {
+            size = minBytes;
+        }
+        if (nextBlockSize_ < MAX_BLOCK_SIZE) {
+            nextBlockSize_ *= 2;
+        }
+        Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+        block->next = head_;
+        block->size = size;
+        head_ = block;
+        cur_ = block->Data();
+        end_ = cur_ + size;
+    }
+
+    static void FreeBlocks(Block* block) {
+        while (block != nullptr) {
+            Block* next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+private:
+    Block* head_{nullptr};
+    unsigned char* cur_{nullptr};
+    unsigned char* end_{nullptr};
+    std::size_t used_{0};
+    std::size_t initBlockSize_;
+    std::size_t nextBlockSize_;
+};
+
+// 在作用域内把 arena 设为当前线程的 Arena, 退出时恢复之前的设置, 可以嵌套
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) :
+        prev_(Arena::CurrentRef()) {
+        Arena::CurrentRef() = &arena;
+    }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+    ~ArenaScope() {
+        Arena::CurrentRef() = prev_;
+    }
+
+private:
+    Arena* prev_;
+};
+
+// 从绑定的 Arena 分配内存的分配器, 接口与 mystl::allocator 相同
+// 默认构造时绑定当前线程 ArenaScope 指定的 Arena, 也可以显式指定; 容器须在 Arena Reset/析构之前销毁
+// 移动赋值和 swap 时分配器随内容一起传播, 复制赋值时保留各自的 Arena
+template <typename T>
+class arena_allocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <class U>
+    struct rebind {
+        using other = arena_allocator<U>;
+    };
+
+    arena_allocator() :
+        arena_(Arena::Current()) {
+    }
+    explicit arena_allocator(Arena& arena) :
+        arena_(&arena) {
+    }
+    arena_allocator(const arena_allocator&) = default;
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) :
+        arena_(other.arena()) {
+    }
+    ~arena_allocator() = default;
+
+    Arena* arena() const {
+        return arena_;
+    }
+
+    static pointer address(reference x) {
+        return &x;
+    }
+
+    static const_pointer address(const_reference x) {
+        return &x;
+    }
+
+    pointer allocate(size_type n) {
+        THROW_RUNTIME_ERROR_IF(arena_ == nullptr, "arena_allocator is not bound to an Arena");
+        return static_cast<pointer>(arena_->Allocate(n * sizeof(value_type), alignof(value_type)));
+    }
+
+    // 内存随 Arena 整体回收
+    static void deallocate(pointer) {
+    }
+
+    static void deallocate(pointer, size_type) {
+    }
+
+    static void construct(pointer ptr, const T& value) {
+        mystl::construct<T>(ptr, value);
+    }
+
+    template <typename U, typename... Args>
+    static void construct(U* ptr, Args&&... args) {
+        mystl::construct(ptr, mystl::forward<Args>(args)...);
+    }
+
+    static void destroy(pointer ptr) {
+        mystl::destroy(ptr);
+    }
+
+    static void destroy(pointer first, pointer last) {
+        mystl::destroy(first, last);
+    }
+
+private:
+    Arena* arena_;
+};
+
+template <class T, class U>
+inline bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+    return a.arena() == b.arena();
+}
+
+template <class T, class U>
+inline bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+    return a.arena() != b.arena();
+}
+
+} // namespace mystl
+
+#endif // MYSTL_ARENA_H_
@@ -1,36 +1,351 @@
 #ifndef MYSTL_MY_ALLOCATOR_H_
 #define MYSTL_MY_ALLOCATOR_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 #include "construct.h"
+#include "functexcept.h"
+
+// 为 1 时统计分配器的使用情况, 为 0 时计数代码全部编译掉, 统计接口返回全零
+#ifndef MYSTL_ALLOCATOR_STATS
+#define MYSTL_ALLOCATOR_STATS 0
+#endif
 
 namespace mystl {
-class Chunk {
+// 当前值与峰值, 多线程下用 relaxed 原子操作计数
+class UsageCounter {
+public:
+    void Add(std::size_t n) {
+        const std::size_t cur = cur_.fetch_add(n, std::memory_order_relaxed) + n;
+        std::size_t peak = peak_.load(std::memory_order_relaxed);
+        while (cur > peak && !peak_.compare_exchange_weak(peak, cur, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Sub(std::size_t n) {
+        cur_.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    std::size_t Current() const {
+        return cur_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t Peak() const {
+        return peak_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::size_t> cur_{0};
+    std::atomic<std::size_t> peak_{0};
+};
+
+// 一个尺寸类别(Pool)的统计快照, 字节数均按块大小计算
+struct SizeClassStats {
+    std::size_t blockSize;
+    std::size_t allocCount;     // 累计分配次数
+    std::size_t freeCount;      // 累计释放次数
+    std::size_t liveBytes;      // 用户持有的块
+    std::size_t peakLiveBytes;  // liveBytes 的峰值
+    std::size_t requestedBytes; // 累计请求的字节数, 与 allocCount * blockSize 之差为对齐浪费
+    std::size_t chunkCount;     // 持有的 chunk(slab) 个数
+    std::size_t reservedBytes;  // chunk 中可切成块的字节数
+};
+
+// MyAllocator 的统计快照, 由 MyAllocator::GetStats 填写
+struct AllocatorStats {
+    static constexpr std::size_t MAX_SIZE_CLASS = 256;
+
+    bool enabled;
+    double elapsedSeconds;         // 分配器创建以来的秒数, 用于计算分配/释放速率
+    std::size_t largeAllocCount;   // 超过 BLOCK_SIZE, 转交 operator new 的次数
+    std::size_t largeFreeCount;
+    std::size_t largeAllocBytes;   // 转交 operator new 的累计字节数
+    std::size_t liveBytes;         // 所有 Pool 中用户持有的字节数
+    std::size_t peakLiveBytes;
+    std::size_t reservedBytes;     // 所有 Pool 的 chunk 可用字节数
+    std::size_t mappedBytes;       // SlabHeap 向操作系统映射的字节数
+    std::size_t freeSlabCount;     // SlabHeap 中空闲待复用的 slab
+    std::size_t releasedSlabCount; // 已还给操作系统、只保留地址空间的 slab
+    std::size_t sizeClassNum;
+    SizeClassStats sizeClasses[MAX_SIZE_CLASS];
+
+    std::size_t AllocCount() const {
+        std::size_t n = largeAllocCount;
+        for (std::size_t i = 0; i < sizeClassNum; ++i) {
+            n += sizeClasses[i].allocCount;
+        }
+        return n;
+    }
+
+    std::size_t FreeCount() const {
+        std::size_t n = largeFreeCount;
+        for (std::size_t i = 0; i < sizeClassNum; ++i) {
+            n += sizeClasses[i].freeCount;
+        }
+        return n;
+    }
+
+    // chunk 中没有被用户持有的比例, 包括线程缓存中的块和尚未切出的块
+    double Fragmentation() const {
+        return reservedBytes == 0U ? 0.0 : 1.0 - static_cast<double>(liveBytes) / static_cast<double>(reservedBytes);
+    }
+
+    // 只输出用过的尺寸类别
+    std::string ToText() const {
+        std::ostringstream os;
+        os << "allocator stats" << (enabled ? "" : " (disabled)") << ": elapsed " << elapsedSeconds << "s\n"
+           << "  alloc " << AllocCount() << " (" << Rate(AllocCount()) << "/s), free " << FreeCount()
+           << " (" << Rate(FreeCount()) << "/s)\n"
+           << "  pool live " << liveBytes << "B, peak " << peakLiveBytes << "B, reserved " << reservedBytes
+           << "B, fragmentation " << Fragmentation() << "\n"
+           << "  slab mapped " << mappedBytes << "B, free slabs " << freeSlabCount << ", released slabs "
+           << releasedSlabCount << "\n"
+           << "  large alloc " << largeAllocCount << " (" << largeAllocBytes << "B), free " << largeFreeCount << "\n";
+        for (std::size_t i = 0; i < sizeClassNum; ++i) {
+            const SizeClassStats& c = sizeClasses[i];
+            if (c.allocCount == 0U && c.chunkCount == 0U) {
+                continue;
+            }
+            os << "  [" << c.blockSize << "B] alloc " << c.allocCount << ", free " << c.freeCount << ", live "
+               << c.liveBytes << "B, peak " << c.peakLiveBytes << "B, requested " << c.requestedBytes << "B, chunks "
+               << c.chunkCount << "\n";
+        }
+        return os.str();
+    }
+
+    std::string ToJson() const {
+        std::ostringstream os;
+        os << "{\"enabled\":" << (enabled ? "true" : "false") << ",\"elapsed_seconds\":" << elapsedSeconds
+           << ",\"alloc_count\":" << AllocCount() << ",\"free_count\":" << FreeCount()
+           << ",\"live_bytes\":" << liveBytes << ",\"peak_live_bytes\":" << peakLiveBytes
+           << ",\"reserved_bytes\":" << reservedBytes << ",\"fragmentation\":" << Fragmentation()
+           << ",\"mapped_bytes\":" << mappedBytes << ",\"free_slab_count\":" << freeSlabCount
+           << ",\"released_slab_count\":" << releasedSlabCount
+           << ",\"large_alloc_count\":" << largeAllocCount << ",\"large_free_count\":" << largeFreeCount
+           << ",\"large_alloc_bytes\":" << largeAllocBytes << ",\"size_classes\":[";
+        bool first = true;
+        for (std::size_t i = 0; i < sizeClassNum; ++i) {
+            const SizeClassStats& c = sizeClasses[i];
+            if (c.allocCount == 0U && c.chunkCount == 0U) {
+                continue;
+            }
+            os << (first ? "" : ",") << "{\"block_size\":" << c.blockSize << ",\"alloc_count\":" << c.allocCount
+               << ",\"free_count\":" << c.freeCount << ",\"live_bytes\":" << c.liveBytes
+               << ",\"peak_live_bytes\":" << c.peakLiveBytes << ",\"requested_bytes\":" << c.requestedBytes
+               << ",\"chunk_count\":" << c.chunkCount << ",\"reserved_bytes\":" << c.reservedBytes << "}";
+            first = false;
+        }
+        os << "]}";
+        return os.str();
+    }
+
+private:
+    double Rate(std::size_t count) const {
+        return elapsedSeconds > 0.0 ? static_cast<double>(count) / elapsedSeconds : 0.0;
+    }
+};
+
+// 向操作系统成块映射内存(每次 REGION_BYTES), 再切成按 SLAB_BYTES 对齐的 slab 供 Chunk 使用
+// 释放的 slab 挂到空闲链表上复用; 空闲 slab 超过 maxFreeSlabs_ 或调用 Trim 时,
+// 多出的 slab 把物理内存还给操作系统(madvise/VirtualFree), 地址空间保留, 之后仍可复用
+class SlabHeap {
 public:
-    Chunk(unsigned char blockNum, std::size_t blockSize) {
-        if (blockNum != 0U && blockSize != 0U) {
-            pBlocks_ = new unsigned char[blockNum * blockSize];
-            Reset(blockNum, blockSize);
+    static constexpr std::size_t SLAB_BITS = 16;
+    static constexpr std::size_t SLAB_BYTES = std::size_t(1) << SLAB_BITS;
+    static constexpr std::size_t REGION_BYTES = 64 * SLAB_BYTES;
+    static constexpr std::size_t DEFAULT_MAX_FREE_SLABS = REGION_BYTES / SLAB_BYTES;
+
+    SlabHeap() = default;
+    SlabHeap(const SlabHeap&) = delete;
+    SlabHeap& operator=(const SlabHeap&) = delete;
+
+    unsigned char* Allocate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (freeList_ != nullptr) {
+            unsigned char* slab = freeList_;
+            std::memcpy(&freeList_, slab, sizeof(freeList_));
+            --freeSlabs_;
+            return slab;
+        }
+        if (!releasedSlabs_.empty()) {
+            unsigned char* slab = releasedSlabs_.back();
+            releasedSlabs_.pop_back();
+            Commit(slab);
+            return slab;
+        }
+        if (regionCur_ == regionEnd_) {
+            regionCur_ = MapRegion();
+            regionEnd_ = regionCur_ + REGION_BYTES;
+            mappedBytes_ += REGION_BYTES;
+        }
+        unsigned char* slab = regionCur_;
+        regionCur_ += SLAB_BYTES;
+        return slab;
+    }
+
+    void Deallocate(unsigned char* slab) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (freeSlabs_ >= maxFreeSlabs_) {
+            Release(slab);
+            return;
+        }
+        std::memcpy(slab, &freeList_, sizeof(freeList_));
+        freeList_ = slab;
+        ++freeSlabs_;
+    }
+
+    // 空闲链表只保留 keep 个 slab, 其余还给操作系统, 返回释放的字节数
+    std::size_t Trim(std::size_t keep) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return TrimLocked(keep);
+    }
+
+    // 设置空闲 slab 的上限并立即按新上限收缩
+    void SetMaxFreeSlabs(std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxFreeSlabs_ = n;
+        TrimLocked(n);
+    }
+
+    void FillStats(AllocatorStats& stats) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.mappedBytes = mappedBytes_;
+        stats.freeSlabCount = freeSlabs_;
+        stats.releasedSlabCount = releasedSlabs_.size();
+    }
+
+private:
+    std::size_t TrimLocked(std::size_t keep) {
+        std::size_t released = 0;
+        while (freeSlabs_ > keep) {
+            unsigned char* slab = freeList_;
+            std::memcpy(&freeList_, slab, sizeof(freeList_));
+            --freeSlabs_;
+            Release(slab);
+            released += SLAB_BYTES;
+        }
+        return released;
+    }
+
+    // 物理页还给操作系统后内容失效, 所以 slab 地址记在 releasedSlabs_ 中而不是链在 slab 里
+    void Release(unsigned char* slab) {
+        releasedSlabs_.push_back(slab);
+#ifdef _WIN32
+        ::VirtualFree(slab, SLAB_BYTES, MEM_DECOMMIT);
+#else
+        ::madvise(slab, SLAB_BYTES, MADV_DONTNEED);
+#endif
+    }
+
+    // 重新使用已释放的 slab; MADV_DONTNEED 之后的匿名页再次访问时自动补零页, 无需处理
+    static void Commit(unsigned char* slab) {
+#ifdef _WIN32
+        if (::VirtualAlloc(slab, SLAB_BYTES, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+            throw std::bad_alloc();
         }
+#else
+        (void)slab;
+#endif
     }
-    ~Chunk() {
-        if (pBlocks_ != nullptr) {
-            delete[] pBlocks_;
+
+    // 返回 SLAB_BYTES 对齐的 REGION_BYTES 字节
+    static unsigned char* MapRegion() {
+        const std::size_t bytes = REGION_BYTES + SLAB_BYTES;
+#ifdef _WIN32
+        // VirtualAlloc 不能释放部分区间, 对齐浪费的部分直接保留
+        void* p = ::VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return AlignUp(static_cast<unsigned char*>(p));
+#else
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        // 把对齐多出来的首尾部分还给操作系统
+        unsigned char* raw = static_cast<unsigned char*>(p);
+        unsigned char* aligned = AlignUp(raw);
+        if (aligned != raw) {
+            ::munmap(raw, aligned - raw);
         }
+        unsigned char* tail = aligned + REGION_BYTES;
+        if (tail != raw + bytes) {
+            ::munmap(tail, raw + bytes - tail);
+        }
+        return aligned;
+#endif
+    }
+
+    static unsigned char* AlignUp(unsigned char* p) {
+        const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<unsigned char*>((addr + SLAB_BYTES - 1) & ~(SLAB_BYTES - 1));
+    }
+
+private:
+    unsigned char* freeList_{nullptr};
+    std::size_t freeSlabs_{0};
+    std::size_t maxFreeSlabs_{DEFAULT_MAX_FREE_SLABS};
+    std::vector<unsigned char*> releasedSlabs_;
+    unsigned char* regionCur_{nullptr};
+    unsigned char* regionEnd_{nullptr};
+    std::size_t mappedBytes_{0};
+    std::mutex mutex_;
+};
+
+// 管理一个 slab 中等长的块, 空闲块中存放下一个空闲块的 16 位下标
+// 从未分配过的块不进空闲链表, 按 carvedBlocks_ 顺序切出, 新 slab 不必整块初始化
+class Chunk {
+public:
+    using index_type = std::uint16_t;
+    static constexpr std::size_t MIN_BLOCK_SIZE = sizeof(index_type);
+    static constexpr index_type NO_BLOCK = static_cast<index_type>(-1);
+
+    Chunk(index_type blockNum, std::size_t blockSize, unsigned char* blocks) :
+        blocksAvailable_(blockNum), pBlocks_(blocks) {
+        MYSTL_DEBUG(blocks == nullptr || blockSize >= MIN_BLOCK_SIZE);
+        (void)blockSize;
     }
 
     unsigned char* Allocate(std::size_t blockSize) {
         if (blocksAvailable_ == 0U) {
             return nullptr;
         }
-        unsigned char* result = pBlocks_ + (firstAvailableBlock_ * blockSize);
-        firstAvailableBlock_ = *result;
+        unsigned char* result = nullptr;
+        if (firstAvailableBlock_ != NO_BLOCK) {
+            result = pBlocks_ + (firstAvailableBlock_ * blockSize);
+            std::memcpy(&firstAvailableBlock_, result, sizeof(index_type));
+        } else {
+            result = pBlocks_ + (carvedBlocks_ * blockSize);
+            ++carvedBlocks_;
+        }
         --blocksAvailable_;
         return result;
     }
 
     void Deallocate(unsigned char* ptr, std::size_t blockSize) {
-        *ptr = firstAvailableBlock_;
-        firstAvailableBlock_ = (ptr - pBlocks_) / blockSize;
+        std::memcpy(ptr, &firstAvailableBlock_, sizeof(index_type));
+        firstAvailableBlock_ = static_cast<index_type>((ptr - pBlocks_) / blockSize);
         ++blocksAvailable_;
     }
 
@@ -42,33 +357,26 @@ public:
         return (ptr >= pBlocks_) && (ptr < pBlocks_ + chunkSize);
     }
 
-    bool IsAllBlockFree(unsigned char blockNum_) {
+    bool IsAllBlockFree(index_type blockNum_) {
         return blocksAvailable_ == blockNum_;
     }
 
-private:
-    void Reset(unsigned char blockNum, std::size_t blockSize) {
-        firstAvailableBlock_ = 0;
-        blocksAvailable_ = blockNum;
-
-        unsigned char* p = pBlocks_;
-        for (unsigned char i = 0; i < blockNum; ++i) {
-            *p = (i + 1);
-            p += blockSize;
-        }
+    unsigned char* Data() {
+        return pBlocks_;
     }
 
 private:
-    unsigned char firstAvailableBlock_{0U};
-    unsigned char blocksAvailable_{0U};
+    index_type firstAvailableBlock_{NO_BLOCK};
+    index_type blocksAvailable_{0U};
+    index_type carvedBlocks_{0U};
     unsigned char* pBlocks_{nullptr};
 };
 
 // 双向链表保存Chunk
 class ChunkList {
 public:
-    ChunkList(unsigned char blockNum = 0U, std::size_t blockSize = 0U) :
-        next_(this), prev_(this), chunk_(blockNum, blockSize) {
+    ChunkList(Chunk::index_type blockNum = 0U, std::size_t blockSize = 0U, unsigned char* blocks = nullptr) :
+        next_(this), prev_(this), blockNum_(blockNum), blockSize_(blockSize), chunk_(blockNum, blockSize, blocks) {
     }
 
     unsigned char* Allocate(std::size_t blockSize) {
@@ -83,10 +391,22 @@ public:
         return chunk_.IsAvailable();
     }
 
-    bool IsAllBlockFree(unsigned char blockNum) {
+    bool IsAllBlockFree(Chunk::index_type blockNum) {
         return chunk_.IsAllBlockFree(blockNum);
     }
 
+    bool IsInside(unsigned char* ptr) {
+        return chunk_.IsInside(ptr, blockNum_ * blockSize_);
+    }
+
+    std::size_t BlockSize() const {
+        return blockSize_;
+    }
+
+    unsigned char* Data() {
+        return chunk_.Data();
+    }
+
     void InsertAtTail(ChunkList* p) {
         p->next_ = this;
         p->prev_ = this->prev_;
@@ -110,54 +430,123 @@ public:
         return nullptr;
     }
 
-    ChunkList* FindLocatedChunk(unsigned char* ptr, std::size_t chunkSize) {
-        ChunkList* p = this->next_;
-        while (p != this) {
-            if (p->chunk_.IsInside(ptr, chunkSize)) {
-                return p;
-            }
-            p = p->next_;
-        }
-        return nullptr;
-    }
-
 private:
     ChunkList* next_{nullptr};
     ChunkList* prev_{nullptr};
+    Chunk::index_type blockNum_{0U};
+    std::size_t blockSize_{0U};
     Chunk chunk_;
 };
 
+// slab 号 -> ChunkList 的三级基数树, 释放时根据地址 O(1) 找到所属的 Chunk
+// 只覆盖低 48 位地址空间(32 位平台为全部地址空间), 中间节点按需分配且不回收
+// Get 无锁, 可与其它线程的 Set 并发; Set 之间由 mutex_ 互斥
+class PageMap {
+public:
+    PageMap() = default;
+    PageMap(const PageMap&) = delete;
+    PageMap& operator=(const PageMap&) = delete;
+
+    ChunkList* Get(const void* ptr) const {
+        const std::uintptr_t page = PageNumber(ptr);
+        const Node* node = root_[RootIndex(page)].load(std::memory_order_acquire);
+        if (node == nullptr) {
+            return nullptr;
+        }
+        const Leaf* leaf = node->leaves[NodeIndex(page)].load(std::memory_order_acquire);
+        if (leaf == nullptr) {
+            return nullptr;
+        }
+        return leaf->chunks[LeafIndex(page)].load(std::memory_order_acquire);
+    }
+
+    void Set(const void* ptr, ChunkList* chunk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::uintptr_t page = PageNumber(ptr);
+        Node* node = root_[RootIndex(page)].load(std::memory_order_relaxed);
+        if (node == nullptr) {
+            node = NewZeroed<Node>();
+            root_[RootIndex(page)].store(node, std::memory_order_release);
+        }
+        Leaf* leaf = node->leaves[NodeIndex(page)].load(std::memory_order_relaxed);
+        if (leaf == nullptr) {
+            leaf = NewZeroed<Leaf>();
+            node->leaves[NodeIndex(page)].store(leaf, std::memory_order_release);
+        }
+        leaf->chunks[LeafIndex(page)].store(chunk, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t ADDRESS_BITS = sizeof(void*) == 8U ? 48U : 32U;
+    static constexpr std::size_t KEY_BITS = ADDRESS_BITS - SlabHeap::SLAB_BITS;
+    static constexpr std::size_t NODE_BITS = (KEY_BITS + 2U) / 3U;
+    static constexpr std::size_t LEAF_BITS = KEY_BITS - 2U * NODE_BITS;
+
+    // 节点由 calloc 清零得到, 全零即为空指针的 atomic
+    struct Leaf {
+        std::atomic<ChunkList*> chunks[std::size_t(1) << LEAF_BITS];
+    };
+    struct Node {
+        std::atomic<Leaf*> leaves[std::size_t(1) << NODE_BITS];
+    };
+
+    static std::uintptr_t PageNumber(const void* ptr) {
+        return reinterpret_cast<std::uintptr_t>(ptr) >> SlabHeap::SLAB_BITS;
+    }
+    static std::size_t RootIndex(std::uintptr_t page) {
+        return (page >> (NODE_BITS + LEAF_BITS)) & ((std::size_t(1) << NODE_BITS) - 1U);
+    }
+    static std::size_t NodeIndex(std::uintptr_t page) {
+        return (page >> LEAF_BITS) & ((std::size_t(1) << NODE_BITS) - 1U);
+    }
+    static std::size_t LeafIndex(std::uintptr_t page) {
+        return page & ((std::size_t(1) << LEAF_BITS) - 1U);
+    }
+
+    // 不能经由 MyAllocator 分配, 直接向 C 运行时申请清零的内存
+    template <typename T>
+    static T* NewZeroed() {
+        void* p = std::calloc(1, sizeof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+private:
+    std::atomic<Node*> root_[std::size_t(1) << NODE_BITS]{};
+    std::mutex mutex_;
+};
+
 class Pool {
 public:
-    void Init(std::size_t pageSize, std::size_t blockSize) {
+    void Init(std::size_t slabSize, std::size_t blockSize, PageMap* pageMap, SlabHeap* slabHeap) {
         blockSize_ = blockSize;
-        std::size_t tmpNum = pageSize / blockSize;
-        blockNum_ = tmpNum > MAX_BLOCK_NUM ? MAX_BLOCK_NUM : tmpNum;
+        std::size_t tmpNum = slabSize / blockSize;
+        blockNum_ = tmpNum > MAX_BLOCK_NUM ? MAX_BLOCK_NUM : static_cast<Chunk::index_type>(tmpNum);
         head = new ChunkList(); //
+        pageMap_ = pageMap;
+        slabHeap_ = slabHeap;
     }
 
     unsigned char* Allocate() {
         // 1、chunk已分配还有空间直接从chunk里分配
-        if (allocChunk_ && allocChunk_->IsAvailable()) {
-            return allocChunk_->Allocate(blockSize_);
+        if (allocChunk_ == nullptr || !allocChunk_->IsAvailable()) {
+            // 2、优先复用延迟释放的chunk
+            if (deferChunk_ != nullptr) {
+                allocChunk_ = deferChunk_;
+            } else {
+                // 3、查找有空闲块的chunk, 都没有时新建chunk
+                allocChunk_ = head->FindAvailableChunk();
+                if (allocChunk_ == nullptr) {
+                    allocChunk_ = NewChunk();
+                }
+            }
         }
-
-        // 2、chunk
-        if (deferChunk_ != nullptr) {
-            allocChunk_ = deferChunk_;
+        // 延迟释放的chunk重新投入使用, 不能再被释放
+        if (allocChunk_ == deferChunk_) {
             deferChunk_ = nullptr;
-            return allocChunk_->Allocate(blockSize_);
-        }
-
-        // 找到
-        ChunkList* p = head->FindAvailableChunk();
-        if (p != nullptr) {
-            allocChunk_ = p;
-            return allocChunk_->Allocate(blockSize_);
         }
-        p = new ChunkList(blockNum_, blockSize_);
-        head->InsertAtTail(p);
-        allocChunk_ = p;
         return allocChunk_->Allocate(blockSize_);
     }
 
@@ -167,22 +556,96 @@ public:
         }
         deallocChunk_ = chunk;
         deallocChunk_->Deallocate(ptr, blockSize_);
-        FreeChunk(ptr);
+        FreeChunk();
+    }
+
+    // 记录用户的一次分配/释放, 线程缓存与 Pool 之间的批量搬运不计入
+    void RecordAllocate(std::size_t bytes) {
+#if MYSTL_ALLOCATOR_STATS
+        allocCount_.fetch_add(1U, std::memory_order_relaxed);
+        requestedBytes_.fetch_add(bytes, std::memory_order_relaxed);
+        live_.Add(blockSize_);
+#else
+        (void)bytes;
+#endif
+    }
+
+    void RecordDeallocate() {
+#if MYSTL_ALLOCATOR_STATS
+        freeCount_.fetch_add(1U, std::memory_order_relaxed);
+        live_.Sub(blockSize_);
+#endif
+    }
+
+    void FillStats(SizeClassStats& stats) const {
+        stats = SizeClassStats();
+        stats.blockSize = blockSize_;
+#if MYSTL_ALLOCATOR_STATS
+        stats.allocCount = allocCount_.load(std::memory_order_relaxed);
+        stats.freeCount = freeCount_.load(std::memory_order_relaxed);
+        stats.liveBytes = live_.Current();
+        stats.peakLiveBytes = live_.Peak();
+        stats.requestedBytes = requestedBytes_.load(std::memory_order_relaxed);
+        stats.chunkCount = chunkCount_.load(std::memory_order_relaxed);
+        stats.reservedBytes = stats.chunkCount * blockNum_ * blockSize_;
+#endif
+    }
+
+    // 释放延迟保留的空 chunk
+    void Trim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (deferChunk_ != nullptr) {
+            DeleteChunk(deferChunk_);
+            deferChunk_ = nullptr;
+        }
+    }
+
+    // 加锁后成批分配 n 个块, 供线程缓存批量取用
+    std::size_t AllocateBatch(unsigned char** blocks, std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < n; ++i) {
+            blocks[i] = Allocate();
+        }
+        return n;
     }
 
-    ChunkList* HasBlock(unsigned char* ptr) {
-        const std::size_t chunkSize = blockNum_ * blockSize_;
-        return head->FindLocatedChunk(ptr, chunkSize);
+    // 加锁后成批归还 n 个块
+    void DeallocateBatch(unsigned char* const* blocks, std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < n; ++i) {
+            Deallocate(blocks[i], pageMap_->Get(blocks[i]));
+        }
     }
 
 private:
-    void FreeChunk(unsigned char* ptr) {
+    ChunkList* NewChunk() {
+        ChunkList* p = new ChunkList(blockNum_, blockSize_, slabHeap_->Allocate());
+        head->InsertAtTail(p);
+        pageMap_->Set(p->Data(), p);
+#if MYSTL_ALLOCATOR_STATS
+        chunkCount_.fetch_add(1U, std::memory_order_relaxed);
+#endif
+        return p;
+    }
+
+    void DeleteChunk(ChunkList* p) {
+        if (allocChunk_ == p) {
+            allocChunk_ = nullptr;
+        }
+        pageMap_->Set(p->Data(), nullptr);
+        head->Remove(p);
+        slabHeap_->Deallocate(p->Data());
+        delete p;
+#if MYSTL_ALLOCATOR_STATS
+        chunkCount_.fetch_sub(1U, std::memory_order_relaxed);
+#endif
+    }
+
+    void FreeChunk() {
         // 判断是否是全回收, 保证有两块全回收时才真正释放延迟一块的内存
         if (deallocChunk_->IsAllBlockFree(blockNum_)) {
             if (deferChunk_ != nullptr && deferChunk_ != deallocChunk_) {
-                deferChunk_->Deallocate(ptr, blockSize_);
-                head->Remove(deferChunk_);
-                delete deferChunk_;
+                DeleteChunk(deferChunk_);
             }
             deferChunk_ = deallocChunk_;
             deallocChunk_ = nullptr;
@@ -190,55 +653,282 @@ private:
     }
 
 private:
-    unsigned char blockNum_{0};
+    Chunk::index_type blockNum_{0};
     std::size_t blockSize_{0};
 
     ChunkList* head{nullptr};
     ChunkList* allocChunk_{nullptr};
     ChunkList* deallocChunk_{nullptr};
     ChunkList* deferChunk_{nullptr};
-    static constexpr unsigned char MAX_BLOCK_NUM = static_cast<unsigned char>(-1);
+    PageMap* pageMap_{nullptr};
+    SlabHeap* slabHeap_{nullptr};
+    std::mutex mutex_;
+#if MYSTL_ALLOCATOR_STATS
+    std::atomic<std::size_t> allocCount_{0};
+    std::atomic<std::size_t> freeCount_{0};
+    std::atomic<std::size_t> requestedBytes_{0};
+    std::atomic<std::size_t> chunkCount_{0};
+    UsageCounter live_;
+#endif
+    // NO_BLOCK 不能作为块下标
+    static constexpr Chunk::index_type MAX_BLOCK_NUM = Chunk::NO_BLOCK;
 };
 
 class MyAllocator {
 public:
+    // 超过 BLOCK_SIZE 的请求直接交给 operator new
+    static constexpr std::size_t BLOCK_SIZE = 256;
+
     static MyAllocator* GetInstance() {
         static MyAllocator* alloc = new MyAllocator();
         return alloc;
     }
 
-    // 分配内存，如果大于块大小，使用operator new申请，否则通过内存池申请
+    // 分配内存，如果大于块大小，使用operator new申请，否则先从线程缓存取, 缓存空时再成批向内存池申请
     unsigned char* Allocate(std::size_t bytes) {
         if (bytes > BLOCK_SIZE) {
+#if MYSTL_ALLOCATOR_STATS
+            largeAllocCount_.fetch_add(1U, std::memory_order_relaxed);
+            largeAllocBytes_.fetch_add(bytes, std::memory_order_relaxed);
+#endif
             return static_cast<unsigned char*>(::operator new(bytes));
         }
+        const std::size_t index = PoolIndex(bytes);
+        pools_[index].RecordAllocate(bytes);
+#if MYSTL_ALLOCATOR_STATS
+        live_.Add((index + 1U) * ALIGN_SIZE);
+#endif
+        ThreadCache* cache = ThreadCache::GetInstance();
+        if (cache == nullptr) {
+            unsigned char* ptr = nullptr;
+            pools_[index].AllocateBatch(&ptr, 1);
+            return ptr;
+        }
+        return cache->Allocate(pools_[index], index);
+    }
 
-        std::size_t loc = bytes - 1; // RoundUp(bytes) / ALIGN_SIZE - 1;
-        Pool& pool = pools_[loc];
-        return pool.Allocate();
+    // 按 align(2 的幂)对齐分配; 必须用 DeallocateAligned 以相同的 bytes 和 align 释放
+    // 小块把尺寸补齐到 align 的倍数后直接从 Pool 分配, 大块在 operator new 之上手动对齐
+    unsigned char* AllocateAligned(std::size_t bytes, std::size_t align) {
+        MYSTL_DEBUG(align != 0U && (align & (align - 1U)) == 0U);
+        if (align <= ALIGN_SIZE) {
+            return Allocate(bytes);
+        }
+        const std::size_t size = AlignUp(bytes, align);
+        if (size <= BLOCK_SIZE) {
+            return Allocate(size);
+        }
+        if (align <= alignof(std::max_align_t)) {
+            return Allocate(bytes);
+        }
+#if MYSTL_ALLOCATOR_STATS
+        largeAllocCount_.fetch_add(1U, std::memory_order_relaxed);
+        largeAllocBytes_.fetch_add(bytes, std::memory_order_relaxed);
+#endif
+        // 对齐地址前面存放 operator new 返回的原始地址
+        unsigned char* raw = static_cast<unsigned char*>(::operator new(bytes + align + sizeof(void*)));
+        unsigned char* ptr = reinterpret_cast<unsigned char*>(
+            AlignUp(reinterpret_cast<std::uintptr_t>(raw + sizeof(void*)), align));
+        std::memcpy(ptr - sizeof(void*), &raw, sizeof(void*));
+        return ptr;
+    }
+
+    void DeallocateAligned(unsigned char* ptr, std::size_t bytes, std::size_t align) {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (align <= ALIGN_SIZE) {
+            Deallocate(ptr, bytes);
+            return;
+        }
+        const std::size_t size = AlignUp(bytes, align);
+        if (size <= BLOCK_SIZE) {
+            Deallocate(ptr, size);
+            return;
+        }
+        if (align <= alignof(std::max_align_t)) {
+            Deallocate(ptr, bytes);
+            return;
+        }
+        unsigned char* raw = nullptr;
+        std::memcpy(&raw, ptr - sizeof(void*), sizeof(void*));
+        DeallocateLarge(raw);
     }
 
+    // 不带尺寸的释放, 通过页表找到所属的 Chunk, 找不到则是 operator new 申请的大块内存
     void Deallocate(unsigned char* ptr) {
         if (ptr == nullptr) {
             return;
         }
 
-        ChunkList* chunk = nullptr;
-        std::size_t i = 0;
-        for (; i < POOL_SIZE; ++i) {
-            chunk = pools_[i].HasBlock(ptr);
-            if (chunk != nullptr) {
-                pools_[i].Deallocate(ptr, chunk);
-                return;
+        ChunkList* chunk = pageMap_.Get(ptr);
+        if (chunk != nullptr && chunk->IsInside(ptr)) {
+            DeallocateSmall(ptr, PoolIndex(chunk->BlockSize()));
+            return;
+        }
+        DeallocateLarge(ptr);
+    }
+
+    // 带尺寸的释放, bytes 必须与分配时一致, 大块内存不必查页表
+    void Deallocate(unsigned char* ptr, std::size_t bytes) {
+        if (ptr == nullptr) {
+            return;
+        }
+        if (bytes > BLOCK_SIZE) {
+            DeallocateLarge(ptr);
+            return;
+        }
+
+        MYSTL_DEBUG(pageMap_.Get(ptr) != nullptr && pageMap_.Get(ptr)->BlockSize() == (PoolIndex(bytes) + 1) * ALIGN_SIZE);
+        DeallocateSmall(ptr, PoolIndex(bytes));
+    }
+
+    // 把空闲内存还给操作系统, 返回还回去的 slab 字节数:
+    // 当前线程缓存的块还给 Pool, 各 Pool 释放延迟保留的空 chunk, SlabHeap 只保留 keepSlabs 个空闲 slab,
+    // 最后让 C 运行时收缩 operator new 的堆; 其它线程缓存中的块不受影响
+    std::size_t Trim(std::size_t keepSlabs = 0) {
+        ThreadCache* cache = ThreadCache::GetInstance();
+        if (cache != nullptr) {
+            cache->Flush();
+        }
+        for (std::size_t i = 0; i < POOL_SIZE; ++i) {
+            pools_[i].Trim();
+        }
+        const std::size_t released = slabHeap_.Trim(keepSlabs);
+#ifdef __GLIBC__
+        ::malloc_trim(0);
+#endif
+        return released;
+    }
+
+    // 空闲 slab 的上限, 超过时释放的 slab 直接把物理内存还给操作系统; 默认保留一个 region
+    void SetMaxFreeSlabs(std::size_t n) {
+        slabHeap_.SetMaxFreeSlabs(n);
+    }
+
+    // 统计快照; 各计数器分别读取, 并发分配时快照内部不保证完全一致
+    AllocatorStats GetStats() {
+        AllocatorStats stats = AllocatorStats();
+        stats.enabled = MYSTL_ALLOCATOR_STATS != 0;
+        stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+        stats.sizeClassNum = POOL_SIZE;
+        for (std::size_t i = 0; i < POOL_SIZE; ++i) {
+            SizeClassStats& c = stats.sizeClasses[i];
+            pools_[i].FillStats(c);
+            stats.liveBytes += c.liveBytes;
+            stats.reservedBytes += c.reservedBytes;
+        }
+#if MYSTL_ALLOCATOR_STATS
+        stats.peakLiveBytes = live_.Peak();
+        stats.largeAllocCount = largeAllocCount_.load(std::memory_order_relaxed);
+        stats.largeFreeCount = largeFreeCount_.load(std::memory_order_relaxed);
+        stats.largeAllocBytes = largeAllocBytes_.load(std::memory_order_relaxed);
+        slabHeap_.FillStats(stats);
+#endif
+        return stats;
+    }
+
+private:
+    // 块大小是 ALIGN_SIZE 的倍数, 且 slab 按 SLAB_BYTES 对齐,
+    // 所以大小为 2^k 倍数的块地址也按 2^k 对齐, sizeof(T) 的整数倍总能满足 alignof(T)
+    static constexpr std::size_t ALIGN_SIZE = 8;
+    static constexpr std::size_t CHUNK_SIZE = SlabHeap::SLAB_BYTES;
+    static constexpr std::size_t POOL_SIZE = BLOCK_SIZE / ALIGN_SIZE;
+    static constexpr std::size_t MAGAZINE_SIZE = 16;
+    static constexpr std::size_t BATCH_SIZE = MAGAZINE_SIZE / 2;
+
+    // 每个线程一份的块缓存, 每个尺寸一个弹匣(magazine), 分配和释放只操作本线程的弹匣, 无需加锁;
+    // 弹匣空时向 Pool 成批申请 BATCH_SIZE 个块, 满时把最早放入的 BATCH_SIZE 个块成批还给 Pool
+    class ThreadCache {
+    public:
+        // 线程退出、缓存析构之后返回 nullptr, 调用方直接操作 Pool
+        static ThreadCache* GetInstance() {
+            if (Destroyed()) {
+                return nullptr;
             }
+            static thread_local ThreadCache cache;
+            return &cache;
         }
+
+        ~ThreadCache() {
+            Flush();
+            Destroyed() = true;
+        }
+
+        // 缓存的块全部还给 Pool
+        void Flush() {
+            for (std::size_t i = 0; i < POOL_SIZE; ++i) {
+                Magazine& mag = magazines_[i];
+                if (mag.count != 0U) {
+                    mag.pool->DeallocateBatch(mag.blocks, mag.count);
+                    mag.count = 0U;
+                }
+            }
+        }
+
+        unsigned char* Allocate(Pool& pool, std::size_t index) {
+            Magazine& mag = magazines_[index];
+            if (mag.count == 0U) {
+                mag.pool = &pool;
+                mag.count = pool.AllocateBatch(mag.blocks, BATCH_SIZE);
+            }
+            return mag.blocks[--mag.count];
+        }
+
+        void Deallocate(Pool& pool, std::size_t index, unsigned char* ptr) {
+            Magazine& mag = magazines_[index];
+            if (mag.count == MAGAZINE_SIZE) {
+                pool.DeallocateBatch(mag.blocks, BATCH_SIZE);
+                std::memmove(mag.blocks, mag.blocks + BATCH_SIZE, (MAGAZINE_SIZE - BATCH_SIZE) * sizeof(unsigned char*));
+                mag.count -= BATCH_SIZE;
+            }
+            mag.pool = &pool;
+            mag.blocks[mag.count++] = ptr;
+        }
+
+    private:
+        ThreadCache() = default;
+
+        // 平凡析构的 thread_local 在 ThreadCache 析构后仍然可用
+        static bool& Destroyed() {
+            static thread_local bool destroyed = false;
+            return destroyed;
+        }
+
+        struct Magazine {
+            Pool* pool;
+            std::size_t count;
+            unsigned char* blocks[MAGAZINE_SIZE];
+        };
+
+        Magazine magazines_[POOL_SIZE]{};
+    };
+
+    void DeallocateLarge(unsigned char* ptr) {
+#if MYSTL_ALLOCATOR_STATS
+        largeFreeCount_.fetch_add(1U, std::memory_order_relaxed);
+#endif
         ::operator delete(ptr);
     }
 
-private:
-    MyAllocator() {
+    void DeallocateSmall(unsigned char* ptr, std::size_t index) {
+        pools_[index].RecordDeallocate();
+#if MYSTL_ALLOCATOR_STATS
+        live_.Sub((index + 1U) * ALIGN_SIZE);
+#endif
+        ThreadCache* cache = ThreadCache::GetInstance();
+        if (cache == nullptr) {
+            pools_[index].DeallocateBatch(&ptr, 1);
+            return;
+        }
+        cache->Deallocate(pools_[index], index, ptr);
+    }
+
+    MyAllocator() :
+        startTime_(std::chrono::steady_clock::now()) {
+        static_assert(POOL_SIZE <= AllocatorStats::MAX_SIZE_CLASS, "too many size classes for AllocatorStats");
         for (std::size_t i = 0; i < POOL_SIZE; i++) {
-            pools_[i].Init(CHUNK_SIZE, (i + 1) * ALIGN_SIZE);
+            pools_[i].Init(CHUNK_SIZE, (i + 1) * ALIGN_SIZE, &pageMap_, &slabHeap_);
         }
     }
     ~MyAllocator() = default;
@@ -247,12 +937,26 @@ private:
         return (((bytes) + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1));
     }
 
-private:
-    static constexpr std::size_t ALIGN_SIZE = 1;
-    static constexpr std::size_t BLOCK_SIZE = 256;
-    static constexpr std::size_t CHUNK_SIZE = 4096;
-    static constexpr std::size_t POOL_SIZE = BLOCK_SIZE / ALIGN_SIZE;
+    static std::size_t AlignUp(std::size_t bytes, std::size_t align) {
+        return (bytes + align - 1) & ~(align - 1);
+    }
+
+    // 0 字节的请求按最小的尺寸类别处理
+    static std::size_t PoolIndex(std::size_t bytes) {
+        static_assert(ALIGN_SIZE >= Chunk::MIN_BLOCK_SIZE, "free blocks must hold a block index");
+        return RoundUp(bytes == 0U ? std::size_t(1) : bytes) / ALIGN_SIZE - 1;
+    }
+
     Pool pools_[POOL_SIZE];
+    PageMap pageMap_;
+    SlabHeap slabHeap_;
+    std::chrono::steady_clock::time_point startTime_;
+#if MYSTL_ALLOCATOR_STATS
+    std::atomic<std::size_t> largeAllocCount_{0};
+    std::atomic<std::size_t> largeFreeCount_{0};
+    std::atomic<std::size_t> largeAllocBytes_{0};
+    UsageCounter live_;
+#endif
 };
 
 } // namespace mystl
@@ -1,8 +1,11 @@
 #ifndef MYSTL_UNINITIALIZED_H_
 #define MYSTL_UNINITIALIZED_H_
 
+#include <cstring>
+#include <memory>
 #include <type_traits>
 #include "algorithm.h"
+#include "construct.h"
 
 namespace mystl {
 
@@ -49,6 +52,22 @@ ForwardIterator uninitialized_move_aux(InputIterator first, InputIterator last,
     return cur;
 }
 
+template <typename T>
+T* uninitialized_relocate_aux(T* first, T* last, T* result, std::true_type) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n != 0U) {
+        std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+    }
+    return result + n;
+}
+
+template <typename T>
+T* uninitialized_relocate_aux(T* first, T* last, T* result, std::false_type) {
+    T* cur = mystl::uninitialized_move_aux(first, last, result, std::false_type());
+    mystl::destroy(first, last);
+    return cur;
+}
+
 template <typename ForwardIterator, typename T>
 void uninitialized_fill_aux(ForwardIterator first, ForwardIterator last, const T& val, std::true_type) {
     return mystl::fill(first, last, val);
@@ -86,31 +105,77 @@ ForwardIterator uninitialized_fill_n_aux(ForwardIterator first, Size n, const T&
     }
     return cur;
 }
+
+template <typename ForwardIterator, typename Size>
+ForwardIterator uninitialized_default_construct_n_aux(ForwardIterator first, Size n, std::true_type) {
+    return first + n;
+}
+
+template <typename ForwardIterator, typename Size>
+ForwardIterator uninitialized_default_construct_n_aux(ForwardIterator first, Size n, std::false_type) {
+    using value_type = typename iterator_traits<ForwardIterator>::value_type;
+    ForwardIterator cur = first;
+    try {
+        for (; n--; ++cur) {
+            ::new (static_cast<void*>(&*cur)) value_type;
+        }
+    } catch (...) {
+        mystl::destroy(first, cur);
+        throw;
+    }
+    return cur;
+}
+// 平凡复制的类型在未初始化内存上构造等同于赋值, 交给 copy/move/fill, 指针区间会降为 memmove/memset
+template <typename ForwardIterator>
+using construct_is_assign = std::integral_constant<
+    bool, std::is_trivially_copyable<typename iterator_traits<ForwardIterator>::value_type>::value
+              && std::is_copy_assignable<typename iterator_traits<ForwardIterator>::value_type>::value>;
 } // namespace
 
 template <typename InputIterator, typename ForwardIterator>
 ForwardIterator uninitialized_copy(InputIterator first, InputIterator last,
                                    ForwardIterator result) {
-    return uninitialized_copy_aux(
-        first, last, result, std::is_pod<typename iterator_traits<ForwardIterator>::value_type>());
+    return uninitialized_copy_aux(first, last, result, construct_is_assign<ForwardIterator>());
 }
 
 template <typename ForwardIterator, typename T>
 void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& val) {
-    return uninitialized_fill_aux(
-        first, last, val, std::is_pod<typename iterator_traits<ForwardIterator>::value_type>());
+    return uninitialized_fill_aux(first, last, val, construct_is_assign<ForwardIterator>());
 }
 
 template <typename ForwardIterator, typename Size, typename T>
 ForwardIterator uninitialized_fill_n(ForwardIterator first, Size n, const T& val) {
-    return uninitialized_fill_n_aux(first, n, val, std::is_pod<T>());
+    return uninitialized_fill_n_aux(first, n, val, construct_is_assign<ForwardIterator>());
 }
 
 template <typename InputIterator, typename ForwardIterator>
 ForwardIterator uninitialized_move(InputIterator first, InputIterator last,
                                    ForwardIterator result) {
-    return uninitialized_move_aux(
-        first, last, result, std::is_pod<typename iterator_traits<ForwardIterator>::value_type>());
+    return uninitialized_move_aux(first, last, result, construct_is_assign<ForwardIterator>());
+}
+
+// 默认初始化 n 个对象: 平凡类型什么也不做, 内存中保留原来的内容
+template <typename ForwardIterator, typename Size>
+ForwardIterator uninitialized_default_construct_n(ForwardIterator first, Size n) {
+    return uninitialized_default_construct_n_aux(
+        first, n, std::is_trivially_default_constructible<typename iterator_traits<ForwardIterator>::value_type>());
+}
+
+// 可平凡重定位: 把对象按字节搬到新地址并且不再析构旧对象, 效果等同于移动构造后析构旧对象
+// 平凡可复制的类型都满足; 其它类型(比如只持有指针、不记录自身地址的句柄类)可以特化为 true_type
+template <typename T>
+struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+// unique_ptr 只持有指针和删除器, 删除器可重定位时整体可重定位
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+// 把 [first, last) 的对象搬到未初始化的 result 处, 之后源区间视为未初始化, 不再析构
+// 可平凡重定位时为一次 memmove, 允许源和目标重叠; 否则逐个移动构造再析构源对象, 此时不允许重叠,
+// 移动构造抛出异常时已构造的目标对象被析构, 源对象保持有效
+template <typename T>
+T* uninitialized_relocate(T* first, T* last, T* result) {
+    return uninitialized_relocate_aux(first, last, result, is_trivially_relocatable<T>());
 }
 
 } // namespace mystl
@@ -0,0 +1,301 @@
+#ifndef MYSTL_BTREE_MAP_H_
+#define MYSTL_BTREE_MAP_H_
+
+#include "allocator.h"
+#include "iterator.h"
+#include "functional.h"
+#include "functexcept.h"
+#include "btree.h"
+#include "utility.h"
+
+namespace mystl {
+/*
+ * btree_map: 接口与 map 相同, 底层为 B+ 树 (见 btree.h), 元素放在约 NodeSize 字节的结点里
+ * 与 map 的区别: 插入和删除之后所有迭代器和元素的引用都失效; 元素在结点间搬动, 要求可移动构造
+ */
+template <typename Key, typename Tp, typename Compare = mystl::less<Key>,
+          typename Alloc = mystl::allocator<mystl::pair<const Key, Tp>>, std::size_t NodeSize = 256>
+class btree_map {
+public: // member types
+    using allocator_type = Alloc;
+    using key_type = Key;
+    using mapped_type = Tp;
+    using key_compare = Compare;
+    using value_type = mystl::pair<const Key, Tp>;
+
+private:
+    using pair_alloc_type = typename mystl::allocator_traits<value_type, Alloc>::allocator_type;
+    using rep_type = mystl::btree<key_type, value_type, mystl::select1st<value_type>, key_compare, pair_alloc_type, NodeSize>;
+    rep_type tree_;
+
+public:
+    using pointer = typename rep_type::pointer;
+    using const_pointer = typename rep_type::const_pointer;
+    using reference = typename rep_type::reference;
+    using const_reference = typename rep_type::const_reference;
+    using size_type = typename rep_type::size_type;
+    using difference_type = typename rep_type::difference_type;
+
+    using iterator = typename rep_type::iterator;
+    using const_iterator = typename rep_type::const_iterator;
+    using reverse_iterator = typename rep_type::reverse_iterator;
+    using const_reverse_iterator = typename rep_type::const_reverse_iterator;
+
+public:
+    class value_compare : public mystl::binary_function<value_type, value_type, bool> {
+        friend class btree_map<Key, Tp, Compare, Alloc, NodeSize>;
+
+    protected:
+        Compare comp;
+        value_compare(Compare c) :
+            comp(c) {
+        }
+
+    public:
+        bool operator()(const value_type& x, const value_type& y) const {
+            return comp(x.first, y.first);
+        }
+    };
+
+public: // member functions
+    /*
+     * @brief Constructor and Destructor
+     */
+    // empty(1)
+    explicit btree_map(const key_compare& comp = key_compare(),
+                       const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+    }
+    explicit btree_map(const allocator_type& alloc) :
+        tree_(pair_alloc_type(alloc)) {
+    }
+    // range(2)
+    template <class InputIterator>
+    btree_map(InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+        tree_.insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    btree_map(sorted_unique_t, InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+        tree_.insert_range_unique(first, last);
+    }
+    // copy(3)
+    btree_map(const btree_map& x) = default;
+    btree_map(const btree_map& x, const allocator_type& alloc) :
+        tree_(x.tree_, pair_alloc_type(alloc)) {
+    }
+    // move(4)
+    btree_map(btree_map&& x) = default;
+    btree_map(btree_map&& x, const allocator_type& alloc) :
+        tree_(mystl::move(x.tree_), pair_alloc_type(alloc)) {
+    }
+    // initializer list(5)
+    btree_map(std::initializer_list<value_type> il,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    ~btree_map() = default;
+
+    btree_map& operator=(const btree_map& x) = default;
+    btree_map& operator=(btree_map&& x) = default;
+    btree_map& operator=(std::initializer_list<value_type> il) {
+        tree_.assign_unique(il.begin(), il.end());
+        return *this;
+    }
+
+    key_compare key_comp() const {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const {
+        return value_compare(tree_.key_comp());
+    }
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(tree_.get_allocator());
+    }
+
+    /*
+     * @brief Iterators
+     */
+    iterator begin() noexcept {
+        return tree_.begin();
+    }
+    const_iterator begin() const noexcept {
+        return tree_.begin();
+    }
+    iterator end() noexcept {
+        return tree_.end();
+    }
+    const_iterator end() const noexcept {
+        return tree_.end();
+    }
+    reverse_iterator rbegin() noexcept {
+        return tree_.rbegin();
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return tree_.rbegin();
+    }
+    reverse_iterator rend() noexcept {
+        return tree_.rend();
+    }
+    const_reverse_iterator rend() const noexcept {
+        return tree_.rend();
+    }
+    const_iterator cbegin() const noexcept {
+        return tree_.begin();
+    }
+    const_iterator cend() const noexcept {
+        return tree_.end();
+    }
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    /*
+     * @brief Capacity
+     */
+    bool empty() const noexcept {
+        return tree_.empty();
+    }
+    size_type size() const noexcept {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept {
+        return tree_.max_size();
+    }
+
+    /*
+     * @brief Element access
+     */
+    mapped_type& operator[](const key_type& k) {
+        iterator i = lower_bound(k);
+        if (i == end() || key_comp()(k, (*i).first)) {
+            i = tree_.insert_unique(value_type(k, mapped_type())).first;
+        }
+        return (*i).second;
+    }
+    mapped_type& at(const key_type& k) {
+        iterator i = find(k);
+        THROW_OUT_OF_RANGE_IF(i == end(), "btree_map::at");
+        return (*i).second;
+    }
+    const mapped_type& at(const key_type& k) const {
+        const_iterator i = find(k);
+        THROW_OUT_OF_RANGE_IF(i == end(), "btree_map::at");
+        return (*i).second;
+    }
+
+    /*
+     * @brief Modifiers
+     */
+    // single element (1)
+    mystl::pair<iterator, bool> insert(const value_type& val) {
+        return tree_.insert_unique(val);
+    }
+    mystl::pair<iterator, bool> insert(value_type&& val) {
+        return tree_.insert_unique(mystl::move(val));
+    }
+    // with hint (2)
+    iterator insert(const_iterator position, const value_type& val) {
+        return tree_.insert_unique(position, val);
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return tree_.insert_unique(position, mystl::move(val));
+    }
+    // range (3)
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(first, last);
+    }
+    // initializer list (4)
+    void insert(std::initializer_list<value_type> il) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& k) {
+        return tree_.erase(k);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        return tree_.erase(first, last);
+    }
+
+    void swap(btree_map& x) {
+        tree_.swap(x.tree_);
+    }
+
+    void clear() noexcept {
+        tree_.clear();
+    }
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace(Args&&... args) {
+        return tree_.emplace_unique(mystl::forward<Args>(args)...);
+    }
+    template <class... Args>
+    iterator emplace_hint(const_iterator position, Args&&... args) {
+        return tree_.emplace_hint_unique(position, mystl::forward<Args>(args)...);
+    }
+
+    /*
+     * @brief Operations
+     */
+    iterator find(const key_type& k) {
+        return tree_.find(k);
+    }
+    const_iterator find(const key_type& k) const {
+        return tree_.find(k);
+    }
+    size_type count(const key_type& k) const {
+        return tree_.find(k) == tree_.end() ? 0 : 1;
+    }
+    bool contains(const key_type& k) const {
+        return tree_.find(k) != tree_.end();
+    }
+    iterator lower_bound(const key_type& k) {
+        return tree_.lower_bound(k);
+    }
+    const_iterator lower_bound(const key_type& k) const {
+        return tree_.lower_bound(k);
+    }
+    iterator upper_bound(const key_type& k) {
+        return tree_.upper_bound(k);
+    }
+    const_iterator upper_bound(const key_type& k) const {
+        return tree_.upper_bound(k);
+    }
+    mystl::pair<iterator, iterator> equal_range(const key_type& k) {
+        return tree_.equal_range(k);
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+        return tree_.equal_range(k);
+    }
+
+    // Debugging.
+    bool verify() const {
+        return tree_.verify();
+    }
+};
+
+template <class Key, class Tp, class Compare, class Alloc, std::size_t NodeSize>
+inline void swap(btree_map<Key, Tp, Compare, Alloc, NodeSize>& x, btree_map<Key, Tp, Compare, Alloc, NodeSize>& y) {
+    x.swap(y);
+}
+} // namespace mystl
+#endif // MYSTL_BTREE_MAP_H_
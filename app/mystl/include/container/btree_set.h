@@ -0,0 +1,243 @@
+#ifndef MYSTL_BTREE_SET_H_
+#define MYSTL_BTREE_SET_H_
+
+#include "allocator.h"
+#include "iterator.h"
+#include "functional.h"
+#include "btree.h"
+#include "utility.h"
+
+namespace mystl {
+/*
+ * btree_set: 接口与 set 相同, 底层为 B+ 树 (见 btree.h), 元素放在约 NodeSize 字节的结点里
+ * 与 set 的区别: 插入和删除之后所有迭代器失效; 元素在结点间搬动, 要求可移动构造
+ */
+template <typename Key, typename Compare = mystl::less<Key>, typename Alloc = mystl::allocator<Key>,
+          std::size_t NodeSize = 256>
+class btree_set {
+public: // member types
+    using allocator_type = Alloc;
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+
+private:
+    using key_alloc_type = typename mystl::allocator_traits<Key, Alloc>::allocator_type;
+    using rep_type = mystl::btree<key_type, value_type, mystl::identity<value_type>, key_compare, key_alloc_type, NodeSize>;
+    rep_type tree_;
+
+public:
+    using pointer = typename rep_type::const_pointer;
+    using const_pointer = typename rep_type::const_pointer;
+    using reference = typename rep_type::const_reference;
+    using const_reference = typename rep_type::const_reference;
+    using size_type = typename rep_type::size_type;
+    using difference_type = typename rep_type::difference_type;
+
+    // 元素就是键, 不能通过迭代器修改
+    using iterator = typename rep_type::const_iterator;
+    using const_iterator = typename rep_type::const_iterator;
+    using reverse_iterator = typename rep_type::const_reverse_iterator;
+    using const_reverse_iterator = typename rep_type::const_reverse_iterator;
+
+public: // member functions
+    /*
+     * @brief Constructor and Destructor
+     */
+    // empty(1)
+    explicit btree_set(const key_compare& comp = key_compare(),
+                       const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+    }
+    explicit btree_set(const allocator_type& alloc) :
+        tree_(key_alloc_type(alloc)) {
+    }
+    // range(2)
+    template <class InputIterator>
+    btree_set(InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+        tree_.insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    btree_set(sorted_unique_t, InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+        tree_.insert_range_unique(first, last);
+    }
+    // copy(3)
+    btree_set(const btree_set& x) = default;
+    btree_set(const btree_set& x, const allocator_type& alloc) :
+        tree_(x.tree_, key_alloc_type(alloc)) {
+    }
+    // move(4)
+    btree_set(btree_set&& x) = default;
+    btree_set(btree_set&& x, const allocator_type& alloc) :
+        tree_(mystl::move(x.tree_), key_alloc_type(alloc)) {
+    }
+    // initializer list(5)
+    btree_set(std::initializer_list<value_type> il,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    ~btree_set() = default;
+
+    btree_set& operator=(const btree_set& x) = default;
+    btree_set& operator=(btree_set&& x) = default;
+    btree_set& operator=(std::initializer_list<value_type> il) {
+        tree_.assign_unique(il.begin(), il.end());
+        return *this;
+    }
+
+    key_compare key_comp() const {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const {
+        return tree_.key_comp();
+    }
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(tree_.get_allocator());
+    }
+
+    /*
+     * @brief Iterators
+     */
+    const_iterator begin() const noexcept {
+        return tree_.begin();
+    }
+    const_iterator end() const noexcept {
+        return tree_.end();
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return tree_.rbegin();
+    }
+    const_reverse_iterator rend() const noexcept {
+        return tree_.rend();
+    }
+    const_iterator cbegin() const noexcept {
+        return tree_.begin();
+    }
+    const_iterator cend() const noexcept {
+        return tree_.end();
+    }
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    /*
+     * @brief Capacity
+     */
+    bool empty() const noexcept {
+        return tree_.empty();
+    }
+    size_type size() const noexcept {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept {
+        return tree_.max_size();
+    }
+
+    /*
+     * @brief Modifiers
+     */
+    // single element (1)
+    mystl::pair<iterator, bool> insert(const value_type& val) {
+        mystl::pair<typename rep_type::iterator, bool> p = tree_.insert_unique(val);
+        return mystl::pair<iterator, bool>(p.first, p.second);
+    }
+    mystl::pair<iterator, bool> insert(value_type&& val) {
+        mystl::pair<typename rep_type::iterator, bool> p = tree_.insert_unique(mystl::move(val));
+        return mystl::pair<iterator, bool>(p.first, p.second);
+    }
+    // with hint (2)
+    iterator insert(const_iterator position, const value_type& val) {
+        return tree_.insert_unique(position, val);
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return tree_.insert_unique(position, mystl::move(val));
+    }
+    // range (3)
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(first, last);
+    }
+    // initializer list (4)
+    void insert(std::initializer_list<value_type> il) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& val) {
+        return tree_.erase(val);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        return tree_.erase(first, last);
+    }
+
+    void swap(btree_set& x) {
+        tree_.swap(x.tree_);
+    }
+
+    void clear() noexcept {
+        tree_.clear();
+    }
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace(Args&&... args) {
+        mystl::pair<typename rep_type::iterator, bool> p = tree_.emplace_unique(mystl::forward<Args>(args)...);
+        return mystl::pair<iterator, bool>(p.first, p.second);
+    }
+    template <class... Args>
+    iterator emplace_hint(const_iterator position, Args&&... args) {
+        return tree_.emplace_hint_unique(position, mystl::forward<Args>(args)...);
+    }
+
+    /*
+     * @brief Operations
+     */
+    const_iterator find(const key_type& val) const {
+        return tree_.find(val);
+    }
+    size_type count(const key_type& val) const {
+        return tree_.find(val) == tree_.end() ? 0 : 1;
+    }
+    bool contains(const key_type& val) const {
+        return tree_.find(val) != tree_.end();
+    }
+    const_iterator lower_bound(const key_type& val) const {
+        return tree_.lower_bound(val);
+    }
+    const_iterator upper_bound(const key_type& val) const {
+        return tree_.upper_bound(val);
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range(const key_type& val) const {
+        return tree_.equal_range(val);
+    }
+
+    // Debugging.
+    bool verify() const {
+        return tree_.verify();
+    }
+};
+
+template <class Key, class Compare, class Alloc, std::size_t NodeSize>
+inline void swap(btree_set<Key, Compare, Alloc, NodeSize>& x, btree_set<Key, Compare, Alloc, NodeSize>& y) {
+    x.swap(y);
+}
+} // namespace mystl
+#endif // MYSTL_BTREE_SET_H_
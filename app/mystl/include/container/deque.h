@@ -79,7 +79,7 @@ public:
 
     self operator--(int) {
         self tmp = *this;
-        node_ = node_->prev_;
+        --*this;
         return tmp;
     }
 
@@ -156,7 +156,7 @@ public:
 };
 
 template <typename T, typename Alloc = mystl::allocator<T>>
-class deque {
+class deque : private mystl::allocator_holder<Alloc> {
 public: // member types
     using allocator_type = Alloc;
 
@@ -178,59 +178,122 @@ public: // member types
     using map_pointer = typename iterator::map_pointer;
     using map_allocator = typename Alloc::template rebind<node_pointer>::other;
 
+private:
+    using holder_type = mystl::allocator_holder<Alloc>;
+    using alloc_traits = mystl::allocator_traits<T, Alloc>;
+    using holder_type::get_alloc;
+
 public: // member functions
     /*
      * @brief Constructor and Destructor
      */
     // default (1)
-    explicit deque(const allocator_type& alloc = allocator_type()) {
+    explicit deque(const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         fill_initialize(0, value_type());
     }
     // fill (2)
-    explicit deque(size_type n) {
+    explicit deque(size_type n, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         fill_initialize(n, value_type());
     }
-    deque(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) {
+    deque(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         fill_initialize(n, val);
     }
     // range (3)
     template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
-    deque(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) {
+    deque(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         range_initialize(first, last);
     }
     // copy (4)
-    deque(const deque& x) {
+    deque(const deque& x) :
+        holder_type(alloc_traits::select_on_container_copy_construction(x.get_alloc())) {
+        range_initialize(x.begin(), x.end());
+    }
+    deque(const deque& x, const allocator_type& alloc) :
+        holder_type(alloc) {
         range_initialize(x.begin(), x.end());
     }
-    // deque(const deque& x, const allocator_type& alloc);
-    // move (5)
-    deque(deque&& x) {
-        map_ = mystl::move(x.map_);
-        map_size_ = mystl::move(x.map_size_);
-        start_ = mystl::move(x.start_);
-        finish_ = mystl::move(x.finish_);
+    // move (5), x 换上新的空 map, 仍然可用
+    deque(deque&& x) :
+        holder_type(mystl::move(x.get_alloc())) {
+        map_ = x.map_;
+        map_size_ = x.map_size_;
+        start_ = x.start_;
+        finish_ = x.finish_;
+        x.init_map(0);
+    }
+    deque(deque&& x, const allocator_type& alloc) :
+        holder_type(alloc) {
+        init_map(0);
+        if (get_alloc() == x.get_alloc()) {
+            swap_data(x);
+        } else {
+            for (auto it = x.begin(); it != x.end(); ++it) {
+                emplace_back(mystl::move(*it));
+            }
+            x.clear();
+        }
     }
-    // deque(deque&& x, const allocator_type& alloc);
     // initializer deque (6)
-    deque(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) {
+    deque(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         range_initialize(il.begin(), il.end());
     }
 
     ~deque() {
-        if (map_ != nullptr) {
-            clear();
-            map_allocator::deallocate(map_, map_size_);
-            map_ = nullptr;
-            map_size_ = 0U;
-        }
+        release();
     }
 
     // copy (1)
-    deque& operator=(const deque& x);
+    deque& operator=(const deque& x) {
+        if (this != &x) {
+            if (alloc_traits::propagate_on_container_copy_assignment::value && get_alloc() != x.get_alloc()) {
+                // 旧内存必须由旧分配器释放
+                release();
+                alloc_traits::copy_assign(get_alloc(), x.get_alloc());
+                init_map(0);
+            }
+            deque tmp(x, get_alloc());
+            swap_data(tmp);
+        }
+        return *this;
+    }
     // move (2)
-    deque& operator=(deque&& x);
+    deque& operator=(deque&& x) {
+        if (this == &x) {
+            return *this;
+        }
+        if (get_alloc() == x.get_alloc()) {
+            swap_data(x);
+            x.clear();
+        } else if (alloc_traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc_traits::move_assign(get_alloc(), x.get_alloc());
+            map_ = x.map_;
+            map_size_ = x.map_size_;
+            start_ = x.start_;
+            finish_ = x.finish_;
+            x.init_map(0);
+        } else {
+            // 分配器不同且不传播, 只能逐个移动元素
+            deque tmp(get_alloc());
+            for (auto it = x.begin(); it != x.end(); ++it) {
+                tmp.emplace_back(mystl::move(*it));
+            }
+            swap_data(tmp);
+            x.clear();
+        }
+        return *this;
+    }
     // initializer deque (3)
-    deque& operator=(std::initializer_list<value_type> il);
+    deque& operator=(std::initializer_list<value_type> il) {
+        deque tmp(il, get_alloc());
+        swap_data(tmp);
+        return *this;
+    }
 
     /*
      * @brief Iterators
@@ -352,7 +415,7 @@ public: // member functions
     template <class... Args>
     void emplace_front(Args&&... args) {
         if (start_.cur_ != start_.first_) {
-            data_allocator::construct(start_.cur_ - 1, mystl::forward<Args>(args)...);
+            get_alloc().construct(start_.cur_ - 1, mystl::forward<Args>(args)...);
             --start_.cur_;
         } else {
             push_front_aux(mystl::forward<Args>(args)...);
@@ -368,7 +431,7 @@ public: // member functions
 
     void pop_front() {
         if (start_.cur_ != start_.last_ - 1) {
-            data_allocator::destroy(start_.cur_);
+            get_alloc().destroy(start_.cur_);
             ++start_.cur_;
         } else {
             pop_front_aux();
@@ -378,7 +441,7 @@ public: // member functions
     template <class... Args>
     void emplace_back(Args&&... args) {
         if (finish_.cur_ != finish_.last_ - 1) {
-            data_allocator::construct(finish_.cur_, mystl::forward<Args>(args)...);
+            get_alloc().construct(finish_.cur_, mystl::forward<Args>(args)...);
             ++finish_.cur_;
         } else {
             push_back_aux(mystl::forward<Args>(args)...);
@@ -394,8 +457,8 @@ public: // member functions
 
     void pop_back() {
         if (finish_.cur_ != finish_.first_) {
-            data_allocator::destroy(finish_.cur_);
             --finish_.cur_;
+            get_alloc().destroy(finish_.cur_);
         } else {
             pop_back_aux();
         }
@@ -458,30 +521,54 @@ public: // member functions
         return last;
     }
 
+    // 分配器不传播时, 两个容器的分配器必须相等
     void swap(deque& x) {
-        mystl::swap(map_, x.map_);
-        mystl::swap(map_size_, x.map_size_);
-        mystl::swap(start_, x.start_);
-        mystl::swap(finish_, x.finish_);
+        MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || get_alloc() == x.get_alloc());
+        alloc_traits::swap(get_alloc(), x.get_alloc());
+        swap_data(x);
     }
 
+    // 只保留 start_ 所在的缓冲区
     void clear() noexcept {
         mystl::destroy(start_, finish_);
-        delete_nodes(start_.node_, finish_.node_);
+        delete_nodes(start_.node_ + 1, finish_.node_ + 1);
         finish_ = start_;
     }
 
     allocator_type get_allocator() const noexcept {
-        return allocator_type();
+        return get_alloc();
     }
 
 private:
+    map_allocator get_map_alloc() const {
+        return map_allocator(get_alloc());
+    }
+
+    // 只交换数据, 分配器不变; 调用方保证两者分配器相等
+    void swap_data(deque& x) noexcept {
+        mystl::swap(map_, x.map_);
+        mystl::swap(map_size_, x.map_size_);
+        mystl::swap(start_, x.start_);
+        mystl::swap(finish_, x.finish_);
+    }
+
+    // 销毁全部元素并归还所有内存
+    void release() {
+        if (map_ != nullptr) {
+            clear();
+            delete_node(*start_.node_);
+            get_map_alloc().deallocate(map_, map_size_);
+            map_ = nullptr;
+            map_size_ = 0U;
+        }
+    }
+
     static constexpr std::size_t buffer_size() {
         return deque_buf_size(sizeof(T));
     }
 
     void delete_node(node_pointer node) {
-        return data_allocator::deallocate(node, buffer_size());
+        return get_alloc().deallocate(node, buffer_size());
     }
 
     void delete_nodes(map_pointer nstart, map_pointer nfinish) {
@@ -492,7 +579,7 @@ private:
     }
 
     node_pointer create_node() {
-        return data_allocator::allocate(buffer_size());
+        return get_alloc().allocate(buffer_size());
     }
 
     void create_nodes(map_pointer nstart, map_pointer nfinish) {
@@ -510,7 +597,7 @@ private:
     void init_map(size_type num_elemens) {
         const size_type num_nodes = (num_elemens / buffer_size()) + 1;
         map_size_ = mystl::max(DEQUE_INIT_MAP_SIZE, num_nodes + 2);
-        map_ = map_allocator::allocate(map_size_);
+        map_ = get_map_alloc().allocate(map_size_);
 
         // 将头尾指针指向中间位置,方便前后扩展
         map_pointer nstart = map_ + (map_size_ - num_nodes) / 2;
@@ -519,7 +606,7 @@ private:
         try {
             create_nodes(nstart, nfinish);
         } catch (...) {
-            map_allocator::deallocate(map_, map_size_);
+            get_map_alloc().deallocate(map_, map_size_);
             map_ = map_pointer();
             map_size_ = 0;
             throw;
@@ -550,17 +637,14 @@ private:
         map_pointer new_nstart;
         if (map_size_ > 2 * new_num_nodes) {
             new_nstart = map_ + (map_size_ - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
-            if (new_nstart < start_.node_) {
-                mystl::copy(start_.node_, finish_.node_ + 1, new_nstart);
-            } else {
-                mystl::copy_backward(start_.node_, finish_.node_ + 1, new_nstart + old_num_nodes);
-            }
+            // 节点指针可平凡重定位, 一次 memmove 即可, 源和目标可以重叠
+            mystl::uninitialized_relocate(start_.node_, finish_.node_ + 1, new_nstart);
         } else {
             size_type new_map_size = map_size_ + mystl::max(map_size_, nodes_to_add) + 2;
-            map_pointer new_map = map_allocator::allocate(new_map_size);
+            map_pointer new_map = get_map_alloc().allocate(new_map_size);
             new_nstart = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
-            mystl::copy(start_.node_, finish_.node_ + 1, new_nstart);
-            map_allocator::deallocate(map_, map_size_);
+            mystl::uninitialized_relocate(start_.node_, finish_.node_ + 1, new_nstart);
+            get_map_alloc().deallocate(map_, map_size_);
             map_ = new_map;
             map_size_ = new_map_size;
         }
@@ -623,7 +707,7 @@ private:
     void fill_assign(size_type n, const value_type& val) {
         auto cur = begin();
         for (; cur != end() && n > 0; ++cur, --n) {
-            *cur = *val;
+            *cur = val;
         }
         if (n > 0) {
             insert(end(), n, val);
@@ -680,7 +764,7 @@ private:
         try {
             start_.set_node(start_.node_ - 1);
             start_.cur_ = start_.last_ - 1;
-            data_allocator::construct(start_.cur_, mystl::forward<Args>(args)...);
+            get_alloc().construct(start_.cur_, mystl::forward<Args>(args)...);
         } catch (...) {
             ++start_;
             delete_node(*(start_.node_ - 1));
@@ -694,7 +778,7 @@ private:
         reserve_map_at_back(); // 符合条件重换map
         *(finish_.node_ + 1) = create_node();
         try {
-            data_allocator::construct(finish_.cur_, mystl::forward<Args>(args)...);
+            get_alloc().construct(finish_.cur_, mystl::forward<Args>(args)...);
             finish_.set_node(finish_.node_ + 1);
             finish_.cur_ = finish_.first_;
         } catch (...) {
@@ -704,7 +788,7 @@ private:
     }
 
     void pop_front_aux() {
-        data_allocator::destroy(start_.first_);
+        get_alloc().destroy(start_.first_);
         delete_node(*start_.node_);
         start_.set_node(start_.node_ + 1);
         start_.cur_ = start_.first_;
@@ -714,12 +798,12 @@ private:
         delete_node(*finish_.node_);
         finish_.set_node(finish_.node_ - 1);
         finish_.cur_ = finish_.last_ - 1;
-        data_allocator::destroy(finish_.cur_);
+        get_alloc().destroy(finish_.cur_);
     }
 
 private:
-    map_pointer map_;
-    size_type map_size_;
+    map_pointer map_{nullptr};
+    size_type map_size_{0U};
     iterator start_;
     iterator finish_;
 };
@@ -0,0 +1,162 @@
+#ifndef MYSTL_EYTZINGER_ARRAY_H_
+#define MYSTL_EYTZINGER_ARRAY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include "allocator.h"
+#include "functional.h"
+#include "vector.h"
+#include "sort.h"
+
+namespace mystl {
+
+/*
+ * eytzinger_array: 只读的有序查找表, 元素按完全二叉树的 BFS 顺序(Eytzinger 布局)存放
+ * - 第 k 个结点(从 1 开始)的孩子是 2k 和 2k + 1, 查找时从上往下走, 访问位置只依赖比较结果, 没有分支
+ * - 前几层挤在同一条缓存行里, 往下每一层的 16 个后代也相邻, 可以提前好几层预取
+ * - 表比 L2 大时查找比在有序数组上二分快数倍; 构造之后不能修改
+ * 查找返回指向元素的指针, 找不到时返回 nullptr; begin()/end() 按存放顺序遍历, 不是有序的
+ */
+template <class T, class Compare = mystl::less<T>, class Alloc = mystl::allocator<T>>
+class eytzinger_array {
+public:
+    using value_type = T;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const T&;
+    using const_pointer = const T*;
+    using const_iterator = const T*;
+
+public:
+    eytzinger_array() :
+        layout_(), comp_() {
+    }
+
+    explicit eytzinger_array(const Compare& comp) :
+        layout_(), comp_(comp) {
+    }
+
+    template <class InputIterator, typename = RequireInputIterator<InputIterator>>
+    eytzinger_array(InputIterator first, InputIterator last, const Compare& comp = Compare()) :
+        layout_(), comp_(comp) {
+        build(mystl::vector<T, Alloc>(first, last));
+    }
+
+    eytzinger_array(std::initializer_list<T> il, const Compare& comp = Compare()) :
+        layout_(), comp_(comp) {
+        build(mystl::vector<T, Alloc>(il.begin(), il.end()));
+    }
+
+    const_iterator begin() const noexcept {
+        return layout_.data();
+    }
+
+    const_iterator end() const noexcept {
+        return layout_.data() + layout_.size();
+    }
+
+    const_pointer data() const noexcept {
+        return layout_.data();
+    }
+
+    size_type size() const noexcept {
+        return layout_.size();
+    }
+
+    bool empty() const noexcept {
+        return layout_.empty();
+    }
+
+    key_compare key_comp() const {
+        return comp_;
+    }
+
+    // 第一个不小于 x 的元素
+    const_pointer lower_bound(const T& x) const {
+        const T* const base = layout_.data();
+        const size_type n = layout_.size();
+        size_type k = 1;
+        while (k <= n) {
+            prefetch(base, k * PREFETCH_STRIDE);
+            k = 2 * k + static_cast<size_type>(comp_(base[k - 1], x));
+        }
+        return result(k);
+    }
+
+    // 第一个大于 x 的元素
+    const_pointer upper_bound(const T& x) const {
+        const T* const base = layout_.data();
+        const size_type n = layout_.size();
+        size_type k = 1;
+        while (k <= n) {
+            prefetch(base, k * PREFETCH_STRIDE);
+            k = 2 * k + static_cast<size_type>(!comp_(x, base[k - 1]));
+        }
+        return result(k);
+    }
+
+    const_pointer find(const T& x) const {
+        const_pointer p = lower_bound(x);
+        return p != nullptr && !comp_(x, *p) ? p : nullptr;
+    }
+
+    bool contains(const T& x) const {
+        return find(x) != nullptr;
+    }
+
+    void swap(eytzinger_array& rhs) noexcept {
+        layout_.swap(rhs.layout_);
+        mystl::swap(comp_, rhs.comp_);
+    }
+
+private:
+    // 一条缓存行能放下的元素个数; 第 k 个结点往下 4 层的 16 个后代从 16k 开始连续存放
+    enum {
+        CACHELINE_SIZE = 64,
+        PREFETCH_STRIDE = sizeof(T) >= CACHELINE_SIZE ? 1 : CACHELINE_SIZE / sizeof(T)
+    };
+
+    // 预取地址可能越过末尾, 用整数运算得到地址, 不构造越界指针; 预取本身不会出错
+    static void prefetch(const T* base, size_type k) noexcept {
+        const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(base) + (k - 1) * sizeof(T);
+        __builtin_prefetch(reinterpret_cast<const void*>(addr));
+    }
+
+    // 走到空结点 k 时, 最后一次向右之前的那个结点就是答案: 去掉 k 末尾的 1 和再前面的一个 0
+    const_pointer result(size_type k) const noexcept {
+        k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+        return k == 0 ? nullptr : layout_.data() + (k - 1);
+    }
+
+    // 中序遍历完全二叉树, 依次填入有序序列
+    size_type fill(const mystl::vector<T, Alloc>& sorted, size_type i, size_type k) {
+        if (k <= sorted.size()) {
+            i = fill(sorted, i, 2 * k);
+            layout_[k - 1] = sorted[i++];
+            i = fill(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    void build(mystl::vector<T, Alloc> sorted) {
+        mystl::sort(sorted.begin(), sorted.end(), comp_);
+        layout_ = sorted;
+        fill(sorted, 0, 1);
+    }
+
+private:
+    mystl::vector<T, Alloc> layout_;
+    Compare comp_;
+};
+
+template <class T, class Compare, class Alloc>
+void swap(eytzinger_array<T, Compare, Alloc>& lhs, eytzinger_array<T, Compare, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // MYSTL_EYTZINGER_ARRAY_H_
@@ -0,0 +1,375 @@
+#ifndef MYSTL_FLAT_MAP_H_
+#define MYSTL_FLAT_MAP_H_
+
+#include "allocator.h"
+#include "iterator.h"
+#include "functional.h"
+#include "functexcept.h"
+#include "flat_tree.h"
+#include "utility.h"
+
+namespace mystl {
+/*
+ * flat_map: 接口与 map 相同, 底层为按键有序存放的 mystl::vector (见 flat_tree.h)
+ * 与 map 的区别:
+ * - value_type 为 pair<Key, Tp>, 键不是 const 的, 元素要在数组中搬动; 不要通过迭代器修改键
+ * - 插入和删除之后所有迭代器和元素的引用都失效; 区间插入是批量归并, 适合一次建好、多读少写的场合
+ * - 可以直接接管一个 vector: flat_map(sorted_unique, mystl::move(v)) 不拷贝元素, v 必须已按键严格递增;
+ *   extract() 把底层的 vector 交还出来
+ * - Compare 定义了 is_transparent 时, 查找函数接受任意能与 Key 比较的类型, 不必先构造出 Key
+ */
+template <typename Key, typename Tp, typename Compare = mystl::less<Key>,
+          typename Alloc = mystl::allocator<mystl::pair<Key, Tp>>>
+class flat_map {
+public: // member types
+    using allocator_type = Alloc;
+    using key_type = Key;
+    using mapped_type = Tp;
+    using key_compare = Compare;
+    using value_type = mystl::pair<Key, Tp>;
+
+private:
+    using pair_alloc_type = typename mystl::allocator_traits<value_type, Alloc>::allocator_type;
+    using rep_type = mystl::flat_tree<key_type, value_type, mystl::select1st<value_type>, key_compare, pair_alloc_type>;
+    rep_type tree_;
+
+public:
+    using container_type = typename rep_type::container_type;
+    using pointer = typename rep_type::pointer;
+    using const_pointer = typename rep_type::const_pointer;
+    using reference = typename rep_type::reference;
+    using const_reference = typename rep_type::const_reference;
+    using size_type = typename rep_type::size_type;
+    using difference_type = typename rep_type::difference_type;
+
+    using iterator = typename rep_type::iterator;
+    using const_iterator = typename rep_type::const_iterator;
+    using reverse_iterator = typename rep_type::reverse_iterator;
+    using const_reverse_iterator = typename rep_type::const_reverse_iterator;
+
+public:
+    class value_compare : public mystl::binary_function<value_type, value_type, bool> {
+        friend class flat_map<Key, Tp, Compare, Alloc>;
+
+    protected:
+        Compare comp;
+        value_compare(Compare c) :
+            comp(c) {
+        }
+
+    public:
+        bool operator()(const value_type& x, const value_type& y) const {
+            return comp(x.first, y.first);
+        }
+    };
+
+public: // member functions
+    /*
+     * @brief Constructor and Destructor
+     */
+    // empty(1)
+    explicit flat_map(const key_compare& comp = key_compare(),
+                       const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+    }
+    explicit flat_map(const allocator_type& alloc) :
+        tree_(pair_alloc_type(alloc)) {
+    }
+    // range(2)
+    template <class InputIterator>
+    flat_map(InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+        tree_.insert_range_unique(first, last);
+    }
+    // 区间已按键严格递增, 不排序
+    template <class InputIterator>
+    flat_map(sorted_unique_t, InputIterator first, InputIterator last,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+        tree_.insert_range_unique(sorted_unique, first, last);
+    }
+    // 接管 c 的存储: 无序时就地按键排序去重; 带 sorted_unique 时 c 必须已按键严格递增, 直接使用
+    explicit flat_map(container_type&& c, const key_compare& comp = key_compare()) :
+        tree_(mystl::move(c), comp) {
+    }
+    flat_map(sorted_unique_t, container_type&& c, const key_compare& comp = key_compare()) :
+        tree_(sorted_unique, mystl::move(c), comp) {
+    }
+    // copy(3)
+    flat_map(const flat_map& x) = default;
+    flat_map(const flat_map& x, const allocator_type& alloc) :
+        tree_(x.tree_, pair_alloc_type(alloc)) {
+    }
+    // move(4)
+    flat_map(flat_map&& x) = default;
+    flat_map(flat_map&& x, const allocator_type& alloc) :
+        tree_(mystl::move(x.tree_), pair_alloc_type(alloc)) {
+    }
+    // initializer list(5)
+    flat_map(std::initializer_list<value_type> il,
+              const key_compare& comp = key_compare(),
+              const allocator_type& alloc = allocator_type()) :
+        tree_(comp, pair_alloc_type(alloc)) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    ~flat_map() = default;
+
+    flat_map& operator=(const flat_map& x) = default;
+    flat_map& operator=(flat_map&& x) = default;
+    flat_map& operator=(std::initializer_list<value_type> il) {
+        tree_.assign_unique(il.begin(), il.end());
+        return *this;
+    }
+
+    key_compare key_comp() const {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const {
+        return value_compare(tree_.key_comp());
+    }
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(tree_.get_allocator());
+    }
+
+    /*
+     * @brief Iterators
+     */
+    iterator begin() noexcept {
+        return tree_.begin();
+    }
+    const_iterator begin() const noexcept {
+        return tree_.begin();
+    }
+    iterator end() noexcept {
+        return tree_.end();
+    }
+    const_iterator end() const noexcept {
+        return tree_.end();
+    }
+    reverse_iterator rbegin() noexcept {
+        return tree_.rbegin();
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return tree_.rbegin();
+    }
+    reverse_iterator rend() noexcept {
+        return tree_.rend();
+    }
+    const_reverse_iterator rend() const noexcept {
+        return tree_.rend();
+    }
+    const_iterator cbegin() const noexcept {
+        return tree_.begin();
+    }
+    const_iterator cend() const noexcept {
+        return tree_.end();
+    }
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    /*
+     * @brief Capacity
+     */
+    bool empty() const noexcept {
+        return tree_.empty();
+    }
+    size_type size() const noexcept {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept {
+        return tree_.max_size();
+    }
+    size_type capacity() const noexcept {
+        return tree_.capacity();
+    }
+    void reserve(size_type n) {
+        tree_.reserve(n);
+    }
+    void shrink_to_fit() {
+        tree_.shrink_to_fit();
+    }
+
+    /*
+     * @brief Element access
+     */
+    mapped_type& operator[](const key_type& k) {
+        iterator i = lower_bound(k);
+        if (i == end() || key_comp()(k, (*i).first)) {
+            i = tree_.insert_unique(i, value_type(k, mapped_type()));
+        }
+        return (*i).second;
+    }
+    mapped_type& at(const key_type& k) {
+        iterator i = find(k);
+        THROW_OUT_OF_RANGE_IF(i == end(), "flat_map::at");
+        return (*i).second;
+    }
+    const mapped_type& at(const key_type& k) const {
+        const_iterator i = find(k);
+        THROW_OUT_OF_RANGE_IF(i == end(), "flat_map::at");
+        return (*i).second;
+    }
+
+    /*
+     * @brief Modifiers
+     */
+    // single element (1)
+    mystl::pair<iterator, bool> insert(const value_type& val) {
+        return tree_.insert_unique(val);
+    }
+    mystl::pair<iterator, bool> insert(value_type&& val) {
+        return tree_.insert_unique(mystl::move(val));
+    }
+    // with hint (2)
+    iterator insert(const_iterator position, const value_type& val) {
+        return tree_.insert_unique(position, val);
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return tree_.insert_unique(position, mystl::move(val));
+    }
+    // range (3)
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(sorted_unique, first, last);
+    }
+    // initializer list (4)
+    void insert(std::initializer_list<value_type> il) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& k) {
+        return tree_.erase(k);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        return tree_.erase(first, last);
+    }
+
+    void swap(flat_map& x) {
+        tree_.swap(x.tree_);
+    }
+
+    void clear() noexcept {
+        tree_.clear();
+    }
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace(Args&&... args) {
+        return tree_.emplace_unique(mystl::forward<Args>(args)...);
+    }
+    template <class... Args>
+    iterator emplace_hint(const_iterator position, Args&&... args) {
+        return tree_.emplace_hint_unique(position, mystl::forward<Args>(args)...);
+    }
+
+    // 交出底层的有序 vector, 之后 flat_map 为空
+    container_type extract() {
+        return tree_.extract();
+    }
+    // 换上一个已按键严格递增的 vector, 不拷贝元素
+    void replace(container_type&& c) {
+        tree_.replace(mystl::move(c));
+    }
+
+    /*
+     * @brief Operations
+     */
+    iterator find(const key_type& k) {
+        return tree_.find(k);
+    }
+    const_iterator find(const key_type& k) const {
+        return tree_.find(k);
+    }
+    size_type count(const key_type& k) const {
+        return tree_.find(k) == tree_.end() ? 0 : 1;
+    }
+    bool contains(const key_type& k) const {
+        return tree_.find(k) != tree_.end();
+    }
+    iterator lower_bound(const key_type& k) {
+        return tree_.lower_bound(k);
+    }
+    const_iterator lower_bound(const key_type& k) const {
+        return tree_.lower_bound(k);
+    }
+    iterator upper_bound(const key_type& k) {
+        return tree_.upper_bound(k);
+    }
+    const_iterator upper_bound(const key_type& k) const {
+        return tree_.upper_bound(k);
+    }
+    mystl::pair<iterator, iterator> equal_range(const key_type& k) {
+        return tree_.equal_range(k);
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+        return tree_.equal_range(k);
+    }
+
+    // 异构查找, 仅当 Compare::is_transparent 存在时可用
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator find(const K& k) {
+        return tree_.find(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator find(const K& k) const {
+        return tree_.find(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    size_type count(const K& k) const {
+        return tree_.count(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    bool contains(const K& k) const {
+        return tree_.find(k) != tree_.end();
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const K& k) {
+        return tree_.lower_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const K& k) const {
+        return tree_.lower_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const K& k) {
+        return tree_.upper_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const K& k) const {
+        return tree_.upper_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    mystl::pair<iterator, iterator> equal_range(const K& k) {
+        return tree_.equal_range(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    mystl::pair<const_iterator, const_iterator> equal_range(const K& k) const {
+        return tree_.equal_range(k);
+    }
+
+    // Debugging.
+    bool verify() const {
+        return tree_.is_strictly_sorted();
+    }
+};
+
+template <class Key, class Tp, class Compare, class Alloc>
+inline void swap(flat_map<Key, Tp, Compare, Alloc>& x, flat_map<Key, Tp, Compare, Alloc>& y) {
+    x.swap(y);
+}
+} // namespace mystl
+#endif // MYSTL_FLAT_MAP_H_
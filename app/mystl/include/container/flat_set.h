@@ -0,0 +1,299 @@
+#ifndef MYSTL_FLAT_SET_H_
+#define MYSTL_FLAT_SET_H_
+
+#include "allocator.h"
+#include "iterator.h"
+#include "functional.h"
+#include "flat_tree.h"
+#include "utility.h"
+
+namespace mystl {
+/*
+ * flat_set: 接口与 set 相同, 底层为按序存放的 mystl::vector (见 flat_tree.h)
+ * 与 set 的区别: 插入和删除之后所有迭代器失效; 区间插入是批量归并, 适合一次建好、多读少写的场合
+ * - 可以直接接管一个 vector: flat_set(sorted_unique, mystl::move(v)) 不拷贝元素, v 必须已严格递增;
+ *   extract() 把底层的 vector 交还出来
+ * - Compare 定义了 is_transparent 时, find/count/contains/lower_bound/upper_bound/equal_range
+ *   接受任意能与 Key 比较的类型, 不必先构造出 Key
+ */
+template <typename Key, typename Compare = mystl::less<Key>, typename Alloc = mystl::allocator<Key>>
+class flat_set {
+public: // member types
+    using allocator_type = Alloc;
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+
+private:
+    using key_alloc_type = typename mystl::allocator_traits<Key, Alloc>::allocator_type;
+    using rep_type = mystl::flat_tree<key_type, value_type, mystl::identity<value_type>, key_compare, key_alloc_type>;
+    rep_type tree_;
+
+public:
+    using container_type = typename rep_type::container_type;
+    using pointer = typename rep_type::const_pointer;
+    using const_pointer = typename rep_type::const_pointer;
+    using reference = typename rep_type::const_reference;
+    using const_reference = typename rep_type::const_reference;
+    using size_type = typename rep_type::size_type;
+    using difference_type = typename rep_type::difference_type;
+
+    // 元素就是键, 不能通过迭代器修改
+    using iterator = typename rep_type::const_iterator;
+    using const_iterator = typename rep_type::const_iterator;
+    using reverse_iterator = typename rep_type::const_reverse_iterator;
+    using const_reverse_iterator = typename rep_type::const_reverse_iterator;
+
+public: // member functions
+    /*
+     * @brief Constructor and Destructor
+     */
+    // empty(1)
+    explicit flat_set(const key_compare& comp = key_compare(),
+                      const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+    }
+    explicit flat_set(const allocator_type& alloc) :
+        tree_(key_alloc_type(alloc)) {
+    }
+    // range(2)
+    template <class InputIterator>
+    flat_set(InputIterator first, InputIterator last,
+             const key_compare& comp = key_compare(),
+             const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+        tree_.insert_range_unique(first, last);
+    }
+    // 区间已按 comp 严格递增, 不排序
+    template <class InputIterator>
+    flat_set(sorted_unique_t, InputIterator first, InputIterator last,
+             const key_compare& comp = key_compare(),
+             const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+        tree_.insert_range_unique(sorted_unique, first, last);
+    }
+    // 接管 c 的存储: 无序时就地排序去重; 带 sorted_unique 时 c 必须已严格递增, 直接使用
+    explicit flat_set(container_type&& c, const key_compare& comp = key_compare()) :
+        tree_(mystl::move(c), comp) {
+    }
+    flat_set(sorted_unique_t, container_type&& c, const key_compare& comp = key_compare()) :
+        tree_(sorted_unique, mystl::move(c), comp) {
+    }
+    // copy(3)
+    flat_set(const flat_set& x) = default;
+    flat_set(const flat_set& x, const allocator_type& alloc) :
+        tree_(x.tree_, key_alloc_type(alloc)) {
+    }
+    // move(4)
+    flat_set(flat_set&& x) = default;
+    flat_set(flat_set&& x, const allocator_type& alloc) :
+        tree_(mystl::move(x.tree_), key_alloc_type(alloc)) {
+    }
+    // initializer list(5)
+    flat_set(std::initializer_list<value_type> il,
+             const key_compare& comp = key_compare(),
+             const allocator_type& alloc = allocator_type()) :
+        tree_(comp, key_alloc_type(alloc)) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    ~flat_set() = default;
+
+    flat_set& operator=(const flat_set& x) = default;
+    flat_set& operator=(flat_set&& x) = default;
+    flat_set& operator=(std::initializer_list<value_type> il) {
+        tree_.assign_unique(il.begin(), il.end());
+        return *this;
+    }
+
+    key_compare key_comp() const {
+        return tree_.key_comp();
+    }
+    value_compare value_comp() const {
+        return tree_.key_comp();
+    }
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(tree_.get_allocator());
+    }
+
+    /*
+     * @brief Iterators
+     */
+    const_iterator begin() const noexcept {
+        return tree_.begin();
+    }
+    const_iterator end() const noexcept {
+        return tree_.end();
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return tree_.rbegin();
+    }
+    const_reverse_iterator rend() const noexcept {
+        return tree_.rend();
+    }
+    const_iterator cbegin() const noexcept {
+        return tree_.begin();
+    }
+    const_iterator cend() const noexcept {
+        return tree_.end();
+    }
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    /*
+     * @brief Capacity
+     */
+    bool empty() const noexcept {
+        return tree_.empty();
+    }
+    size_type size() const noexcept {
+        return tree_.size();
+    }
+    size_type max_size() const noexcept {
+        return tree_.max_size();
+    }
+    size_type capacity() const noexcept {
+        return tree_.capacity();
+    }
+    void reserve(size_type n) {
+        tree_.reserve(n);
+    }
+    void shrink_to_fit() {
+        tree_.shrink_to_fit();
+    }
+
+    /*
+     * @brief Modifiers
+     */
+    // single element (1)
+    mystl::pair<iterator, bool> insert(const value_type& val) {
+        mystl::pair<typename rep_type::iterator, bool> p = tree_.insert_unique(val);
+        return mystl::pair<iterator, bool>(p.first, p.second);
+    }
+    mystl::pair<iterator, bool> insert(value_type&& val) {
+        mystl::pair<typename rep_type::iterator, bool> p = tree_.insert_unique(mystl::move(val));
+        return mystl::pair<iterator, bool>(p.first, p.second);
+    }
+    // with hint (2)
+    iterator insert(const_iterator position, const value_type& val) {
+        return tree_.insert_unique(position, val);
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return tree_.insert_unique(position, mystl::move(val));
+    }
+    // range (3)
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(first, last);
+    }
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+        tree_.insert_range_unique(sorted_unique, first, last);
+    }
+    // initializer list (4)
+    void insert(std::initializer_list<value_type> il) {
+        tree_.insert_range_unique(il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator position) {
+        return tree_.erase(position);
+    }
+    size_type erase(const key_type& val) {
+        return tree_.erase(val);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        return tree_.erase(first, last);
+    }
+
+    void swap(flat_set& x) {
+        tree_.swap(x.tree_);
+    }
+
+    void clear() noexcept {
+        tree_.clear();
+    }
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace(Args&&... args) {
+        mystl::pair<typename rep_type::iterator, bool> p = tree_.emplace_unique(mystl::forward<Args>(args)...);
+        return mystl::pair<iterator, bool>(p.first, p.second);
+    }
+    template <class... Args>
+    iterator emplace_hint(const_iterator position, Args&&... args) {
+        return tree_.emplace_hint_unique(position, mystl::forward<Args>(args)...);
+    }
+
+    // 交出底层的有序 vector, 之后 flat_set 为空
+    container_type extract() {
+        return tree_.extract();
+    }
+    // 换上一个已严格递增的 vector, 不拷贝元素
+    void replace(container_type&& c) {
+        tree_.replace(mystl::move(c));
+    }
+
+    /*
+     * @brief Operations
+     */
+    const_iterator find(const key_type& val) const {
+        return tree_.find(val);
+    }
+    size_type count(const key_type& val) const {
+        return tree_.find(val) == tree_.end() ? 0 : 1;
+    }
+    bool contains(const key_type& val) const {
+        return tree_.find(val) != tree_.end();
+    }
+    const_iterator lower_bound(const key_type& val) const {
+        return tree_.lower_bound(val);
+    }
+    const_iterator upper_bound(const key_type& val) const {
+        return tree_.upper_bound(val);
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range(const key_type& val) const {
+        return tree_.equal_range(val);
+    }
+
+    // 异构查找, 仅当 Compare::is_transparent 存在时可用
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator find(const K& k) const {
+        return tree_.find(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    size_type count(const K& k) const {
+        return tree_.count(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    bool contains(const K& k) const {
+        return tree_.find(k) != tree_.end();
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const K& k) const {
+        return tree_.lower_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const K& k) const {
+        return tree_.upper_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    mystl::pair<const_iterator, const_iterator> equal_range(const K& k) const {
+        return tree_.equal_range(k);
+    }
+
+    // Debugging.
+    bool verify() const {
+        return tree_.is_strictly_sorted();
+    }
+};
+
+template <class Key, class Compare, class Alloc>
+inline void swap(flat_set<Key, Compare, Alloc>& x, flat_set<Key, Compare, Alloc>& y) {
+    x.swap(y);
+}
+} // namespace mystl
+#endif // MYSTL_FLAT_SET_H_
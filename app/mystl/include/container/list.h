@@ -139,7 +139,7 @@ public:
 };
 
 template <typename T, typename Alloc = mystl::allocator<T>>
-class list {
+class list : private mystl::allocator_holder<typename Alloc::template rebind<list_node<T>>::other> {
 public: // member types
     using allocator_type = Alloc;
 
@@ -161,57 +161,124 @@ public: // member types
     using node_pointer = node*;
     using node_allocator = typename Alloc::template rebind<node>::other;
 
+private:
+    using holder_type = mystl::allocator_holder<node_allocator>;
+    using alloc_traits = mystl::allocator_traits<node, node_allocator>;
+    using holder_type::get_alloc;
+
 public: // member functions
     /*
      * @brief Constructor and Destructor
      */
     // default (1)
-    explicit list(const allocator_type& alloc = allocator_type()) {
+    explicit list(const allocator_type& alloc = allocator_type()) :
+        holder_type(node_allocator(alloc)) {
         init_node();
         size_ = 0U;
     }
     // fill (2)
-    explicit list(size_type n) {
+    explicit list(size_type n, const allocator_type& alloc = allocator_type()) :
+        holder_type(node_allocator(alloc)) {
         fill_initialize(n, value_type());
     }
-    list(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) {
+    list(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) :
+        holder_type(node_allocator(alloc)) {
         fill_initialize(n, val);
     }
     // range (3)
     template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
-    list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) {
+    list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) :
+        holder_type(node_allocator(alloc)) {
         range_initialize(first, last);
     }
     // copy (4)
-    list(const list& x) {
+    list(const list& x) :
+        holder_type(alloc_traits::select_on_container_copy_construction(x.get_alloc())) {
+        range_initialize(x.begin(), x.end());
+    }
+    list(const list& x, const allocator_type& alloc) :
+        holder_type(node_allocator(alloc)) {
         range_initialize(x.begin(), x.end());
     }
-    // list(const list& x, const allocator_type& alloc);
-    // move (5)
-    list(list&& x) {
-        list(mystl::move(x));
+    // move (5), x 换上新的哨兵节点, 仍然可用
+    list(list&& x) :
+        holder_type(mystl::move(x.get_alloc())) {
+        node_ = x.node_;
+        size_ = x.size_;
+        x.init_node();
+        x.size_ = 0U;
+    }
+    list(list&& x, const allocator_type& alloc) :
+        holder_type(node_allocator(alloc)) {
+        init_node();
+        if (get_alloc() == x.get_alloc()) {
+            swap_data(x);
+        } else {
+            for (auto it = x.begin(); it != x.end(); ++it) {
+                emplace_back(mystl::move(*it));
+            }
+            x.clear();
+        }
     }
-    // list(list&& x, const allocator_type& alloc);
     // initializer list (6)
-    list(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) {
+    list(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) :
+        holder_type(node_allocator(alloc)) {
         range_initialize(il.begin(), il.end());
     }
 
     ~list() {
         if (node_ != nullptr) {
             clear();
-            node_allocator::deallocate(node_);
+            get_alloc().deallocate(node_, 1);
             node_ = nullptr;
             size_ = 0U;
         }
     }
 
     // copy (1)
-    list& operator=(const list& x);
+    list& operator=(const list& x) {
+        if (this != &x) {
+            if (alloc_traits::propagate_on_container_copy_assignment::value && get_alloc() != x.get_alloc()) {
+                // 旧节点必须由旧分配器释放
+                clear();
+                get_alloc().deallocate(node_, 1);
+                node_ = nullptr;
+                alloc_traits::copy_assign(get_alloc(), x.get_alloc());
+                init_node();
+            }
+            range_assign(x.begin(), x.end());
+        }
+        return *this;
+    }
     // move (2)
-    list& operator=(list&& x);
+    list& operator=(list&& x) {
+        if (this == &x) {
+            return *this;
+        }
+        clear();
+        if (get_alloc() == x.get_alloc()) {
+            swap_data(x);
+        } else if (alloc_traits::propagate_on_container_move_assignment::value) {
+            get_alloc().deallocate(node_, 1);
+            alloc_traits::move_assign(get_alloc(), x.get_alloc());
+            node_ = x.node_;
+            size_ = x.size_;
+            x.init_node();
+            x.size_ = 0U;
+        } else {
+            // 分配器不同且不传播, 只能逐个移动元素
+            for (auto it = x.begin(); it != x.end(); ++it) {
+                emplace_back(mystl::move(*it));
+            }
+            x.clear();
+        }
+        return *this;
+    }
     // initializer list (3)
-    list& operator=(std::initializer_list<value_type> il);
+    list& operator=(std::initializer_list<value_type> il) {
+        range_assign(il.begin(), il.end());
+        return *this;
+    }
 
     /*
      * @brief Iterators
@@ -357,7 +424,7 @@ public: // member functions
     }
     // fill (2)
     iterator insert(iterator position, size_type n, const value_type& val) {
-        list tmp(n, val);
+        list tmp(n, val, get_allocator());
         if (tmp.empty()) { return position; }
         iterator it = tmp.begin();
         splice(position, tmp);
@@ -366,7 +433,7 @@ public: // member functions
     // range (3)
     template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
     iterator insert(iterator position, InputIterator first, InputIterator last) {
-        list tmp(first, last);
+        list tmp(first, last, get_allocator());
         if (tmp.empty()) { return position; }
         iterator it = tmp.begin();
         splice(position, tmp);
@@ -395,9 +462,11 @@ public: // member functions
         return last;
     }
 
+    // 分配器不传播时, 两个容器的分配器必须相等
     void swap(list& x) {
-        mystl::swap(node_, x.node_);
-        mystl::swap(size_, x.size_);
+        MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || get_alloc() == x.get_alloc());
+        alloc_traits::swap(get_alloc(), x.get_alloc());
+        swap_data(x);
     }
 
     void resize(size_type n) {
@@ -502,7 +571,7 @@ public: // member functions
     }
     template <class Compare>
     void merge(list&& x, Compare comp) {
-        if (*this == x) { return; }
+        if (this == &x) { return; }
         auto first1 = begin();
         auto last1 = end();
         auto first2 = x.begin();
@@ -525,37 +594,44 @@ public: // member functions
         sort(mystl::less<value_type>());
     }
     // (2)
+    // 自底向上的归并排序: 先断开成以 nullptr 结尾的单链表, bins[i] 保存长度为 2^i 的有序段,
+    // 像二进制加法一样逐个并入新节点, 只调整指针, 不申请临时链表
     template <class Compare>
     void sort(Compare comp) {
         if (size() <= 1) { return; } // 长度等于 0 或者 1 不进行处理
-        list carry;
-        list tmp[64]; // 按序号保存归并排序后list, 有序链表长度次幂级增长 1-2-4-8-...
-        list* fill = tmp;
-        list* counter;
-        try {
-            do {
-                carry.splice(carry.begin(), *this, begin()); // 每次将第一个节点拼接到carry
-                for (counter = tmp; counter != fill && !counter->empty(); ++counter) {
-                    counter->merge(carry, comp); // 把carry按从小到大合并到counter(tmp[i](中, carry被置空
-                    carry.swap(*counter);        // 已经排好序的counter放入到carry中,counter被置空
-                }
-                carry.swap(*counter); // carry中内容放入tmp[j](j是循环结束序列)中, carry被置空
-                if (counter == fill) {
-                    ++fill;
-                }
-            } while (!empty());
-            // 拼接归并后的链表
-            for (counter = tmp + 1; counter != fill; ++counter) {
-                counter->merge(*(counter - 1), comp);
-                swap(*(fill - 1));
+        node_pointer bins[64] = {};
+        int fill = 0;
+        node_pointer cur = node_->next_;
+        node_->prev_->next_ = nullptr;
+        while (cur != nullptr) {
+            node_pointer carry = cur;
+            cur = cur->next_;
+            carry->next_ = nullptr;
+            int i = 0;
+            for (; i < fill && bins[i] != nullptr; ++i) {
+                carry = merge_nodes(bins[i], carry, comp); // bins[i] 中的元素在前, 保证稳定
+                bins[i] = nullptr;
             }
-        } catch (...) {
-            this->splice(this->end(), carry);
-            for (int i = 0; i < sizeof(tmp) / sizeof(tmp[0]); ++i) {
-                this->splice(this->end(), tmp[i]);
-                throw;
+            bins[i] = carry;
+            if (i == fill) {
+                ++fill;
             }
         }
+        node_pointer result = nullptr;
+        for (int i = 0; i < fill; ++i) {
+            if (bins[i] != nullptr) {
+                result = result == nullptr ? bins[i] : merge_nodes(bins[i], result, comp);
+            }
+        }
+        // 重建 prev_ 指针和环
+        node_pointer prev = node_;
+        for (node_pointer p = result; p != nullptr; p = p->next_) {
+            p->prev_ = prev;
+            prev = p;
+        }
+        prev->next_ = node_;
+        node_->prev_ = prev;
+        node_->next_ = result;
     }
 
     void reverse() noexcept {
@@ -563,15 +639,40 @@ public: // member functions
     }
 
     allocator_type get_allocator() const noexcept {
-        return allocator_type();
+        return allocator_type(get_alloc());
     }
 
 private:
     void init_node() {
-        node_ = node_allocator::allocate(1);
+        node_ = get_alloc().allocate(1);
         node_->init();
     }
 
+    // 只交换数据, 分配器不变; 调用方保证两者分配器相等
+    void swap_data(list& x) noexcept {
+        mystl::swap(node_, x.node_);
+        mystl::swap(size_, x.size_);
+    }
+
+    // 合并两个以 nullptr 结尾的有序单链表, 相等时 a 中的元素在前
+    template <class Compare>
+    static node_pointer merge_nodes(node_pointer a, node_pointer b, Compare& comp) {
+        node_pointer result = nullptr;
+        node_pointer* tail = &result;
+        while (a != nullptr && b != nullptr) {
+            if (comp(b->data_, a->data_)) {
+                *tail = b;
+                b = b->next_;
+            } else {
+                *tail = a;
+                a = a->next_;
+            }
+            tail = &(*tail)->next_;
+        }
+        *tail = a != nullptr ? a : b;
+        return result;
+    }
+
     void fill_initialize(size_type n, const_reference val) {
         init_node();
         for (; n; --n) {
@@ -589,20 +690,25 @@ private:
 
     template <typename... Args>
     node_pointer create_node(Args... args) {
-        auto p = node_allocator::allocate(1);
-        node_allocator::construct(p, mystl::forward<Args>(args)...);
+        auto p = get_alloc().allocate(1);
+        try {
+            get_alloc().construct(p, mystl::forward<Args>(args)...);
+        } catch (...) {
+            get_alloc().deallocate(p, 1);
+            throw;
+        }
         return p;
     }
 
     void delete_node(iterator pos) {
-        node_allocator::destroy(pos.node_);
-        node_allocator::deallocate(pos.node_, 1);
+        get_alloc().destroy(pos.node_);
+        get_alloc().deallocate(pos.node_, 1);
     }
 
     void fill_assign(size_type n, const value_type& val) {
         auto cur = begin();
         for (; cur != end() && n > 0; ++cur, --n) {
-            *cur = *val;
+            *cur = val;
         }
         if (n > 0) {
             insert(end(), n, val);
@@ -34,6 +34,8 @@ public: // member types
     using const_iterator = typename rep_type::const_iterator;
     using reverse_iterator = typename rep_type::reverse_iterator;
     using const_reverse_iterator = typename rep_type::const_reverse_iterator;
+    using node_type = typename rep_type::node_type;
+    using insert_return_type = typename rep_type::insert_return_type;
 
 public: // member functions
     /*
@@ -53,7 +55,15 @@ public: // member functions
         const key_compare& comp = key_compare(),
         const allocator_type& alloc = allocator_type()) :
         rb_tree_(comp, key_alloc_type(alloc)) {
-        // rb_tree_.insert_range_unique(first, last);
+        rb_tree_.insert_range_unique(first, last);
+    }
+    // 区间已按 comp 严格递增, 线性时间建树
+    template <class InputIterator>
+    set(sorted_unique_t, InputIterator first, InputIterator last,
+        const key_compare& comp = key_compare(),
+        const allocator_type& alloc = allocator_type()) :
+        rb_tree_(comp, key_alloc_type(alloc)) {
+        rb_tree_.insert_range_unique(sorted_unique, first, last);
     }
     // copy(3)
     set(const set& x) = default;
@@ -176,11 +186,39 @@ public: // member functions
     void insert(InputIterator first, InputIterator last) {
         rb_tree_.insert_range_unique(first, last);
     }
+    template <class InputIterator>
+    void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+        rb_tree_.insert_range_unique(sorted_unique, first, last);
+    }
     // initializer SET (4)
     void insert(std::initializer_list<value_type> il) {
         rb_tree_.insert_range_unique(il.begin(), il.end());
     }
 
+    // node handle (5): 挂上 extract 摘下的结点, 不申请内存; 键已存在时结点留在返回值的 node 中
+    insert_return_type insert(node_type&& nh) {
+        return rb_tree_.insert_unique(mystl::move(nh));
+    }
+    // 提示被忽略, 按键查找插入位置
+    iterator insert(const_iterator, node_type&& nh) {
+        return rb_tree_.insert_unique(mystl::move(nh)).position;
+    }
+
+    // 从树上摘下结点交给句柄, 不释放内存; 改键后再 insert 回来即可就地改键
+    node_type extract(const_iterator position) {
+        return rb_tree_.extract(position);
+    }
+    node_type extract(const key_type& k) {
+        return rb_tree_.extract(k);
+    }
+    // 把 source 中本容器没有的键连同结点一起移过来, 其余留在 source 中; 两者的分配器必须相等
+    void merge(set& source) {
+        rb_tree_.merge_unique(source.rb_tree_);
+    }
+    void merge(set&& source) {
+        rb_tree_.merge_unique(source.rb_tree_);
+    }
+
     iterator erase(const_iterator position) {
         return rb_tree_.erase(position);
     }
@@ -238,6 +276,45 @@ public: // member functions
     mystl::pair<iterator, iterator> equal_range(const value_type& val) {
         return rb_tree_.equal_range(val);
     }
+
+    // 异构查找, 仅当 Compare::is_transparent 存在时可用 (例如 less<>), 不必先构造出 key_type
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator find(const K& k) {
+        return rb_tree_.find(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator find(const K& k) const {
+        return rb_tree_.find(k);
+    }
+    // 异构比较下可能有多个元素与 k 等价
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    size_type count(const K& k) const {
+        return rb_tree_.count(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const K& k) {
+        return rb_tree_.lower_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const K& k) const {
+        return rb_tree_.lower_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const K& k) {
+        return rb_tree_.upper_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const K& k) const {
+        return rb_tree_.upper_bound(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    mystl::pair<iterator, iterator> equal_range(const K& k) {
+        return rb_tree_.equal_range(k);
+    }
+    template <class K, class C = Compare, typename = typename C::is_transparent>
+    mystl::pair<const_iterator, const_iterator> equal_range(const K& k) const {
+        return rb_tree_.equal_range(k);
+    }
 };
 } // namespace mystl
 #endif // MYSTL_SET_H_
@@ -0,0 +1,724 @@
+#ifndef MYSTL_SMALL_VECTOR_H_
+#define MYSTL_SMALL_VECTOR_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <initializer_list>
+#include "allocator.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "functexcept.h"
+
+namespace mystl {
+
+/*
+ * small_vector: 前 N 个元素放在对象内部的缓冲区中, 不申请堆内存;
+ * 超过 N 个之后和 vector 一样向分配器申请连续内存. 接口与 mystl::vector 相同.
+ * 元素在内部缓冲区时移动和交换需要逐个搬移元素, 迭代器随之失效.
+ */
+template <typename T, std::size_t N, typename Alloc = mystl::allocator<T>>
+class small_vector : private mystl::allocator_holder<Alloc> {
+    static_assert(N > 0, "small_vector needs at least one inline element");
+
+public: // member types
+    using allocator_type = Alloc;
+
+    using value_type = typename allocator_type::value_type;
+    using pointer = typename allocator_type::pointer;
+    using const_pointer = typename allocator_type::const_pointer;
+    using reference = typename allocator_type::reference;
+    using const_reference = typename allocator_type::const_reference;
+    using size_type = typename allocator_type::size_type;
+    using difference_type = typename allocator_type::difference_type;
+
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = mystl::reverse_iterator<iterator>;
+    using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
+
+private:
+    using holder_type = mystl::allocator_holder<Alloc>;
+    using alloc_traits = mystl::allocator_traits<T, Alloc>;
+    using holder_type::get_alloc;
+
+public: // member functions
+    /*
+     * @brief Constructor and Destructor
+     */
+    explicit small_vector(const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
+        reset_inline();
+    }
+    explicit small_vector(size_type n, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
+        reset_inline();
+        fill_initialize(n, T());
+    }
+    small_vector(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
+        reset_inline();
+        fill_initialize(n, val);
+    }
+    template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    small_vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
+        reset_inline();
+        assign(first, last);
+    }
+
+    small_vector(const small_vector& x) :
+        holder_type(alloc_traits::select_on_container_copy_construction(x.get_alloc())) {
+        reset_inline();
+        range_initialize(x.begin_, x.end_);
+    }
+    small_vector(const small_vector& x, const allocator_type& alloc) :
+        holder_type(alloc) {
+        reset_inline();
+        range_initialize(x.begin_, x.end_);
+    }
+    small_vector(small_vector&& x) :
+        holder_type(mystl::move(x.get_alloc())) {
+        reset_inline();
+        take_from(x);
+    }
+    small_vector(small_vector&& x, const allocator_type& alloc) :
+        holder_type(alloc) {
+        reset_inline();
+        take_from(x);
+    }
+    small_vector(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
+        reset_inline();
+        range_initialize(il.begin(), il.end());
+    }
+
+    ~small_vector() {
+        get_alloc().destroy(begin_, end_);
+        deallocate_storage();
+    }
+
+    small_vector& operator=(const small_vector& x) {
+        if (&x != this) {
+            if (alloc_traits::propagate_on_container_copy_assignment::value && get_alloc() != x.get_alloc()) {
+                // 旧内存必须由旧分配器释放
+                clear();
+                deallocate_storage();
+                reset_inline();
+            }
+            alloc_traits::copy_assign(get_alloc(), x.get_alloc());
+            range_assign(x.begin_, x.end_, mystl::forward_iterator_tag());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& x) {
+        if (&x == this) {
+            return *this;
+        }
+        clear();
+        if (alloc_traits::propagate_on_container_move_assignment::value && get_alloc() != x.get_alloc()) {
+            deallocate_storage();
+            reset_inline();
+            alloc_traits::move_assign(get_alloc(), x.get_alloc());
+        } else if (!x.is_inline() && get_alloc() == x.get_alloc()) {
+            // 接管 x 的堆内存, 自己的先释放
+            deallocate_storage();
+            reset_inline();
+        }
+        take_from(x);
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<value_type> il) {
+        assign(il.begin(), il.end());
+        return *this;
+    }
+
+    /*
+     * @brief Iterators
+     */
+    iterator begin() noexcept {
+        return begin_;
+    }
+    iterator end() noexcept {
+        return end_;
+    }
+    const_iterator begin() const noexcept {
+        return begin_;
+    }
+    const_iterator end() const noexcept {
+        return end_;
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    /*
+     * @brief Capacity
+     */
+    size_type size() const noexcept {
+        return static_cast<size_type>(end_ - begin_);
+    }
+
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(value_type);
+    }
+
+    void resize(size_type n) {
+        resize(n, value_type());
+    }
+
+    void resize(size_type n, const value_type& val) {
+        if (n >= size()) {
+            fill_insert(end_, n - size(), val);
+        } else {
+            erase(begin_ + n, end_);
+        }
+    }
+
+    // 新增的元素默认初始化而不是值初始化: 平凡类型不清零
+    void resize_default_init(size_type n) {
+        if (n > size()) {
+            const size_type count = n - size();
+            if (static_cast<size_type>(capacity_ - end_) >= count) {
+                end_ = mystl::uninitialized_default_construct_n(end_, count);
+            } else {
+                realloc_gap(end_, count, [&](iterator gap) { mystl::uninitialized_default_construct_n(gap, count); });
+            }
+        } else {
+            erase(begin_ + n, end_);
+        }
+    }
+
+    // 只用于平凡类型, 新增的元素保持未初始化, 读取前必须先写入
+    void resize_uninitialized(size_type n) {
+        static_assert(std::is_trivial<T>::value, "resize_uninitialized requires a trivial value_type");
+        resize_default_init(n);
+    }
+
+    size_type capacity() const noexcept {
+        return static_cast<size_type>(capacity_ - begin_);
+    }
+
+    bool empty() const noexcept {
+        return begin_ == end_;
+    }
+
+    void reserve(size_type n) {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "small_vector<T, N>'s size too big");
+        if (n > capacity()) {
+            grow(n);
+        }
+    }
+
+    // 元素放得回内部缓冲区时搬回去并释放堆内存
+    void shrink_to_fit() {
+        if (is_inline() || end_ == capacity_) {
+            return;
+        }
+        if (size() <= N) {
+            iterator new_end = relocate_to(begin_, end_, inline_begin());
+            deallocate_storage();
+            reset_inline();
+            end_ = new_end;
+        } else {
+            grow(size());
+        }
+    }
+
+    // 元素是否还在对象内部的缓冲区中
+    bool is_inline() const noexcept {
+        return begin_ == inline_begin();
+    }
+
+    static constexpr size_type inline_capacity() noexcept {
+        return N;
+    }
+
+    /*
+     * @brief Element access
+     */
+    reference operator[](size_type n) {
+        return *(begin_ + n);
+    }
+    const_reference operator[](size_type n) const {
+        return *(begin_ + n);
+    }
+
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(n >= size(), "small_vector.at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(n >= size(), "small_vector.at");
+        return (*this)[n];
+    }
+
+    reference front() {
+        return *begin();
+    }
+    const_reference front() const {
+        return *begin();
+    }
+
+    reference back() {
+        return *(end() - 1);
+    }
+    const_reference back() const {
+        return *(end() - 1);
+    }
+
+    pointer data() noexcept {
+        return begin_;
+    }
+    const_pointer data() const noexcept {
+        return begin_;
+    }
+
+    /*
+     * @brief Modifiers
+     */
+    template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void assign(InputIterator first, InputIterator last) {
+        range_assign(first, last, mystl::iterator_category(first));
+    }
+    void assign(size_type n, const value_type& val) {
+        fill_assign(n, val);
+    }
+    void assign(std::initializer_list<value_type> il) {
+        range_assign(il.begin(), il.end(), mystl::forward_iterator_tag());
+    }
+
+    void push_back(const value_type& val) {
+        emplace_back(val);
+    }
+
+    void push_back(value_type&& val) {
+        emplace_back(mystl::move(val));
+    }
+
+    // 调用方已经 reserve 出足够的容量, 这里不再检查
+    void unchecked_push_back(const value_type& val) {
+        MYSTL_DEBUG(end_ != capacity_);
+        get_alloc().construct(end_, val);
+        ++end_;
+    }
+
+    void unchecked_push_back(value_type&& val) {
+        MYSTL_DEBUG(end_ != capacity_);
+        get_alloc().construct(end_, mystl::move(val));
+        ++end_;
+    }
+
+    // 追加 [first, last): 前向迭代器只计算一次长度, 至多扩容一次
+    template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void append(InputIterator first, InputIterator last) {
+        range_insert(end_, first, last, mystl::iterator_category(first));
+    }
+
+    void pop_back() {
+        --end_;
+        get_alloc().destroy(end_);
+    }
+
+    iterator insert(const_iterator position, const value_type& val) {
+        return emplace(position, val);
+    }
+    iterator insert(const_iterator position, size_type n, const value_type& val) {
+        return fill_insert(const_cast<iterator>(position), n, val);
+    }
+    template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    iterator insert(const_iterator position, InputIterator first, InputIterator last) {
+        return range_insert(const_cast<iterator>(position), first, last, mystl::iterator_category(first));
+    }
+    iterator insert(const_iterator position, value_type&& val) {
+        return emplace(position, mystl::move(val));
+    }
+    iterator insert(const_iterator position, std::initializer_list<value_type> il) {
+        return range_insert(const_cast<iterator>(position), il.begin(), il.end(), mystl::forward_iterator_tag());
+    }
+
+    iterator erase(iterator position) {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(iterator first, iterator last) {
+        if (first == last) {
+            return first;
+        }
+        if (RELOCATABLE) {
+            get_alloc().destroy(first, last);
+            end_ = mystl::uninitialized_relocate(last, end_, first);
+            return first;
+        }
+        auto new_end = mystl::move(last, end_, first);
+        get_alloc().destroy(new_end, end_);
+        end_ = new_end;
+        return first;
+    }
+
+    // 两边都在堆上时只交换指针, 否则通过移动交换元素
+    void swap(small_vector& rhs) {
+        if (this == &rhs) {
+            return;
+        }
+        MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || get_alloc() == rhs.get_alloc());
+        if (!is_inline() && !rhs.is_inline()) {
+            alloc_traits::swap(get_alloc(), rhs.get_alloc());
+            mystl::swap(begin_, rhs.begin_);
+            mystl::swap(end_, rhs.end_);
+            mystl::swap(capacity_, rhs.capacity_);
+            return;
+        }
+        small_vector tmp(mystl::move(rhs));
+        rhs = mystl::move(*this);
+        *this = mystl::move(tmp);
+    }
+
+    void clear() {
+        get_alloc().destroy(begin_, end_);
+        end_ = begin_;
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        return emplace_aux(const_cast<iterator>(position), mystl::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        if (end_ != capacity_) {
+            get_alloc().construct(end_, mystl::forward<Args>(args)...);
+            ++end_;
+        } else {
+            realloc_gap(end_, 1, [&](iterator gap) { get_alloc().construct(gap, mystl::forward<Args>(args)...); });
+        }
+    }
+
+    /*
+     * @brief Allocator
+     */
+    allocator_type get_allocator() const noexcept {
+        return get_alloc();
+    }
+
+private:
+    // 可平凡重定位的元素在扩容、插入和删除时整块 memmove, 旧位置不再析构
+    static constexpr bool RELOCATABLE = mystl::is_trivially_relocatable<T>::value;
+
+    pointer inline_begin() noexcept {
+        return reinterpret_cast<pointer>(buffer_);
+    }
+    const_pointer inline_begin() const noexcept {
+        return reinterpret_cast<const_pointer>(buffer_);
+    }
+
+    void reset_inline() noexcept {
+        begin_ = end_ = inline_begin();
+        capacity_ = begin_ + N;
+    }
+
+    // 只释放内存, 元素由调用方析构
+    void deallocate_storage() {
+        if (!is_inline()) {
+            get_alloc().deallocate(begin_, capacity());
+        }
+    }
+
+    // 调用方保证 *this 为空; 分配器相等时直接接管 x 的堆内存, 否则逐个搬移元素
+    void take_from(small_vector& x) {
+        if (!x.is_inline() && get_alloc() == x.get_alloc()) {
+            deallocate_storage();
+            begin_ = x.begin_;
+            end_ = x.end_;
+            capacity_ = x.capacity_;
+            x.reset_inline();
+            return;
+        }
+        reserve(x.size());
+        end_ = relocate_to(x.begin_, x.end_, begin_);
+        x.end_ = x.begin_;
+    }
+
+    // 把 [first, last) 搬到未初始化的 result 处并析构原元素;
+    // 不可平凡重定位时逐个移动构造, 失败时已构造的部分被析构, 原元素保持不变
+    iterator relocate_to(iterator first, iterator last, iterator result) {
+        if (RELOCATABLE) {
+            return mystl::uninitialized_relocate(first, last, result);
+        }
+        iterator cur = mystl::uninitialized_move(first, last, result);
+        get_alloc().destroy(first, last);
+        return cur;
+    }
+
+    // 换到容量为 len 的堆内存上
+    void grow(size_type len) {
+        iterator new_begin = get_alloc().allocate(len);
+        iterator new_end;
+        try {
+            new_end = relocate_to(begin_, end_, new_begin);
+        } catch (...) {
+            get_alloc().deallocate(new_begin, len);
+            throw;
+        }
+        deallocate_storage();
+        begin_ = new_begin;
+        end_ = new_end;
+        capacity_ = new_begin + len;
+    }
+
+    size_type check_len(size_type n) const {
+        THROW_LENGTH_ERROR_IF(max_size() - size() < n, "small_vector<T, N>'s size too big");
+        const size_type len = size() + mystl::max(size(), n);
+        return (len < size() || len > max_size()) ? max_size() : len;
+    }
+
+    void fill_initialize(size_type n, const_reference val) {
+        reserve(n);
+        end_ = mystl::uninitialized_fill_n(begin_, n, val);
+    }
+
+    template <class ForwardIterator>
+    void range_initialize(ForwardIterator first, ForwardIterator last) {
+        reserve(static_cast<size_type>(mystl::distance(first, last)));
+        end_ = mystl::uninitialized_copy(first, last, begin_);
+    }
+
+    void fill_assign(size_type n, const value_type& val) {
+        if (n > capacity()) {
+            const value_type tmp(val); // val 可能是容器中的元素
+            clear();
+            reserve(n);
+            end_ = mystl::uninitialized_fill_n(begin_, n, tmp);
+        } else if (n > size()) {
+            mystl::fill(begin_, end_, val);
+            end_ = mystl::uninitialized_fill_n(end_, n - size(), val);
+        } else {
+            mystl::fill(begin_, begin_ + n, val);
+            erase(begin_ + n, end_);
+        }
+    }
+
+    template <class InputIterator>
+    void range_assign(InputIterator first, InputIterator last, mystl::input_iterator_tag) {
+        auto cur = begin_;
+        for (; first != last && cur != end_; ++cur, ++first) {
+            *cur = *first;
+        }
+        if (first == last) {
+            erase(cur, end_);
+        } else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    template <class ForwardIterator>
+    void range_assign(ForwardIterator first, ForwardIterator last, mystl::forward_iterator_tag) {
+        const size_type len = static_cast<size_type>(mystl::distance(first, last));
+        if (len > capacity()) {
+            clear();
+            reserve(len);
+            end_ = mystl::uninitialized_copy(first, last, begin_);
+        } else if (len > size()) {
+            auto mid = first;
+            mystl::advance(mid, size());
+            mystl::copy(first, mid, begin_);
+            end_ = mystl::uninitialized_copy(mid, last, end_);
+        } else {
+            erase(mystl::copy(first, last, begin_), end_);
+        }
+    }
+
+    // 申请新内存, 先在 pos 对应的位置由 fill 构造 n 个新元素, 再把原有元素搬到两侧;
+    // 先构造新元素, 所以新元素可以引用容器中原有的元素. fill 抛出异常时自行析构已构造的部分
+    template <class Fill>
+    void realloc_gap(iterator pos, size_type n, Fill fill) {
+        const size_type len = check_len(n);
+        iterator new_begin = get_alloc().allocate(len);
+        iterator gap = new_begin + (pos - begin_);
+        try {
+            fill(gap);
+        } catch (...) {
+            get_alloc().deallocate(new_begin, len);
+            throw;
+        }
+        iterator new_end = relocate_around(pos, gap, n, new_begin, len, mystl::is_trivially_relocatable<T>());
+        deallocate_storage();
+        begin_ = new_begin;
+        end_ = new_end;
+        capacity_ = new_begin + len;
+    }
+
+    // 可平凡重定位时按字节搬走, 不会抛出异常
+    iterator relocate_around(iterator pos, iterator gap, size_type n, iterator new_begin, size_type, std::true_type) {
+        mystl::uninitialized_relocate(begin_, pos, new_begin);
+        return mystl::uninitialized_relocate(pos, end_, gap + n);
+    }
+
+    // 逐个移动构造, 全部成功之后才析构原有元素, 失败时原容器不变
+    iterator relocate_around(iterator pos, iterator gap, size_type n, iterator new_begin, size_type len,
+                             std::false_type) {
+        try {
+            mystl::uninitialized_move(begin_, pos, new_begin);
+        } catch (...) {
+            get_alloc().destroy(gap, gap + n);
+            get_alloc().deallocate(new_begin, len);
+            throw;
+        }
+        iterator new_end;
+        try {
+            new_end = mystl::uninitialized_move(pos, end_, gap + n);
+        } catch (...) {
+            get_alloc().destroy(new_begin, gap + n);
+            get_alloc().deallocate(new_begin, len);
+            throw;
+        }
+        get_alloc().destroy(begin_, end_);
+        return new_end;
+    }
+
+    // 备用空间足够时在 pos 处空出 n 个未初始化的位置, 由 fill 构造新元素;
+    // 可平凡重定位时整块后移, 否则像 vector 一样逐个移动
+    template <class Fill>
+    void open_gap(iterator pos, size_type n, Fill fill) {
+        if (RELOCATABLE) {
+            mystl::uninitialized_relocate(pos, end_, pos + n);
+            try {
+                fill(pos);
+            } catch (...) {
+                mystl::uninitialized_relocate(pos + n, end_ + n, pos);
+                throw;
+            }
+            end_ += n;
+            return;
+        }
+        const size_type elems_after = static_cast<size_type>(end_ - pos);
+        if (elems_after > n) {
+            mystl::uninitialized_move(end_ - n, end_, end_);
+            mystl::move_backward(pos, end_ - n, end_);
+            get_alloc().destroy(pos, pos + n);
+        } else {
+            mystl::uninitialized_move(pos, end_, pos + n);
+            get_alloc().destroy(pos, end_);
+        }
+        // 此时 [pos, pos + n) 未初始化; fill 失败时丢弃 pos 之后的元素, 保证容器仍可析构
+        try {
+            fill(pos);
+        } catch (...) {
+            get_alloc().destroy(pos + n, end_ + n);
+            end_ = pos;
+            throw;
+        }
+        end_ += n;
+    }
+
+    template <class Fill>
+    iterator insert_gap(iterator pos, size_type n, Fill fill) {
+        const size_type elems_before = static_cast<size_type>(pos - begin_);
+        if (n == 0) {
+            return pos;
+        }
+        if (static_cast<size_type>(capacity_ - end_) >= n) {
+            open_gap(pos, n, fill);
+        } else {
+            realloc_gap(pos, n, fill);
+        }
+        return begin_ + elems_before;
+    }
+
+    iterator fill_insert(iterator pos, size_type n, const value_type& val) {
+        const value_type tmp(val); // val 可能是容器中被搬走的元素
+        return insert_gap(pos, n, [&](iterator gap) { mystl::uninitialized_fill_n(gap, n, tmp); });
+    }
+
+    template <class InputIterator>
+    iterator range_insert(iterator pos, InputIterator first, InputIterator last, mystl::input_iterator_tag) {
+        if (pos == end_) {
+            const size_type elems_before = size();
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+            return begin_ + elems_before;
+        }
+        small_vector tmp(get_alloc());
+        for (; first != last; ++first) {
+            tmp.emplace_back(*first);
+        }
+        return range_insert(pos, tmp.begin_, tmp.end_, mystl::forward_iterator_tag());
+    }
+
+    template <class ForwardIterator>
+    iterator range_insert(iterator pos, ForwardIterator first, ForwardIterator last, mystl::forward_iterator_tag) {
+        const size_type n = static_cast<size_type>(mystl::distance(first, last));
+        return insert_gap(pos, n, [&](iterator gap) { mystl::uninitialized_copy(first, last, gap); });
+    }
+
+    template <class... Args>
+    iterator emplace_aux(iterator pos, Args&&... args) {
+        if (pos == end_ && end_ != capacity_) {
+            get_alloc().construct(end_, mystl::forward<Args>(args)...);
+            ++end_;
+            return pos;
+        }
+        if (end_ == capacity_) {
+            return insert_gap(pos, 1, [&](iterator gap) { get_alloc().construct(gap, mystl::forward<Args>(args)...); });
+        }
+        value_type tmp(mystl::forward<Args>(args)...); // 实参可能引用容器中被搬走的元素
+        return insert_gap(pos, 1, [&](iterator gap) { get_alloc().construct(gap, mystl::move(tmp)); });
+    }
+
+private:
+    iterator begin_;
+    iterator end_;
+    iterator capacity_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer_[N];
+};
+
+template <class T, std::size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+    if (lhs.size() != rhs.size()) { return false; }
+    return mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, std::size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class T, std::size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+    return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, std::size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& x, small_vector<T, N, Alloc>& y) {
+    x.swap(y);
+}
+
+} // namespace mystl
+
+#endif // MYSTL_SMALL_VECTOR_H_
@@ -8,11 +8,12 @@
 #include "iterator.h"
 #include "construct.h"
 #include "uninitialized.h"
+#include "functexcept.h"
 
 namespace mystl {
 
 template <typename T, typename Alloc = mystl::allocator<T>>
-class vector {
+class vector : private mystl::allocator_holder<Alloc> {
 public: // member types
     using allocator_type = Alloc;
 
@@ -31,65 +32,90 @@ public: // member types
 
     using data_allocator = Alloc; // 内存管理
 
+private:
+    using holder_type = mystl::allocator_holder<Alloc>;
+    using alloc_traits = mystl::allocator_traits<T, Alloc>;
+    using holder_type::get_alloc;
+
 public: // member functions
     /*
      * @brief Constructor and Destructor
      */
     // default (1)
     explicit vector(const allocator_type& alloc = allocator_type()) :
-        begin_(0),
-        end_(0), capacity_(0) {
+        holder_type(alloc), begin_(0), end_(0), capacity_(0) {
     }
     // fill (2)
-    explicit vector(size_type n) {
+    explicit vector(size_type n, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         fill_initialize(n, T());
     }
-    vector(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) {
+    vector(size_type n, const value_type& val, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         fill_initialize(n, val);
     }
     // range (3)
     template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
-    vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) {
+    vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         range_initialize(first, last);
     }
 
     // copy (4)
-    vector(const vector& x) {
+    vector(const vector& x) :
+        holder_type(alloc_traits::select_on_container_copy_construction(x.get_alloc())) {
         range_initialize(x.begin_, x.end_);
     }
-    vector(const vector& x, const allocator_type& alloc) {
+    vector(const vector& x, const allocator_type& alloc) :
+        holder_type(alloc) {
         range_initialize(x.begin_, x.end_);
     }
     // move (5)
-    vector(vector&& x) {
-        begin_ = mystl::move(x.begin_);
-        end_ = mystl::move(x.end_);
-        capacity_ = mystl::move(x.capacity_);
-    }
-    vector(vector&& x, const allocator_type& alloc) {
+    vector(vector&& x) :
+        holder_type(mystl::move(x.get_alloc())) {
         begin_ = mystl::move(x.begin_);
         end_ = mystl::move(x.end_);
         capacity_ = mystl::move(x.capacity_);
+        x.begin_ = x.end_ = x.capacity_ = nullptr;
+    }
+    // 分配器不同时不能接管 x 的内存, 逐个移动元素
+    vector(vector&& x, const allocator_type& alloc) :
+        holder_type(alloc) {
+        if (get_alloc() == x.get_alloc()) {
+            begin_ = mystl::move(x.begin_);
+            end_ = mystl::move(x.end_);
+            capacity_ = mystl::move(x.capacity_);
+            x.begin_ = x.end_ = x.capacity_ = nullptr;
+        } else {
+            move_initialize(x.begin_, x.end_);
+        }
     }
     // initializer list (6)
-    vector(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) {
+    vector(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type()) :
+        holder_type(alloc) {
         range_initialize(il.begin(), il.end());
     }
 
     ~vector() {
-        destructor(begin_, end_, capacity_ - end_);
+        destructor(begin_, end_, capacity());
     }
 
     // copy (1)
     vector& operator=(const vector& x) {
-        if (x != this) {
+        if (&x != this) {
+            if (alloc_traits::propagate_on_container_copy_assignment::value && get_alloc() != x.get_alloc()) {
+                // 旧内存必须由旧分配器释放
+                destructor(begin_, end_, capacity());
+                begin_ = end_ = capacity_ = nullptr;
+            }
+            alloc_traits::copy_assign(get_alloc(), x.get_alloc());
             const auto len = x.size();
             if (len > capacity()) {
-                vector tmp(x);
-                swap(tmp);
+                vector tmp(x, get_alloc());
+                swap_data(tmp);
             } else if (len <= size()) {
                 auto cur = mystl::copy(x.begin_, x.end_, begin_);
-                data_allocator::destroy(cur, end_);
+                get_alloc().destroy(cur, end_);
                 end_ = cur;
             } else {
                 mystl::copy(x.begin_, x.begin_ + size(), begin_);
@@ -102,20 +128,32 @@ public: // member functions
 
     // move (2)
     vector& operator=(vector&& x) {
-        destructor(begin_, end_, capacity_ - end_);
-        begin_ = x.begin_;
-        end_ = x.end_;
-        capacity_ = x.capacity_;
-        x.begin_ = nullptr;
-        x.end_ = nullptr;
-        x.capacity_ = nullptr;
+        if (&x == this) {
+            return *this;
+        }
+        if (alloc_traits::propagate_on_container_move_assignment::value || get_alloc() == x.get_alloc()) {
+            destructor(begin_, end_, capacity());
+            alloc_traits::move_assign(get_alloc(), x.get_alloc());
+            begin_ = x.begin_;
+            end_ = x.end_;
+            capacity_ = x.capacity_;
+            x.begin_ = nullptr;
+            x.end_ = nullptr;
+            x.capacity_ = nullptr;
+        } else {
+            // 分配器不同且不传播, 只能逐个移动元素
+            destructor(begin_, end_, capacity());
+            begin_ = end_ = capacity_ = nullptr;
+            move_initialize(x.begin_, x.end_);
+            x.clear();
+        }
         return *this;
     }
 
     // initializer list (3)
     vector& operator=(std::initializer_list<value_type> il) {
-        vector tmp(il.begin(), il.end());
-        swap(tmp);
+        vector tmp(il.begin(), il.end(), get_alloc());
+        swap_data(tmp);
         return *this;
     }
 
@@ -193,6 +231,21 @@ public: // member functions
         }
     }
 
+    // 新增的元素默认初始化而不是值初始化: 平凡类型不清零, 适合随后直接写入数据的场景
+    void resize_default_init(size_type n) {
+        if (n > size()) {
+            default_append(n - size());
+        } else {
+            erase(begin_ + n, end_);
+        }
+    }
+
+    // 只用于平凡类型, 新增的元素保持未初始化, 读取前必须先写入
+    void resize_uninitialized(size_type n) {
+        static_assert(std::is_trivial<T>::value, "resize_uninitialized requires a trivial value_type");
+        resize_default_init(n);
+    }
+
     size_type capacity() const noexcept {
         return size_type(capacity_ - begin_);
     }
@@ -207,9 +260,14 @@ public: // member functions
         }
         if (n > capacity()) {
             const size_type old_size = size();
-            iterator new_begin = data_allocator::allocate(n);
-            mystl::uninitialized_move(begin_, end_, new_begin);
-            destructor(begin_, end_, capacity());
+            iterator new_begin = get_alloc().allocate(n);
+            try {
+                mystl::uninitialized_relocate(begin_, end_, new_begin);
+            } catch (...) {
+                get_alloc().deallocate(new_begin, n);
+                throw;
+            }
+            get_alloc().deallocate(begin_, capacity());
             begin_ = new_begin;
             end_ = new_begin + old_size;
             capacity_ = begin_ + n;
@@ -218,8 +276,9 @@ public: // member functions
 
     void shrink_to_fit() {
         if (end_ < capacity_) {
-            vector tmp(begin_, end_);
-            swap(tmp);
+            vector tmp(get_alloc());
+            tmp.move_initialize(begin_, end_);
+            swap_data(tmp);
         }
     }
 
@@ -278,16 +337,40 @@ public: // member functions
     }
 
     void push_back(const value_type& val) {
-        insert_aux(end_, val); // Optimize: use emplace_back
+        if (end_ != capacity_) {
+            get_alloc().construct(end_, val);
+            ++end_;
+        } else {
+            realloc_insert(end_, val);
+        }
     }
 
     void push_back(value_type&& val) {
         emplace_back(mystl::move(val));
     }
 
+    // 调用方已经 reserve 出足够的容量, 这里不再检查
+    void unchecked_push_back(const value_type& val) {
+        MYSTL_DEBUG(end_ != capacity_);
+        get_alloc().construct(end_, val);
+        ++end_;
+    }
+
+    void unchecked_push_back(value_type&& val) {
+        MYSTL_DEBUG(end_ != capacity_);
+        get_alloc().construct(end_, mystl::move(val));
+        ++end_;
+    }
+
+    // 追加 [first, last): 前向迭代器只计算一次长度, 至多扩容一次
+    template <class InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void append(InputIterator first, InputIterator last) {
+        append_range(first, last, mystl::iterator_category(first));
+    }
+
     void pop_back() {
         --end_;
-        data_allocator::destroy(end_);
+        get_alloc().destroy(end_);
     }
 
     iterator insert(const_iterator position, const value_type& val) {
@@ -313,18 +396,28 @@ public: // member functions
     }
 
     iterator erase(iterator first, iterator last) {
+        // 空区间不动元素, 否则下面会把元素自己移动赋值给自己
+        if (first == last) {
+            return first;
+        }
+        if (RELOCATABLE) {
+            get_alloc().destroy(first, last);
+            end_ = mystl::uninitialized_relocate(last, end_, first);
+            return first;
+        }
         mystl::move(last, end_, first); // FIXME
         auto new_end = end_ - (last - first);
-        data_allocator::destroy(new_end, end_);
+        get_alloc().destroy(new_end, end_);
         end_ = new_end;
         return first;
     }
 
+    // 分配器不传播时, 两个容器的分配器必须相等
     void swap(vector& rhs) {
         if (this != &rhs) {
-            mystl::swap(begin_, rhs.begin_);
-            mystl::swap(end_, rhs.end_);
-            mystl::swap(capacity_, rhs.capacity_);
+            MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value || get_alloc() == rhs.get_alloc());
+            alloc_traits::swap(get_alloc(), rhs.get_alloc());
+            swap_data(rhs);
         }
     }
 
@@ -346,12 +439,22 @@ public: // member functions
      * @brief Allocator
      */
     allocator_type get_allocator() const noexcept {
-        return data_allocator();
+        return get_alloc();
     }
 
 private:
+    // 可平凡重定位的元素在扩容、插入和删除时整块 memmove, 旧位置不再析构
+    static constexpr bool RELOCATABLE = mystl::is_trivially_relocatable<T>::value;
+
+    // 只交换数据, 分配器不变; 调用方保证两者分配器相等
+    void swap_data(vector& rhs) noexcept {
+        mystl::swap(begin_, rhs.begin_);
+        mystl::swap(end_, rhs.end_);
+        mystl::swap(capacity_, rhs.capacity_);
+    }
+
     void fill_initialize(size_type n, const_reference val) {
-        begin_ = data_allocator::allocate(n);
+        begin_ = get_alloc().allocate(n);
         mystl::uninitialized_fill_n(begin_, n, val);
         end_ = begin_ + n;
         capacity_ = end_;
@@ -359,17 +462,25 @@ private:
 
     template <class InputIterator>
     void range_initialize(InputIterator first, InputIterator last) {
-        size_type n = size_type(last - first);
-        begin_ = data_allocator::allocate(n);
+        size_type n = size_type(mystl::distance(first, last));
+        begin_ = get_alloc().allocate(n);
         mystl::uninitialized_copy(first, last, begin_);
         end_ = begin_ + n;
         capacity_ = end_;
     }
 
+    // 在新申请的内存上移动构造 [first, last) 的元素
+    void move_initialize(iterator first, iterator last) {
+        size_type n = size_type(last - first);
+        begin_ = get_alloc().allocate(n);
+        end_ = mystl::uninitialized_move(first, last, begin_);
+        capacity_ = begin_ + n;
+    }
+
     template <class InputIterator>
     void destructor(InputIterator first, InputIterator last, size_type n) {
-        data_allocator::destroy(first, last);
-        data_allocator::deallocate(first, n);
+        get_alloc().destroy(first, last);
+        get_alloc().deallocate(first, n);
     }
 
     size_type check_len(size_type n) const {
@@ -392,8 +503,8 @@ private:
 
     iterator fill_assign(size_type n, const value_type& val) {
         if (n > capacity()) {
-            vector tmp(n, val);
-            swap(tmp);
+            vector tmp(n, val, get_alloc());
+            swap_data(tmp);
         } else if (n > size()) {
             mystl::fill(begin_, end_, val);
             mystl::uninitialized_fill(end_, begin_ + n, val);
@@ -420,8 +531,8 @@ private:
     void range_assign(ForwardIterator first, ForwardIterator last, mystl::forward_iterator_tag) {
         const size_type len = mystl::distance(first, last);
         if (len > capacity()) {
-            vector tmp(first, last);
-            swap(tmp);
+            vector tmp(first, last, get_alloc());
+            swap_data(tmp);
         } else if (len > size()) {
             auto mid = first;
             mystl::advance(mid, size());
@@ -450,7 +561,7 @@ private:
                 insert(end_, *first);
             }
         } else if (first != last) {
-            vector tmp(first, last);
+            vector tmp(first, last, get_alloc());
             insert(pos, tmp.begin_, tmp.end_);
         }
     }
@@ -460,6 +571,10 @@ private:
         if (first == last) { return; }
         const size_type n = mystl::distance(first, last);
         if (static_cast<size_type>(capacity_ - end_) >= n) { // 备用空间足够插入
+            if (RELOCATABLE) {
+                relocate_gap(pos, n, [&](iterator gap) { mystl::uninitialized_copy(first, last, gap); });
+                return;
+            }
             const auto elems_after = end_ - pos;
             if (elems_after > n) {
                 mystl::uninitialized_move(end_ - n, end_, end_); // 移动n个元素到备用空间
@@ -472,30 +587,45 @@ private:
             }
             end_ += n;
         } else { // 空间不足需要申请新内存
-            const size_type len = check_len(n);
-            const size_type elems_before = pos - begin_;
-            iterator new_begin = data_allocator::allocate(len);
-            iterator new_end = new_begin;
-            try {
-                new_end = mystl::uninitialized_move(begin_, pos, new_begin);                  // 插入前的元素移动到新的空间
-                new_end = mystl::uninitialized_copy(first, last, new_begin + elems_before);   // 再填充要插入的元素
-                new_end = mystl::uninitialized_move(pos, end_, new_begin + elems_before + n); // 最后将插入后的元素移动过来
-            } catch (...) {
-                destructor(new_begin, new_end, len);
-                throw;
-            }
-            destructor(begin_, end_, capacity());
-
-            begin_ = new_begin;
-            end_ = new_end;
-            capacity_ = new_begin + len;
+            realloc_gap(pos, n, [&](iterator gap) { mystl::uninitialized_copy(first, last, gap); });
         }
         return;
     }
 
+    void default_append(size_type n) {
+        if (static_cast<size_type>(capacity_ - end_) >= n) {
+            end_ = mystl::uninitialized_default_construct_n(end_, n);
+        } else {
+            realloc_gap(end_, n, [&](iterator gap) { mystl::uninitialized_default_construct_n(gap, n); });
+        }
+    }
+
+    template <class InputIterator>
+    void append_range(InputIterator first, InputIterator last, mystl::input_iterator_tag) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    template <class ForwardIterator>
+    void append_range(ForwardIterator first, ForwardIterator last, mystl::forward_iterator_tag) {
+        const size_type n = static_cast<size_type>(mystl::distance(first, last));
+        if (static_cast<size_type>(capacity_ - end_) >= n) {
+            end_ = mystl::uninitialized_copy(first, last, end_);
+        } else {
+            realloc_gap(end_, n, [&](iterator gap) { mystl::uninitialized_copy(first, last, gap); });
+        }
+    }
+
     iterator fill_insert(iterator pos, size_type n, const value_type& val) {
         if (n == 0) { return pos; }
+        const size_type elems_before = pos - begin_;
         if (static_cast<size_type>(capacity_ - end_) >= n) { // 备用空间足够插入
+            if (RELOCATABLE) {
+                const value_type tmp(val); // val 可能是容器中被搬走的元素
+                relocate_gap(pos, n, [&](iterator gap) { mystl::uninitialized_fill_n(gap, n, tmp); });
+                return begin_ + elems_before;
+            }
             const auto elems_after = end_ - pos;
             if (elems_after > n) {
                 mystl::uninitialized_move(end_ - n, end_, end_); // 移动n个元素到备用空间
@@ -508,86 +638,81 @@ private:
             }
             end_ += n;
         } else { // 空间不足需要申请新内存
-            const size_type len = check_len(n);
-            const size_type elems_before = pos - begin_;
-            iterator new_begin = data_allocator::allocate(len);
-            iterator new_end = new_begin;
-            try {
-                new_end = mystl::uninitialized_move(begin_, pos, new_begin);                  // 插入前的元素移动到新的空间
-                new_end = mystl::uninitialized_fill_n(new_begin + elems_before, n, val);      // 再填充要插入的元素
-                new_end = mystl::uninitialized_move(pos, end_, new_begin + elems_before + n); // 最后将插入后的元素移动过来
-            } catch (...) {
-                destructor(new_begin, new_end, len);
-                throw;
-            }
-            destructor(begin_, end_, capacity());
-
-            begin_ = new_begin;
-            end_ = new_end;
-            capacity_ = new_begin + len;
+            realloc_gap(pos, n, [&](iterator gap) { mystl::uninitialized_fill_n(gap, n, val); });
         }
-        return pos + n;
+        return begin_ + elems_before;
     }
 
-    void realloc_insert(iterator pos, const_reference val) {
-        const size_type len = check_len(1);
-        iterator new_begin = data_allocator::allocate(len);
-        iterator new_end = new_begin;
+    // 申请新内存, 先在 pos 对应的位置由 fill 构造 n 个新元素, 再把原有元素搬到两侧;
+    // 先构造新元素, 所以新元素可以引用容器中原有的元素. fill 抛出异常时自行析构已构造的部分
+    template <class Fill>
+    void realloc_gap(iterator pos, size_type n, Fill fill) {
+        const size_type len = check_len(n);
+        iterator new_begin = get_alloc().allocate(len);
+        iterator gap = new_begin + (pos - begin_);
         try {
-            new_end = mystl::uninitialized_copy(begin_, pos, new_begin);
-            data_allocator::construct(new_end, val);
-            ++new_end;
-            new_end = mystl::uninitialized_copy(pos, end_, new_end);
+            fill(gap);
         } catch (...) {
-            destructor(new_begin, new_end, len);
+            get_alloc().deallocate(new_begin, len);
             throw;
         }
-        destructor(begin_, end_, capacity()); // 移动后的内存可以正常执行析构
+        iterator new_end = relocate_around(pos, gap, n, new_begin, len, mystl::is_trivially_relocatable<T>());
+        get_alloc().deallocate(begin_, capacity());
 
         begin_ = new_begin;
         end_ = new_end;
         capacity_ = new_begin + len;
     }
 
-    iterator insert_aux(iterator pos, const_reference val) {
-        const auto n = pos - begin_;
-        if (end_ != capacity_) {
-            if (pos == end_) {
-                data_allocator::construct(end_, val);
-                ++end_;
-            } else {
-                auto new_end = end_;
-                data_allocator::construct(end_, val);
-                ++new_end;
-                mystl::copy_backward(pos, end_ - 1, end_);
-                *pos = val;
-                end_ = new_end;
-            }
-        } else {
-            realloc_insert(pos, val);
+    // 可平凡重定位时按字节搬走, 不会抛出异常
+    iterator relocate_around(iterator pos, iterator gap, size_type n, iterator new_begin, size_type, std::true_type) {
+        mystl::uninitialized_relocate(begin_, pos, new_begin);
+        return mystl::uninitialized_relocate(pos, end_, gap + n);
+    }
+
+    // 逐个移动构造, 全部成功之后才析构原有元素, 失败时原容器不变
+    iterator relocate_around(iterator pos, iterator gap, size_type n, iterator new_begin, size_type len,
+                             std::false_type) {
+        try {
+            mystl::uninitialized_move(begin_, pos, new_begin);
+        } catch (...) {
+            get_alloc().destroy(gap, gap + n);
+            get_alloc().deallocate(new_begin, len);
+            throw;
         }
-        return begin_ + n;
+        iterator new_end;
+        try {
+            new_end = mystl::uninitialized_move(pos, end_, gap + n);
+        } catch (...) {
+            get_alloc().destroy(new_begin, gap + n);
+            get_alloc().deallocate(new_begin, len);
+            throw;
+        }
+        get_alloc().destroy(begin_, end_);
+        return new_end;
     }
 
-    template <class... Args>
-    void realloc_emplace(iterator pos, Args&&... args) {
-        const size_type len = size() != 0 ? 2 * size() : 1;
-        iterator new_begin = data_allocator::allocate(len);
-        iterator new_end = new_begin;
+    // 原地把 [pos, end_) 向后搬 n 个位置, 再由 fill 在空出的位置构造新元素; 只用于可平凡重定位的类型
+    // fill 抛出异常时把元素搬回原处
+    template <class Fill>
+    void relocate_gap(iterator pos, size_type n, Fill fill) {
+        mystl::uninitialized_relocate(pos, end_, pos + n);
         try {
-            new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-            data_allocator::construct(new_end, mystl::forward<Args>(args)...);
-            ++new_end;
-            new_end = mystl::uninitialized_move(pos, end_, new_end);
+            fill(pos);
         } catch (...) {
-            destructor(new_begin, new_end, len);
+            mystl::uninitialized_relocate(pos + n, end_ + n, pos);
             throw;
         }
-        destructor(begin_, end_, capacity());
+        end_ += n;
+    }
 
-        begin_ = new_begin;
-        end_ = new_end;
-        capacity_ = new_begin + len;
+    void realloc_insert(iterator pos, const_reference val) {
+        realloc_gap(pos, 1, [&](iterator gap) { get_alloc().construct(gap, val); });
+    }
+
+    template <class... Args>
+    void realloc_emplace(iterator pos, Args&&... args) {
+        realloc_gap(pos, 1, [&](iterator gap) { get_alloc().construct(gap, mystl::forward<Args>(args)...); });
     }
 
     template <class... Args>
@@ -595,15 +720,17 @@ private:
         const auto n = pos - begin_;
         if (end_ != capacity_) {
             if (pos == end_) {
-                data_allocator::construct(end_, mystl::forward<Args>(args)...);
+                get_alloc().construct(end_, mystl::forward<Args>(args)...);
                 ++end_;
+            } else if (RELOCATABLE) {
+                value_type tmp(mystl::forward<Args>(args)...);
+                relocate_gap(pos, 1, [&](iterator gap) { get_alloc().construct(gap, mystl::move(tmp)); });
             } else {
-                auto new_end = end_;
-                data_allocator::construct(end_, *(end_ - 1));
-                ++new_end;
-                mystl::copy_backward(pos, end_ - 1, end_);
-                *pos = value_type(mystl::forward<Args>(args)...);
-                end_ = new_end;
+                value_type tmp(mystl::forward<Args>(args)...);
+                get_alloc().construct(end_, mystl::move(*(end_ - 1)));
+                ++end_;
+                mystl::move_backward(pos, end_ - 2, end_ - 1);
+                *pos = mystl::move(tmp);
             }
         } else {
             realloc_emplace(pos, mystl::forward<Args>(args)...);
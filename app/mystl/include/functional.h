@@ -2,6 +2,7 @@
 #define MYSTL_FUNCTIONAL_H_
 
 #include <type_traits>
+#include "utility.h"
 
 namespace mystl {
 
@@ -50,20 +51,75 @@ struct binary_function {
 
 /*
  * Operator classes
+ * 模板参数为 void 时 (写作 less<>) 是透明比较器: 两个参数可以是不同类型, 并定义 is_transparent,
+ * 有序容器据此开放异构查找, 例如 map<std::string, T, less<>> 可以直接用 const char* 查找, 不构造临时的 std::string
+ * 注意省下的是构造键的开销, 比较本身可能变贵: std::string 与 const char* 每次比较都要重新求长度,
+ * 键较短时反而不如先构造一次 std::string; 键的构造需要申请内存或有副作用时才划算
  */
-template <class T>
+template <class T = void>
 struct greater : public binary_function<T, T, bool> {
     bool operator()(const T& x, const T& y) const {
         return x > y;
     }
 };
 
-template <class T>
+template <class T = void>
 struct less : public binary_function<T, T, bool> {
     bool operator()(const T& x, const T& y) const {
         return x < y;
     }
 };
+
+template <class T = void>
+struct equal_to : public binary_function<T, T, bool> {
+    bool operator()(const T& x, const T& y) const {
+        return x == y;
+    }
+};
+
+template <>
+struct greater<void> {
+    typedef void is_transparent;
+    template <class T, class U>
+    auto operator()(T&& x, U&& y) const -> decltype(mystl::forward<T>(x) > mystl::forward<U>(y)) {
+        return mystl::forward<T>(x) > mystl::forward<U>(y);
+    }
+};
+
+template <>
+struct less<void> {
+    typedef void is_transparent;
+    template <class T, class U>
+    auto operator()(T&& x, U&& y) const -> decltype(mystl::forward<T>(x) < mystl::forward<U>(y)) {
+        return mystl::forward<T>(x) < mystl::forward<U>(y);
+    }
+};
+
+template <>
+struct equal_to<void> {
+    typedef void is_transparent;
+    template <class T, class U>
+    auto operator()(T&& x, U&& y) const -> decltype(mystl::forward<T>(x) == mystl::forward<U>(y)) {
+        return mystl::forward<T>(x) == mystl::forward<U>(y);
+    }
+};
+
+/*
+ * Arithmetic operations
+ */
+template <class T>
+struct plus : public binary_function<T, T, T> {
+    T operator()(const T& x, const T& y) const {
+        return x + y;
+    }
+};
+
+template <class T>
+struct multiplies : public binary_function<T, T, T> {
+    T operator()(const T& x, const T& y) const {
+        return x * y;
+    }
+};
 } // namespace mystl
 
 #endif // MYSTL_FUNCTIONAL_H_
@@ -0,0 +1,92 @@
+#ifndef MYSTL_HASH_FUN_H_
+#define MYSTL_HASH_FUN_H_
+
+#include <cstddef>
+#include <string>
+
+namespace mystl {
+// hashtable 使用的哈希函数, 未特化的类型没有定义 operator()
+template <class Key>
+struct hash {};
+
+// 字符串使用 FNV-1a
+inline std::size_t hash_bytes(const void* ptr, std::size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(ptr);
+    std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= static_cast<std::size_t>(1099511628211ULL);
+    }
+    return h;
+}
+
+inline std::size_t hash_string(const char* s) {
+    std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+    for (; *s; ++s) {
+        h ^= static_cast<unsigned char>(*s);
+        h *= static_cast<std::size_t>(1099511628211ULL);
+    }
+    return h;
+}
+
+template <>
+struct hash<char*> {
+    std::size_t operator()(const char* s) const {
+        return hash_string(s);
+    }
+};
+
+template <>
+struct hash<const char*> {
+    std::size_t operator()(const char* s) const {
+        return hash_string(s);
+    }
+};
+
+// 透明哈希: std::string 与 C 字符串的哈希值相同, 配合 equal_to<> 时 hashtable 可以直接用 const char* 查找
+template <>
+struct hash<std::string> {
+    typedef void is_transparent;
+    std::size_t operator()(const std::string& s) const {
+        return hash_bytes(s.data(), s.size());
+    }
+    std::size_t operator()(const char* s) const {
+        return hash_string(s);
+    }
+};
+
+template <class T>
+struct hash<T*> {
+    std::size_t operator()(T* p) const {
+        return reinterpret_cast<std::size_t>(p);
+    }
+};
+
+// 整数类型直接返回其值
+#define MYSTL_TRIVIAL_HASH(Type)                      \
+    template <>                                       \
+    struct hash<Type> {                               \
+        std::size_t operator()(Type x) const {        \
+            return static_cast<std::size_t>(x);       \
+        }                                             \
+    };
+
+MYSTL_TRIVIAL_HASH(bool)
+MYSTL_TRIVIAL_HASH(char)
+MYSTL_TRIVIAL_HASH(signed char)
+MYSTL_TRIVIAL_HASH(unsigned char)
+MYSTL_TRIVIAL_HASH(wchar_t)
+MYSTL_TRIVIAL_HASH(short)
+MYSTL_TRIVIAL_HASH(unsigned short)
+MYSTL_TRIVIAL_HASH(int)
+MYSTL_TRIVIAL_HASH(unsigned int)
+MYSTL_TRIVIAL_HASH(long)
+MYSTL_TRIVIAL_HASH(unsigned long)
+MYSTL_TRIVIAL_HASH(long long)
+MYSTL_TRIVIAL_HASH(unsigned long long)
+
+#undef MYSTL_TRIVIAL_HASH
+
+} // namespace mystl
+
+#endif // MYSTL_HASH_FUN_H_
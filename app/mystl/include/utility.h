@@ -69,6 +69,20 @@ pair<T1, T2> make_pair(T1&& x, T2&& y) {
     return pair<T1, T2>(mystl::forward<T1>(x), mystl::forward<T2>(y));
 }
 
+/*
+ * 有序区间标签: 调用方保证区间已按容器的比较器严格递增 (sorted_unique) 或非递减 (sorted_equivalent),
+ * 容器据此跳过查找直接建树
+ */
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+constexpr sorted_unique_t sorted_unique{};
+
+struct sorted_equivalent_t {
+    explicit sorted_equivalent_t() = default;
+};
+constexpr sorted_equivalent_t sorted_equivalent{};
+
 } // namespace mystl
 
 #endif // MYSTL_UTILITY_H_
@@ -0,0 +1,342 @@
+#ifndef MYSTL_ALGORITHM_TEST_H_
+#define MYSTL_ALGORITHM_TEST_H_
+
+#include "algorithm.h"
+#include "numeric.h"
+#include "uninitialized.h"
+#include "vector.h"
+#include "small_vector.h"
+#include "deque.h"
+#include "list.h"
+#include "array.h"
+#include "htest.h"
+#include "htest_utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mystl {
+namespace test {
+namespace algorithm_test {
+
+struct Point {
+    int x;
+    double y;
+};
+
+bool operator!=(const Point& a, const Point& b) {
+    return a.x != b.x || a.y != b.y;
+}
+
+TEST(algorithm_copy_fill) {
+    EXPECT_TRUE((mystl::is_memmove_copyable<int*, int*>::value));
+    EXPECT_TRUE((mystl::is_memmove_copyable<const Point*, Point*>::value));
+    EXPECT_FALSE((mystl::is_memmove_copyable<int*, long*>::value));
+    EXPECT_FALSE((mystl::is_memmove_copyable<std::string*, std::string*>::value));
+    EXPECT_TRUE(mystl::is_memset_fillable<char*>::value);
+    EXPECT_FALSE(mystl::is_memset_fillable<double*>::value);
+
+    {
+        // memmove 路径与逐个赋值的结果一致, 包括重叠的区间
+        int a[16];
+        std::vector<int> expected(16);
+        for (int i = 0; i < 16; ++i) {
+            a[i] = i;
+            expected[i] = i;
+        }
+        int* r = mystl::copy(a + 2, a + 10, a);
+        EXPECT_EQ(a + 8, r);
+        std::copy(expected.begin() + 2, expected.begin() + 10, expected.begin());
+        EXPECT_TRUE(htest::ContainerEqual(a, expected));
+
+        r = mystl::copy_backward(a, a + 10, a + 14);
+        EXPECT_EQ(a + 4, r);
+        std::copy_backward(expected.begin(), expected.begin() + 10, expected.begin() + 14);
+        EXPECT_TRUE(htest::ContainerEqual(a, expected));
+
+        r = mystl::move(a + 1, a + 4, a + 2);
+        EXPECT_EQ(a + 5, r);
+        std::move(expected.begin() + 1, expected.begin() + 4, expected.begin() + 2);
+        EXPECT_TRUE(htest::ContainerEqual(a, expected));
+
+        r = mystl::move_backward(a + 5, a + 8, a + 6);
+        EXPECT_EQ(a + 3, r);
+        std::move_backward(expected.begin() + 5, expected.begin() + 8, expected.begin() + 6);
+        EXPECT_TRUE(htest::ContainerEqual(a, expected));
+
+        r = mystl::copy(a, a, a); // 空区间
+        EXPECT_EQ(a, r);
+        const int* ca = a;
+        int b[4];
+        r = mystl::copy(ca, ca + 4, b);
+        EXPECT_EQ(b + 4, r);
+        EXPECT_EQ(a[3], b[3]);
+    }
+
+    {
+        Point src[3] = {{1, 1.5}, {2, 2.5}, {3, 3.5}};
+        Point dst[3];
+        mystl::copy(src, src + 3, dst);
+        EXPECT_TRUE(htest::ContainerEqual(src, dst));
+
+        // 类型不同或不可平凡复制时仍然逐个赋值
+        int ints[3] = {5, 6, 7};
+        long l[3];
+        mystl::copy(ints, ints + 3, l);
+        EXPECT_EQ(7L, l[2]);
+        std::string s[3] = {"a", "b", "c"};
+        std::string t[3];
+        mystl::copy(s, s + 3, t);
+        EXPECT_TRUE(htest::ContainerEqual(s, t));
+        mystl::move(t, t + 3, s);
+        EXPECT_EQ(std::string("c"), s[2]);
+    }
+
+    {
+        char c[8];
+        mystl::fill(c, c + 8, 'x');
+        EXPECT_EQ(std::string(8, 'x'), std::string(c, 8));
+        char* end = mystl::fill_n(c, 3, 'y');
+        EXPECT_TRUE(end == c + 3);
+        EXPECT_EQ(std::string("yyyxxxxx"), std::string(c, 8));
+        end = mystl::fill_n(c, -1, 'z');
+        EXPECT_TRUE(end == c);
+
+        int n[5] = {1, 2, 3, 4, 5};
+        mystl::fill(n, n + 5, 0); // 宽整数填 0 走 memset
+        EXPECT_EQ(0, n[4]);
+        mystl::fill_n(n, 5, -1); // 非 0 逐个赋值
+        EXPECT_EQ(-1, n[0]);
+        EXPECT_EQ(-1, n[4]);
+
+        bool flags[4];
+        mystl::fill(flags, flags + 4, true);
+        EXPECT_TRUE(flags[3]);
+
+        double d[3];
+        mystl::fill(d, d + 3, 0.5);
+        EXPECT_EQ(0.5, d[2]);
+    }
+
+    {
+        int raw[4];
+        int src[4] = {4, 3, 2, 1};
+        int* r = mystl::uninitialized_copy(src, src + 4, raw);
+        EXPECT_EQ(raw + 4, r);
+        EXPECT_EQ(1, raw[3]);
+        r = mystl::uninitialized_fill_n(raw, 4, 9);
+        EXPECT_EQ(raw + 4, r);
+        EXPECT_EQ(9, raw[3]);
+        mystl::uninitialized_fill(raw, raw + 4, 0);
+        EXPECT_EQ(0, raw[0]);
+    }
+}
+
+TEST(algorithm_copy_containers) {
+    // 各个容器的拷贝、赋值都经过 copy/fill, 结果与 std::vector 一致
+    std::vector<int> expected;
+    for (int i = 0; i < 100; ++i) {
+        expected.push_back(i * 7 - 50);
+    }
+    std::vector<std::string> sexpected;
+    for (int i = 0; i < 100; ++i) {
+        sexpected.push_back(std::to_string(i));
+    }
+
+    mystl::vector<int> v(expected.data(), expected.data() + expected.size());
+    mystl::vector<int> v2(v);
+    mystl::vector<int> v3;
+    v3 = v2;
+    v3.insert(v3.begin() + 10, v.begin(), v.begin() + 5);
+    v3.erase(v3.begin() + 10, v3.begin() + 15);
+    EXPECT_TRUE(htest::ContainerEqual(v3, expected));
+
+    mystl::small_vector<int, 8> sv(v.begin(), v.end());
+    mystl::small_vector<int, 8> sv2 = sv;
+    EXPECT_TRUE(htest::ContainerEqual(sv2, expected));
+
+    mystl::deque<int> d(v.begin(), v.end());
+    mystl::deque<int> d2(d);
+    EXPECT_TRUE(htest::ContainerEqual(d2, expected));
+
+    mystl::list<int> l(v.begin(), v.end());
+    mystl::list<int> l2(l);
+    EXPECT_TRUE(htest::ContainerEqual(l2, expected));
+
+    mystl::array<int, 100> arr;
+    mystl::copy(l2.begin(), l2.end(), arr.begin());
+    EXPECT_TRUE(htest::ContainerEqual(arr, expected));
+
+    mystl::vector<std::string> s(sexpected.data(), sexpected.data() + sexpected.size());
+    mystl::vector<std::string> s2(s);
+    s2.insert(s2.begin(), s.begin(), s.begin() + 3);
+    s2.erase(s2.begin(), s2.begin() + 3);
+    EXPECT_TRUE(htest::ContainerEqual(s2, sexpected));
+    mystl::deque<std::string> sd(s.begin(), s.end());
+    EXPECT_TRUE(htest::ContainerEqual(sd, sexpected));
+
+    mystl::vector<char> cv(10, 'q');
+    mystl::vector<char> cv2(cv);
+    EXPECT_EQ(std::string(10, 'q'), std::string(cv2.begin(), cv2.end()));
+}
+
+// 在各种长度(覆盖向量宽度以外的尾部)的随机区间上与 std 的结果对照
+template <class T>
+bool ScanMatchesStd(std::mt19937& rng, int values) {
+    std::uniform_int_distribution<int> dist(0, values - 1);
+    const std::size_t sizes[] = {0, 1, 3, 15, 16, 17, 31, 33, 64, 65, 129, 1000};
+    for (std::size_t n : sizes) {
+        mystl::vector<T> v;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<T>(dist(rng) - values / 3));
+        }
+        const T* first = v.data();
+        const T* last = v.data() + v.size();
+        for (int k = -values / 3; k < values - values / 3; ++k) {
+            const T val = static_cast<T>(k);
+            if (mystl::find(first, last, val) != std::find(first, last, val)) return false;
+            if (mystl::count(first, last, val) != std::count(first, last, val)) return false;
+#if MYSTL_SIMD
+            // 支持 AVX2 的机器上分派不到 SSE2 版本, 直接调用
+            if (mystl::simd::find_sse2(first, last, val) != std::find(first, last, val)) return false;
+            if (mystl::simd::count_sse2(first, last, val) != std::count(first, last, val)) return false;
+#endif
+        }
+        if (mystl::find(v.begin(), v.end(), static_cast<T>(values - values / 3)) != v.end()) return false;
+    }
+    return true;
+}
+
+template <class T>
+bool MinMaxMatchesStd(std::mt19937& rng) {
+    std::uniform_int_distribution<long long> dist(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+    const std::size_t sizes[] = {0, 1, 7, 32, 33, 100, 1000};
+    for (std::size_t n : sizes) {
+        mystl::vector<T> v;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<T>(dist(rng)));
+        }
+        if (n > 10) {
+            v[n / 2] = std::numeric_limits<T>::max(); // 最值重复出现时返回第一个
+            v[n - 1] = std::numeric_limits<T>::max();
+            v[n / 3] = std::numeric_limits<T>::min();
+            v[n - 2] = std::numeric_limits<T>::min();
+        }
+        if (mystl::min_element(v.begin(), v.end()) != std::min_element(v.begin(), v.end())) return false;
+        if (mystl::max_element(v.begin(), v.end()) != std::max_element(v.begin(), v.end())) return false;
+    }
+    return true;
+}
+
+TEST(algorithm_simd) {
+    std::mt19937 rng(20240607);
+    EXPECT_TRUE(ScanMatchesStd<char>(rng, 20));
+    EXPECT_TRUE(ScanMatchesStd<unsigned char>(rng, 200));
+    EXPECT_TRUE(ScanMatchesStd<short>(rng, 50));
+    EXPECT_TRUE(ScanMatchesStd<int>(rng, 50));
+    EXPECT_TRUE(ScanMatchesStd<unsigned>(rng, 50));
+    EXPECT_TRUE(ScanMatchesStd<long long>(rng, 50));
+    EXPECT_TRUE(ScanMatchesStd<float>(rng, 50));
+    EXPECT_TRUE(ScanMatchesStd<double>(rng, 50));
+
+    EXPECT_TRUE(MinMaxMatchesStd<signed char>(rng));
+    EXPECT_TRUE(MinMaxMatchesStd<unsigned char>(rng));
+    EXPECT_TRUE(MinMaxMatchesStd<short>(rng));
+    EXPECT_TRUE(MinMaxMatchesStd<unsigned short>(rng));
+    EXPECT_TRUE(MinMaxMatchesStd<int>(rng));
+    EXPECT_TRUE(MinMaxMatchesStd<unsigned>(rng));
+    EXPECT_TRUE(MinMaxMatchesStd<long long>(rng)); // 走通用实现
+
+    {
+        // 浮点数的 -0.0 与 0.0 相等, NaN 与任何值都不相等
+        mystl::vector<double> d(40, 1.0);
+        d[20] = -0.0;
+        d[30] = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_TRUE(mystl::find(d.begin(), d.end(), 0.0) == d.begin() + 20);
+        EXPECT_TRUE(mystl::find(d.begin(), d.end(), d[30]) == d.end());
+        EXPECT_EQ(38, mystl::count(d.begin(), d.end(), 1.0));
+    }
+
+    {
+        mystl::vector<int> v;
+        mystl::vector<unsigned long long> u;
+        for (int i = 0; i < 1001; ++i) {
+            v.push_back(i * 37 - 5000);
+            u.push_back(static_cast<unsigned long long>(i) << 40);
+        }
+        EXPECT_EQ(std::accumulate(v.begin(), v.end(), 7), mystl::accumulate(v.begin(), v.end(), 7));
+        EXPECT_EQ(std::accumulate(u.begin(), u.end(), 0ULL), mystl::accumulate(u.begin(), u.end(), 0ULL));
+#if MYSTL_SIMD
+        EXPECT_EQ(std::accumulate(v.begin(), v.end(), 7), mystl::simd::sum_sse2(v.data(), v.data() + v.size(), 7));
+#endif
+        // 初值类型与元素不同时走通用实现
+        EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0LL), mystl::accumulate(v.begin(), v.end(), 0LL));
+        mystl::vector<float> f(100, 0.1f);
+        EXPECT_EQ(std::accumulate(f.begin(), f.end(), 0.0f), mystl::accumulate(f.begin(), f.end(), 0.0f));
+
+        mystl::vector<int> w(v);
+        EXPECT_TRUE(mystl::equal(v.begin(), v.end(), w.begin()));
+        w[1000] = 0;
+        EXPECT_FALSE(mystl::equal(v.begin(), v.end(), w.begin()));
+
+        // 非连续的容器走通用实现
+        mystl::list<int> l(v.begin(), v.end());
+        EXPECT_TRUE(*mystl::find(l.begin(), l.end(), 32) == 32);
+        EXPECT_EQ(1, mystl::count(l.begin(), l.end(), 32));
+        EXPECT_EQ(-5000, *mystl::min_element(l.begin(), l.end()));
+        EXPECT_EQ(32000, *mystl::max_element(l.begin(), l.end()));
+        EXPECT_EQ(32000, *mystl::min_element(v.begin(), v.end(), [](int a, int b) { return a > b; }));
+    }
+}
+
+TEST(algorithm_search) {
+    // 含重复元素的有序序列, 查询覆盖区间内外的每个值
+    bool ok = true;
+    for (int n = 0; n < 70; ++n) {
+        mystl::vector<int> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(i / 3 * 2);
+        }
+        mystl::list<int> l(v.begin(), v.end());
+        for (int q = -2; q <= n + 2; ++q) {
+            const auto lb = std::lower_bound(v.begin(), v.end(), q) - v.begin();
+            const auto ub = std::upper_bound(v.begin(), v.end(), q) - v.begin();
+            ok = ok && mystl::lower_bound(v.begin(), v.end(), q) - v.begin() == lb;
+            ok = ok && mystl::upper_bound(v.begin(), v.end(), q) - v.begin() == ub;
+            const auto range = mystl::equal_range(v.begin(), v.end(), q);
+            ok = ok && range.first - v.begin() == lb && range.second - v.begin() == ub;
+            ok = ok && mystl::binary_search(v.begin(), v.end(), q) == (lb != ub);
+            // 双向迭代器走通用实现
+            ok = ok && mystl::distance(l.begin(), mystl::lower_bound(l.begin(), l.end(), q)) == lb;
+            ok = ok && mystl::distance(l.begin(), mystl::upper_bound(l.begin(), l.end(), q)) == ub;
+            ok = ok && mystl::binary_search(l.begin(), l.end(), q) == (lb != ub);
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    // 比较器和不同类型的查询值
+    mystl::vector<int> desc;
+    for (int i = 100; i > 0; --i) {
+        desc.push_back(i);
+    }
+    EXPECT_EQ(50, *mystl::lower_bound(desc.begin(), desc.end(), 50, mystl::greater<int>()));
+    EXPECT_EQ(49, *mystl::upper_bound(desc.begin(), desc.end(), 50, mystl::greater<int>()));
+    EXPECT_TRUE(mystl::binary_search(desc.begin(), desc.end(), 7, mystl::greater<int>()));
+    EXPECT_FALSE(mystl::binary_search(desc.begin(), desc.end(), 0, mystl::greater<int>()));
+    mystl::vector<double> d;
+    for (int i = 0; i < 10; ++i) {
+        d.push_back(i + 0.5);
+    }
+    EXPECT_EQ(3.5, *mystl::lower_bound(d.begin(), d.end(), 3));
+    EXPECT_FALSE(mystl::binary_search(d.begin(), d.end(), 3));
+}
+
+}
+}
+} // namespace mystl::test::algorithm_test
+#endif // MYSTL_ALGORITHM_TEST_H_
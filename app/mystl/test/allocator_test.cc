@@ -14,6 +14,9 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <thread>
 
 using namespace htest;
 
@@ -86,6 +89,342 @@ TEST(allocator) {
     // }
 }
 
+TEST(my_allocator) {
+    mystl::MyAllocator* alloc = mystl::MyAllocator::GetInstance();
+
+    {
+        // 每个尺寸分配多个块, 写入标记后交替使用带尺寸/不带尺寸的释放
+        std::vector<std::pair<unsigned char*, std::size_t>> blocks;
+        for (std::size_t bytes = 0; bytes <= 300; ++bytes) {
+            for (int i = 0; i < 40; ++i) {
+                unsigned char* p = alloc->Allocate(bytes);
+                std::memset(p, static_cast<int>(bytes & 0xFF), bytes);
+                blocks.emplace_back(p, bytes);
+            }
+        }
+        for (std::size_t i = 0; i < blocks.size(); i += 2) {
+            alloc->Deallocate(blocks[i].first, blocks[i].second);
+        }
+        bool intact = true;
+        for (std::size_t i = 1; i < blocks.size(); i += 2) {
+            for (std::size_t j = 0; j < blocks[i].second; ++j) {
+                intact = intact && blocks[i].first[j] == static_cast<unsigned char>(blocks[i].second & 0xFF);
+            }
+            alloc->Deallocate(blocks[i].first);
+        }
+        EXPECT_TRUE(intact);
+    }
+
+    {
+        // 释放后的块会被同尺寸的下一次分配复用
+        unsigned char* p = alloc->Allocate(24);
+        alloc->Deallocate(p, 24);
+        unsigned char* q = alloc->Allocate(24);
+        EXPECT_EQ(static_cast<void*>(p), static_cast<void*>(q));
+        alloc->Deallocate(q);
+    }
+
+    {
+        // 小对象集中在少数几个 slab 中, 且同一 slab 内的块地址连续
+        const std::size_t kCount = 4000;
+        std::vector<unsigned char*> blocks;
+        std::set<std::uintptr_t> slabs;
+        for (std::size_t i = 0; i < kCount; ++i) {
+            unsigned char* p = alloc->Allocate(8);
+            blocks.push_back(p);
+            slabs.insert(reinterpret_cast<std::uintptr_t>(p) / mystl::SlabHeap::SLAB_BYTES);
+        }
+        EXPECT_TRUE(slabs.size() <= 2U);
+        for (std::size_t i = 0; i < kCount; ++i) {
+            alloc->Deallocate(blocks[i], 8);
+        }
+    }
+
+    {
+        mystl::allocator<double> da;
+        double* p = da.allocate(3);
+        p[0] = 1.0;
+        p[2] = 3.0;
+        EXPECT_EQ(4.0, p[0] + p[2]);
+        da.deallocate(p, 3);
+
+        double* big = da.allocate(1000); // 大于 BLOCK_SIZE, 走 operator new
+        big[999] = 2.0;
+        EXPECT_EQ(2.0, big[999]);
+        da.deallocate(big);
+    }
+}
+
+TEST(my_allocator_trim) {
+    mystl::MyAllocator* alloc = mystl::MyAllocator::GetInstance();
+
+    // 一次流量高峰占用约 20 个 slab, 全部释放后 Trim 把空闲 slab 还给操作系统
+    const std::size_t kCount = 20 * mystl::SlabHeap::SLAB_BYTES / 64;
+    std::vector<unsigned char*> blocks(kCount);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        blocks[i] = alloc->Allocate(64);
+    }
+    for (std::size_t i = 0; i < kCount; ++i) {
+        alloc->Deallocate(blocks[i], 64);
+    }
+    const std::size_t released = alloc->Trim();
+    EXPECT_TRUE(released >= 19 * mystl::SlabHeap::SLAB_BYTES);
+#if MYSTL_ALLOCATOR_STATS
+    const mystl::AllocatorStats stats = alloc->GetStats();
+    EXPECT_EQ(0U, stats.freeSlabCount);
+    EXPECT_TRUE(stats.releasedSlabCount >= 19U);
+#endif
+    EXPECT_EQ(0U, alloc->Trim());
+
+    // 还回去的 slab 可以再次使用
+    for (std::size_t i = 0; i < kCount; ++i) {
+        blocks[i] = alloc->Allocate(64);
+        std::memset(blocks[i], 0x3C, 64);
+    }
+    EXPECT_EQ(0x3C, blocks[kCount - 1][63]);
+
+    // 空闲 slab 超过上限时, 释放的 slab 直接还给操作系统
+    alloc->SetMaxFreeSlabs(2);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        alloc->Deallocate(blocks[i], 64);
+    }
+    alloc->Trim(2);
+#if MYSTL_ALLOCATOR_STATS
+    EXPECT_TRUE(alloc->GetStats().freeSlabCount <= 2U);
+#endif
+    alloc->SetMaxFreeSlabs(mystl::SlabHeap::DEFAULT_MAX_FREE_SLABS);
+}
+
+struct alignas(32) Simd8f {
+    float lanes[8];
+};
+
+struct alignas(64) PaddedCounter {
+    long value;
+};
+
+TEST(my_allocator_aligned) {
+    mystl::MyAllocator* alloc = mystl::MyAllocator::GetInstance();
+
+    {
+        // 尺寸类别按 8 字节递增, 每个块至少按 8 字节对齐
+        bool aligned = true;
+        for (std::size_t bytes = 1; bytes <= 256; ++bytes) {
+            unsigned char* p = alloc->Allocate(bytes);
+            aligned = aligned && reinterpret_cast<std::uintptr_t>(p) % 8U == 0U;
+            if (bytes % 16U == 0U) {
+                aligned = aligned && reinterpret_cast<std::uintptr_t>(p) % 16U == 0U;
+            }
+            alloc->Deallocate(p, bytes);
+        }
+        EXPECT_TRUE(aligned);
+    }
+
+    {
+        // 16/32/64 字节对齐, 包括超过 BLOCK_SIZE 的大块
+        const std::size_t aligns[] = {16, 32, 64, 128};
+        const std::size_t sizes[] = {1, 24, 40, 100, 200, 256, 300, 1000, 5000};
+        bool aligned = true;
+        for (std::size_t align : aligns) {
+            std::vector<unsigned char*> blocks;
+            for (std::size_t bytes : sizes) {
+                unsigned char* p = alloc->AllocateAligned(bytes, align);
+                aligned = aligned && reinterpret_cast<std::uintptr_t>(p) % align == 0U;
+                std::memset(p, 0x5A, bytes);
+                blocks.push_back(p);
+            }
+            for (std::size_t i = 0; i < blocks.size(); ++i) {
+                alloc->DeallocateAligned(blocks[i], sizes[i], align);
+            }
+        }
+        EXPECT_TRUE(aligned);
+    }
+
+    {
+        // SIMD 类型和按缓存行填充的计数器经由 mystl::allocator 从内存池取得对齐的内存
+        std::vector<Simd8f, mystl::allocator<Simd8f>> lanes;
+        std::vector<PaddedCounter, mystl::allocator<PaddedCounter>> counters;
+        bool aligned = true;
+        for (int i = 0; i < 100; ++i) {
+            lanes.push_back(Simd8f());
+            counters.push_back(PaddedCounter());
+            aligned = aligned && reinterpret_cast<std::uintptr_t>(lanes.data()) % 32U == 0U;
+            aligned = aligned && reinterpret_cast<std::uintptr_t>(counters.data()) % 64U == 0U;
+        }
+        EXPECT_TRUE(aligned);
+        EXPECT_EQ(100U, counters.size());
+    }
+}
+
+TEST(my_allocator_threads) {
+    mystl::MyAllocator* alloc = mystl::MyAllocator::GetInstance();
+    const int kThreads = 4;
+    const int kBlocks = 2000;
+
+    // 每个线程分配的块交给下一个线程释放, 检验跨线程释放后内容不被破坏
+    std::vector<std::vector<unsigned char*>> blocks(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&blocks, alloc, t]() {
+            for (int i = 0; i < kBlocks; ++i) {
+                std::size_t bytes = static_cast<std::size_t>(i % 128 + 1);
+                unsigned char* p = alloc->Allocate(bytes);
+                std::memset(p, t, bytes);
+                blocks[t].push_back(p);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    threads.clear();
+
+    std::vector<int> intact(kThreads, 1);
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&blocks, &intact, alloc, t, kThreads]() {
+            const int owner = (t + 1) % kThreads;
+            for (int i = 0; i < kBlocks; ++i) {
+                std::size_t bytes = static_cast<std::size_t>(i % 128 + 1);
+                unsigned char* p = blocks[owner][i];
+                for (std::size_t j = 0; j < bytes; ++j) {
+                    intact[t] = intact[t] && p[j] == static_cast<unsigned char>(owner);
+                }
+                if (i % 2 == 0) {
+                    alloc->Deallocate(p, bytes);
+                } else {
+                    alloc->Deallocate(p);
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    for (int t = 0; t < kThreads; ++t) {
+        EXPECT_EQ(1, intact[t]);
+    }
+}
+
+TEST(my_allocator_stats) {
+    mystl::MyAllocator* alloc = mystl::MyAllocator::GetInstance();
+    const mystl::AllocatorStats before = alloc->GetStats();
+    EXPECT_EQ(MYSTL_ALLOCATOR_STATS != 0, before.enabled);
+    EXPECT_EQ(32U, before.sizeClassNum);
+    EXPECT_EQ(24U, before.sizeClasses[2].blockSize);
+
+    const std::size_t n = 100;
+    unsigned char* small[n];
+    for (std::size_t i = 0; i < n; ++i) {
+        small[i] = alloc->Allocate(24);
+    }
+    unsigned char* large = alloc->Allocate(1000);
+    const mystl::AllocatorStats during = alloc->GetStats();
+    for (std::size_t i = 0; i < n; ++i) {
+        alloc->Deallocate(small[i], 24);
+    }
+    alloc->Deallocate(large);
+    const mystl::AllocatorStats after = alloc->GetStats();
+
+    const std::string text = after.ToText();
+    const std::string json = after.ToJson();
+    EXPECT_TRUE(text.find("allocator stats") != std::string::npos);
+    EXPECT_TRUE(json.front() == '{' && json.back() == '}');
+    EXPECT_TRUE(after.elapsedSeconds >= before.elapsedSeconds);
+#if MYSTL_ALLOCATOR_STATS
+    const mystl::SizeClassStats& c0 = before.sizeClasses[2];
+    const mystl::SizeClassStats& c1 = during.sizeClasses[2];
+    const mystl::SizeClassStats& c2 = after.sizeClasses[2];
+    EXPECT_EQ(c0.allocCount + n, c1.allocCount);
+    EXPECT_EQ(c0.liveBytes + n * 24, c1.liveBytes);
+    EXPECT_EQ(c0.requestedBytes + n * 24, c1.requestedBytes);
+    EXPECT_TRUE(c1.peakLiveBytes >= c1.liveBytes);
+    EXPECT_TRUE(c1.chunkCount >= 1U);
+    EXPECT_TRUE(c1.reservedBytes >= c1.liveBytes);
+    EXPECT_EQ(c1.freeCount + n, c2.freeCount);
+    EXPECT_EQ(c0.liveBytes, c2.liveBytes);
+
+    EXPECT_EQ(before.largeAllocCount + 1, during.largeAllocCount);
+    EXPECT_EQ(before.largeAllocBytes + 1000, during.largeAllocBytes);
+    EXPECT_EQ(during.largeFreeCount + 1, after.largeFreeCount);
+    EXPECT_EQ(before.AllocCount() + n + 1, during.AllocCount());
+
+    EXPECT_TRUE(during.peakLiveBytes >= during.liveBytes);
+    EXPECT_TRUE(during.mappedBytes >= during.reservedBytes);
+    EXPECT_TRUE(during.Fragmentation() >= 0.0 && during.Fragmentation() < 1.0);
+    EXPECT_TRUE(json.find("\"block_size\":24,") != std::string::npos);
+    EXPECT_TRUE(text.find("[24B]") != std::string::npos);
+#else
+    (void)during;
+    EXPECT_EQ(0U, after.AllocCount());
+#endif
+}
+
+// 多线程分配/释放吞吐量, 线程数从 1 增加到硬件线程数
+TEST(my_allocator_bench) {
+    mystl::MyAllocator* alloc = mystl::MyAllocator::GetInstance();
+    const int kOps = 200000;
+    const int kLive = 64;
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0U) {
+        cores = 1U;
+    }
+
+    const mystl::AllocatorStats before = alloc->GetStats();
+    bool intact = true;
+    for (unsigned int n = 1;; n = std::min(n * 2, cores)) {
+        // 每个块写满所属线程的标记, 释放前检查没有被别的线程覆盖
+        std::vector<int> corrupted(n, 0);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < n; ++t) {
+            threads.emplace_back([alloc, kOps, kLive, t, &corrupted]() {
+                unsigned char* live[kLive] = {};
+                std::size_t sizes[kLive] = {};
+                unsigned char pattern[256];
+                std::memset(pattern, static_cast<int>(t + 1), sizeof(pattern));
+                for (int i = 0; i < kOps + kLive; ++i) {
+                    int slot = i % kLive;
+                    if (live[slot] != nullptr && std::memcmp(live[slot], pattern, sizes[slot]) != 0) {
+                        ++corrupted[t];
+                    }
+                    alloc->Deallocate(live[slot]);
+                    live[slot] = nullptr;
+                    sizes[slot] = 0;
+                    if (i < kOps) {
+                        sizes[slot] = static_cast<std::size_t>((i * 7) % 256 + 1);
+                        live[slot] = alloc->Allocate(sizes[slot]);
+                        std::memcpy(live[slot], pattern, sizes[slot]);
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        for (unsigned int t = 0; t < n; ++t) {
+            intact = intact && corrupted[t] == 0;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double ops = 2.0 * kOps * n / seconds;
+        std::cout << "my_allocator threads=" << n << " ops/sec=" << static_cast<long long>(ops) << std::endl;
+        if (n == cores) {
+            break;
+        }
+    }
+    EXPECT_TRUE(intact);
+
+    // 所有线程退出后分配与释放次数相等, 用户持有的字节数回到开始时
+    const mystl::AllocatorStats after = alloc->GetStats();
+#if MYSTL_ALLOCATOR_STATS
+    EXPECT_EQ(after.AllocCount() - before.AllocCount(), after.FreeCount() - before.FreeCount());
+    EXPECT_TRUE(after.AllocCount() > before.AllocCount());
+    EXPECT_EQ(before.liveBytes, after.liveBytes);
+#else
+    (void)before;
+    EXPECT_EQ(0U, after.AllocCount());
+#endif
+}
+
 }
 }
 } // namespace mystl::test::allocator_test
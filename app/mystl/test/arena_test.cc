@@ -0,0 +1,196 @@
+#ifndef MYSTL_ARENA_TEST_H_
+#define MYSTL_ARENA_TEST_H_
+
+#include "arena.h"
+#include "vector.h"
+#include "list.h"
+#include "deque.h"
+#include "map.h"
+#include "set.h"
+#include "hashtable.h"
+#include "htest.h"
+
+#include <cstdint>
+
+namespace mystl {
+namespace test {
+namespace arena_test {
+
+TEST(arena) {
+    {
+        mystl::Arena arena(64);
+        EXPECT_EQ(0U, arena.BytesUsed());
+        void* a = arena.Allocate(3, 1);
+        void* b = arena.Allocate(8, 8);
+        EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(b) % 8U);
+        EXPECT_TRUE(static_cast<unsigned char*>(b) > static_cast<unsigned char*>(a));
+        EXPECT_EQ(11U, arena.BytesUsed());
+
+        // 超过块大小的请求单独占一块
+        void* big = arena.Allocate(1000);
+        EXPECT_TRUE(big != nullptr);
+
+        // Reset 后从保留的块头部重新分配
+        arena.Reset();
+        EXPECT_EQ(0U, arena.BytesUsed());
+        void* c = arena.Allocate(16);
+        EXPECT_EQ(big, c);
+        arena.Release();
+        EXPECT_EQ(0U, arena.BytesUsed());
+    }
+
+    {
+        // 不在 ArenaScope 内时没有当前 Arena, 作用域可以嵌套
+        EXPECT_TRUE(mystl::Arena::Current() == nullptr);
+        mystl::Arena outer;
+        mystl::Arena inner;
+        {
+            mystl::ArenaScope s1(outer);
+            EXPECT_TRUE(mystl::Arena::Current() == &outer);
+            {
+                mystl::ArenaScope s2(inner);
+                EXPECT_TRUE(mystl::Arena::Current() == &inner);
+            }
+            EXPECT_TRUE(mystl::Arena::Current() == &outer);
+        }
+        EXPECT_TRUE(mystl::Arena::Current() == nullptr);
+
+        bool thrown = false;
+        try {
+            mystl::arena_allocator<int>().allocate(1);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        EXPECT_TRUE(thrown);
+    }
+}
+
+TEST(arena_containers) {
+    mystl::Arena arena;
+    for (int round = 0; round < 3; ++round) {
+        {
+            mystl::ArenaScope scope(arena);
+
+            mystl::vector<int, mystl::arena_allocator<int>> v;
+            for (int i = 0; i < 1000; ++i) {
+                v.push_back(i);
+            }
+            EXPECT_EQ(999, v.back());
+
+            mystl::list<int, mystl::arena_allocator<int>> l;
+            for (int i = 0; i < 100; ++i) {
+                l.push_back(i);
+            }
+            EXPECT_EQ(100U, l.size());
+            EXPECT_EQ(99, l.back());
+
+            mystl::deque<int, mystl::arena_allocator<int>> d;
+            for (int i = 0; i < 100; ++i) {
+                d.push_back(i);
+                d.push_front(-i);
+            }
+            EXPECT_EQ(-99, d.front());
+            EXPECT_EQ(99, d.back());
+
+            using pair_type = mystl::pair<const int, int>;
+            mystl::map<int, int, mystl::less<int>, mystl::arena_allocator<pair_type>> m;
+            for (int i = 0; i < 100; ++i) {
+                m.insert(pair_type(i, i * i));
+            }
+            EXPECT_EQ(100U, m.size());
+            EXPECT_EQ(81, m.find(9)->second);
+
+            mystl::hashtable<int, int, mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>,
+                             mystl::arena_allocator<int>>
+                ht(10, mystl::hash<int>(), mystl::equal_to<int>());
+            for (int i = 0; i < 100; ++i) {
+                ht.insert_unique(i);
+            }
+            EXPECT_EQ(100U, ht.size());
+            EXPECT_EQ(1U, ht.count(50));
+
+            EXPECT_TRUE(arena.BytesUsed() > 1000 * sizeof(int));
+        }
+        // 容器已全部销毁, 一次性回收
+        arena.Reset();
+        EXPECT_EQ(0U, arena.BytesUsed());
+    }
+}
+
+TEST(arena_allocator_instances) {
+    // 无状态分配器借助空基类优化不占空间
+    EXPECT_EQ(3 * sizeof(void*), sizeof(mystl::vector<int>));
+
+    using vec_type = mystl::vector<int, mystl::arena_allocator<int>>;
+    using list_type = mystl::list<int, mystl::arena_allocator<int>>;
+    using set_type = mystl::set<int, mystl::less<int>, mystl::arena_allocator<int>>;
+
+    // 不需要 ArenaScope, 容器各自绑定不同的 Arena
+    mystl::Arena a1;
+    mystl::Arena a2;
+    mystl::arena_allocator<int> alloc1(a1);
+    mystl::arena_allocator<int> alloc2(a2);
+    EXPECT_TRUE(alloc1 != alloc2);
+    EXPECT_TRUE(alloc1 == mystl::arena_allocator<int>(mystl::arena_allocator<double>(a1)));
+
+    vec_type v1(alloc1);
+    vec_type v2(alloc2);
+    list_type l1(alloc1);
+    set_type s2(mystl::less<int>(), alloc2);
+    for (int i = 0; i < 100; ++i) {
+        v1.push_back(i);
+        v2.push_back(-i);
+        l1.push_back(i);
+        s2.insert(i);
+    }
+    EXPECT_TRUE(v1.get_allocator().arena() == &a1);
+    EXPECT_TRUE(l1.get_allocator().arena() == &a1);
+    EXPECT_TRUE(s2.get_allocator().arena() == &a2);
+    EXPECT_TRUE(a1.BytesUsed() >= 100 * sizeof(int));
+    EXPECT_TRUE(a2.BytesUsed() >= 100 * sizeof(int));
+
+    // 复制赋值不传播, 元素复制进自己的 Arena
+    const std::size_t used1 = a1.BytesUsed();
+    vec_type v3(alloc1);
+    v3 = v2;
+    EXPECT_TRUE(v3.get_allocator().arena() == &a1);
+    EXPECT_EQ(-99, v3.back());
+    EXPECT_TRUE(a1.BytesUsed() > used1);
+
+    // 移动赋值和 swap 时分配器跟着内容走
+    vec_type v4(alloc1);
+    v4 = mystl::move(v2);
+    EXPECT_TRUE(v4.get_allocator().arena() == &a2);
+    EXPECT_EQ(100U, v4.size());
+    v1.swap(v4);
+    EXPECT_TRUE(v1.get_allocator().arena() == &a2);
+    EXPECT_TRUE(v4.get_allocator().arena() == &a1);
+    EXPECT_EQ(-99, v1.back());
+    EXPECT_EQ(99, v4.back());
+
+    set_type s1(mystl::less<int>(), alloc1);
+    s1 = mystl::move(s2);
+    EXPECT_TRUE(s1.get_allocator().arena() == &a2);
+    EXPECT_EQ(100U, s1.size());
+    EXPECT_TRUE(s1.find(42) != s1.end());
+
+    // 指定分配器的移动构造, 分配器不同时逐个搬移元素
+    list_type l2(mystl::move(l1), alloc2);
+    EXPECT_TRUE(l2.get_allocator().arena() == &a2);
+    EXPECT_EQ(100U, l2.size());
+    EXPECT_EQ(99, l2.back());
+
+    mystl::deque<int, mystl::arena_allocator<int>> d1(alloc1);
+    mystl::deque<int, mystl::arena_allocator<int>> d2(alloc2);
+    d1.push_back(1);
+    d2.push_back(2);
+    d2.push_back(3);
+    d1.swap(d2);
+    EXPECT_EQ(2U, d1.size());
+    EXPECT_TRUE(d1.get_allocator().arena() == &a2);
+}
+
+}
+}
+} // namespace mystl::test::arena_test
+#endif // !MYSTL_ARENA_TEST_H_
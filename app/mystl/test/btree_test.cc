@@ -0,0 +1,171 @@
+#ifndef MYSTL_BTREE_TEST_H_
+#define MYSTL_BTREE_TEST_H_
+
+#include "btree_set.h"
+#include "btree_map.h"
+#include "vector.h"
+#include "htest.h"
+
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+namespace mystl {
+namespace test {
+namespace btree_test {
+
+// 两者元素相同, 并且正反两个方向遍历的结果一致
+template <class BtreeSet, class StdSet>
+bool SameElements(const BtreeSet& b, const StdSet& s) {
+    if (b.size() != s.size() || !b.verify()) return false;
+    auto it = s.begin();
+    for (auto bit = b.begin(); bit != b.end(); ++bit, ++it) {
+        if (!(*bit == *it)) return false;
+    }
+    auto rit = s.rbegin();
+    for (auto bit = b.rbegin(); bit != b.rend(); ++bit, ++rit) {
+        if (!(*bit == *rit)) return false;
+    }
+    return true;
+}
+
+// 随机插入删除并与 std::set 对照, 小结点让树更高, 分裂和合并更频繁
+template <class BtreeSet>
+bool RandomOps(int ops, int range, unsigned seed) {
+    std::mt19937 rng(seed);
+    BtreeSet b;
+    std::set<int> s;
+    bool ok = true;
+    for (int i = 0; i < ops && ok; ++i) {
+        const int x = static_cast<int>(rng() % range);
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            ok = b.insert(x).second == s.insert(x).second;
+            break;
+        case 2:
+            ok = b.erase(x) == s.erase(x);
+            break;
+        default: {
+            // erase(iterator) 返回下一个元素
+            auto bit = b.lower_bound(x);
+            auto sit = s.lower_bound(x);
+            ok = (bit == b.end()) == (sit == s.end());
+            if (ok && bit != b.end()) {
+                bit = b.erase(bit);
+                sit = s.erase(sit);
+                ok = (bit == b.end() && sit == s.end()) || (bit != b.end() && sit != s.end() && *bit == *sit);
+            }
+        }
+        }
+        if (i % 97 == 0) ok = ok && SameElements(b, s);
+    }
+    return ok && SameElements(b, s);
+}
+
+TEST(btree_set) {
+    EXPECT_TRUE((RandomOps<mystl::btree_set<int>>(200000, 5000, 1)));
+    EXPECT_TRUE((RandomOps<mystl::btree_set<int, mystl::less<int>, mystl::allocator<int>, 64>>(200000, 3000, 2)));
+    EXPECT_TRUE((RandomOps<mystl::btree_set<int, mystl::less<int>, mystl::allocator<int>, 8>>(100000, 2000, 3)));
+
+    // 有序构造时叶子是满的, 逆序和乱序构造结果相同
+    mystl::vector<int> keys;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back(i * 2);
+    }
+    mystl::btree_set<int> sorted(keys.begin(), keys.end());
+    mystl::btree_set<int> tagged(mystl::sorted_unique, keys.begin(), keys.end());
+    mystl::btree_set<int> reversed(keys.rbegin(), keys.rend());
+    EXPECT_EQ(100000, sorted.size());
+    EXPECT_TRUE(sorted.verify() && tagged.verify() && reversed.verify());
+    EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), reversed.begin()));
+    EXPECT_TRUE(std::equal(tagged.begin(), tagged.end(), keys.begin()));
+
+    // 查找
+    EXPECT_TRUE(sorted.contains(1000));
+    EXPECT_FALSE(sorted.contains(1001));
+    EXPECT_EQ(1002, *sorted.lower_bound(1001));
+    EXPECT_EQ(1002, *sorted.upper_bound(1000));
+    EXPECT_TRUE(sorted.lower_bound(199999) == sorted.end());
+    EXPECT_EQ(0, *sorted.lower_bound(-5));
+    EXPECT_EQ(1, sorted.count(0));
+
+    // 按提示插入与区间删除
+    mystl::btree_set<int> h;
+    for (int i = 0; i < 1000; ++i) {
+        h.insert(h.end(), i * 3);
+    }
+    auto pos = h.lower_bound(301);
+    h.insert(pos, 301);
+    h.insert(h.begin(), 300); // 已存在
+    EXPECT_EQ(1001, h.size());
+    auto last = h.erase(h.lower_bound(100), h.lower_bound(2000));
+    EXPECT_EQ(2001, *last);
+    EXPECT_TRUE(h.verify());
+    EXPECT_EQ(34 + 333, h.size());
+    h.erase(h.begin(), h.end());
+    EXPECT_TRUE(h.empty() && h.begin() == h.end() && h.verify());
+
+    // 拷贝, 移动, 交换
+    mystl::btree_set<std::string> words{"pear", "apple", "fig", "kiwi"};
+    mystl::btree_set<std::string> copy(words);
+    mystl::btree_set<std::string> moved(mystl::move(copy));
+    EXPECT_TRUE(copy.empty() && moved.size() == 4);
+    EXPECT_TRUE(*moved.begin() == "apple");
+    copy = moved;
+    copy.emplace("banana");
+    swap(copy, moved);
+    EXPECT_EQ(5, moved.size());
+    EXPECT_EQ(4, copy.size());
+    moved = {"z"};
+    EXPECT_TRUE(moved.size() == 1 && *moved.begin() == "z");
+}
+
+TEST(btree_map) {
+    std::mt19937 rng(7);
+    mystl::btree_map<std::string, int, mystl::less<std::string>, mystl::allocator<mystl::pair<const std::string, int>>, 128> m;
+    std::map<std::string, int> expected;
+    bool ok = true;
+    for (int i = 0; i < 50000; ++i) {
+        const std::string k = std::to_string(rng() % 10000);
+        if (rng() % 3 == 0) {
+            ok = ok && m.erase(k) == expected.erase(k);
+        } else {
+            m[k] += i;
+            expected[k] += i;
+        }
+    }
+    ok = ok && m.size() == expected.size() && m.verify();
+    auto it = expected.begin();
+    for (auto mit = m.begin(); ok && mit != m.end(); ++mit, ++it) {
+        ok = mit->first == it->first && mit->second == it->second;
+    }
+    EXPECT_TRUE(ok);
+
+    mystl::btree_map<int, int> squares;
+    for (int i = 0; i < 1000; ++i) {
+        squares.emplace(i, i * i);
+    }
+    EXPECT_EQ(250000, squares.at(500));
+    const auto& cref = squares;
+    EXPECT_EQ(81, cref.at(9));
+    bool thrown = false;
+    try {
+        squares.at(5000);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    auto range = squares.equal_range(10);
+    EXPECT_TRUE(range.first->second == 100 && range.second->first == 11);
+    squares.find(10)->second = -1;
+    EXPECT_EQ(-1, squares[10]);
+    EXPECT_FALSE(squares.insert(mystl::pair<const int, int>(10, 7)).second);
+}
+
+}
+}
+} // namespace mystl::test::btree_test
+#endif // MYSTL_BTREE_TEST_H_
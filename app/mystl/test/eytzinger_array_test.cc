@@ -0,0 +1,102 @@
+#ifndef MYSTL_EYTZINGER_ARRAY_TEST_H_
+#define MYSTL_EYTZINGER_ARRAY_TEST_H_
+
+#include "eytzinger_array.h"
+#include "vector.h"
+#include "list.h"
+#include "htest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mystl {
+namespace test {
+namespace eytzinger_array_test {
+
+// 对每个查询值比较 eytzinger_array 与有序数组上 std::lower_bound/upper_bound 的结果
+template <class T, class Compare>
+bool MatchesSorted(const mystl::eytzinger_array<T, Compare>& e, std::vector<T> sorted, const std::vector<T>& queries) {
+    std::sort(sorted.begin(), sorted.end(), Compare());
+    for (const T& q : queries) {
+        auto lb = std::lower_bound(sorted.begin(), sorted.end(), q, Compare());
+        auto ub = std::upper_bound(sorted.begin(), sorted.end(), q, Compare());
+        const T* elb = e.lower_bound(q);
+        const T* eub = e.upper_bound(q);
+        if ((lb == sorted.end()) != (elb == nullptr)) return false;
+        if (elb != nullptr && *elb != *lb) return false;
+        if ((ub == sorted.end()) != (eub == nullptr)) return false;
+        if (eub != nullptr && *eub != *ub) return false;
+        if (e.contains(q) != std::binary_search(sorted.begin(), sorted.end(), q, Compare())) return false;
+    }
+    return true;
+}
+
+TEST(eytzinger_array) {
+    mystl::eytzinger_array<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.lower_bound(1) == nullptr);
+    EXPECT_FALSE(empty.contains(1));
+
+    mystl::eytzinger_array<int> small{5, 1, 3};
+    EXPECT_EQ(3, small.size());
+    EXPECT_EQ(3, small.data()[0]); // 根是中位数
+    EXPECT_EQ(1, *small.lower_bound(0));
+    EXPECT_EQ(3, *small.lower_bound(2));
+    EXPECT_EQ(5, *small.upper_bound(3));
+    EXPECT_TRUE(small.upper_bound(5) == nullptr);
+    EXPECT_TRUE(small.find(4) == nullptr);
+
+    // 各种大小的树, 包括满二叉树和最后一层只有一个结点的树, 以及重复元素
+    std::mt19937 rng(20240614);
+    bool ok = true;
+    for (int n = 1; n < 300; ++n) {
+        std::vector<int> values;
+        for (int i = 0; i < n; ++i) {
+            values.push_back(static_cast<int>(rng() % (2 * n)));
+        }
+        std::vector<int> queries;
+        for (int q = -1; q <= 2 * n + 1; ++q) {
+            queries.push_back(q);
+        }
+        ok = ok && MatchesSorted(mystl::eytzinger_array<int>(values.data(), values.data() + n), values, queries);
+        ok = ok && MatchesSorted(mystl::eytzinger_array<int, mystl::greater<int>>(values.data(), values.data() + n),
+                                 values, queries);
+    }
+    EXPECT_TRUE(ok);
+
+    std::vector<int> big;
+    for (int i = 0; i < 100000; ++i) {
+        big.push_back(static_cast<int>(rng()));
+    }
+    std::vector<int> queries(big.begin(), big.begin() + 1000);
+    for (int i = 0; i < 1000; ++i) {
+        queries.push_back(static_cast<int>(rng()));
+    }
+    EXPECT_TRUE(MatchesSorted(mystl::eytzinger_array<int>(big.data(), big.data() + big.size()), big, queries));
+}
+
+TEST(eytzinger_array_string) {
+    mystl::list<std::string> words;
+    const char* const raw[] = {"pear", "apple", "fig", "kiwi", "banana", "cherry", "date", "grape"};
+    for (const char* w : raw) {
+        words.push_back(w);
+    }
+    mystl::eytzinger_array<std::string> e(words.begin(), words.end());
+    EXPECT_EQ(8, e.size());
+    EXPECT_TRUE(e.contains("kiwi"));
+    EXPECT_FALSE(e.contains("lemon"));
+    EXPECT_TRUE(*e.lower_bound("lemon") == "pear");
+    EXPECT_TRUE(*e.upper_bound("apple") == "banana");
+
+    mystl::eytzinger_array<std::string> other{"z"};
+    swap(e, other);
+    EXPECT_EQ(1, e.size());
+    EXPECT_EQ(8, other.size());
+}
+
+}
+}
+} // namespace mystl::test::eytzinger_array_test
+#endif // MYSTL_EYTZINGER_ARRAY_TEST_H_
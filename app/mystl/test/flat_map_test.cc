@@ -0,0 +1,232 @@
+#ifndef MYSTL_FLAT_MAP_TEST_H_
+#define MYSTL_FLAT_MAP_TEST_H_
+
+#include "flat_set.h"
+#include "flat_map.h"
+#include "vector.h"
+#include "htest.h"
+
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+namespace mystl {
+namespace test {
+namespace flat_map_test {
+
+// 只能用 id 显式构造, 按 id 查找时必须走异构查找
+struct Employee {
+    explicit Employee(int i, const std::string& n) :
+        id(i), name(n) {
+    }
+    int id;
+    std::string name;
+};
+
+struct ById {
+    typedef void is_transparent;
+    bool operator()(const Employee& a, const Employee& b) const {
+        return a.id < b.id;
+    }
+    bool operator()(const Employee& a, int id) const {
+        return a.id < id;
+    }
+    bool operator()(int id, const Employee& b) const {
+        return id < b.id;
+    }
+};
+
+// 比较若干次后抛出异常
+struct ThrowingLess {
+    int* budget;
+    bool operator()(int a, int b) const {
+        if (*budget > 0 && --*budget == 0) throw std::runtime_error("compare");
+        return a < b;
+    }
+};
+
+template <class FlatSet>
+bool SameElements(const FlatSet& f, const std::set<int>& s) {
+    if (f.size() != s.size() || !f.verify()) return false;
+    auto it = s.begin();
+    for (auto fit = f.begin(); fit != f.end(); ++fit, ++it) {
+        if (*fit != *it) return false;
+    }
+    return true;
+}
+
+TEST(flat_set) {
+    // 单个插入删除与批量插入交替, 与 std::set 对照
+    std::mt19937 rng(5);
+    mystl::flat_set<int> f;
+    std::set<int> s;
+    bool ok = true;
+    for (int round = 0; round < 2000 && ok; ++round) {
+        const int x = static_cast<int>(rng() % 5000);
+        switch (rng() % 4) {
+        case 0:
+            ok = f.insert(x).second == s.insert(x).second;
+            break;
+        case 1:
+            ok = f.erase(x) == s.erase(x);
+            break;
+        default: {
+            // 一批里有重复, 也有已经存在的元素
+            mystl::vector<int> batch;
+            const int n = static_cast<int>(rng() % 200);
+            for (int i = 0; i < n; ++i) {
+                batch.push_back(static_cast<int>(rng() % 5000));
+            }
+            f.insert(batch.begin(), batch.end());
+            for (int i = 0; i < n; ++i) {
+                s.insert(batch[i]);
+            }
+        }
+        }
+        if (round % 37 == 0) ok = ok && SameElements(f, s);
+    }
+    EXPECT_TRUE(ok && SameElements(f, s));
+
+    // 按序追加与有序标签
+    mystl::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(i * 2);
+    }
+    mystl::flat_set<int> tagged(mystl::sorted_unique, keys.begin(), keys.begin() + 500);
+    tagged.insert(mystl::sorted_unique, keys.begin() + 400, keys.end());
+    EXPECT_EQ(1000, tagged.size());
+    EXPECT_TRUE(tagged.verify());
+    EXPECT_EQ(1000, *tagged.lower_bound(999));
+    EXPECT_EQ(1002, *tagged.upper_bound(1000));
+    EXPECT_EQ(1, tagged.count(1998));
+    EXPECT_FALSE(tagged.contains(1999));
+
+    // 接管已排好序的 vector, 不拷贝元素; extract 原样交还
+    const int* data = keys.data();
+    mystl::flat_set<int> adopted(mystl::sorted_unique, mystl::move(keys));
+    EXPECT_TRUE(keys.empty());
+    EXPECT_TRUE(adopted.begin() == data);
+    EXPECT_EQ(1000, adopted.size());
+    mystl::vector<int> back = adopted.extract();
+    EXPECT_TRUE(adopted.empty() && back.data() == data);
+
+    // 无序的 vector 就地排序去重
+    mystl::vector<int> raw;
+    for (int i = 0; i < 100; ++i) {
+        raw.push_back((i * 37) % 50);
+    }
+    const int* raw_data = raw.data();
+    mystl::flat_set<int> sorted(mystl::move(raw));
+    EXPECT_EQ(50, sorted.size());
+    EXPECT_TRUE(sorted.verify() && sorted.begin() == raw_data);
+    sorted.replace(mystl::move(back));
+    EXPECT_EQ(1000, sorted.size());
+
+    // 按提示插入, 区间删除
+    mystl::flat_set<int> h{1, 5, 9};
+    h.insert(h.lower_bound(7), 7);
+    h.insert(h.begin(), 8); // 提示不对时退回二分
+    h.emplace_hint(h.end(), 10);
+    EXPECT_EQ(6, h.size());
+    EXPECT_TRUE(h.verify());
+    auto next = h.erase(h.lower_bound(5), h.lower_bound(9));
+    EXPECT_EQ(9, *next);
+    EXPECT_EQ(3, h.size());
+
+    // 批量插入时比较抛出异常, 原有元素不变
+    int budget = 0;
+    mystl::flat_set<int, ThrowingLess> t(ThrowingLess{&budget});
+    for (int i = 0; i < 10; ++i) {
+        t.insert(i * 10);
+    }
+    mystl::vector<int> noisy;
+    for (int i = 0; i < 100; ++i) {
+        noisy.push_back(static_cast<int>(rng() % 1000));
+    }
+    budget = 50;
+    bool thrown = false;
+    try {
+        t.insert(noisy.begin(), noisy.end());
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    budget = 0;
+    EXPECT_TRUE(thrown);
+    EXPECT_EQ(10, t.size());
+    EXPECT_TRUE(t.verify());
+}
+
+TEST(flat_map) {
+    std::mt19937 rng(9);
+    mystl::flat_map<std::string, int> m;
+    std::map<std::string, int> expected;
+    bool ok = true;
+    for (int i = 0; i < 20000; ++i) {
+        const std::string k = std::to_string(rng() % 3000);
+        if (rng() % 3 == 0) {
+            ok = ok && m.erase(k) == expected.erase(k);
+        } else {
+            m[k] += i;
+            expected[k] += i;
+        }
+    }
+    ok = ok && m.size() == expected.size() && m.verify();
+    auto it = expected.begin();
+    for (auto mit = m.begin(); ok && mit != m.end(); ++mit, ++it) {
+        ok = mit->first == it->first && mit->second == it->second;
+    }
+    EXPECT_TRUE(ok);
+
+    // 批量插入时已有的键不被覆盖, 一批中重复的键保留靠前的
+    using item = mystl::pair<int, std::string>;
+    mystl::flat_map<int, std::string> names{item(1, "one"), item(3, "three")};
+    const item batch[] = {item(2, "two"), item(1, "uno"), item(4, "four"), item(2, "dos")};
+    names.insert(batch, batch + 4);
+    EXPECT_EQ(4, names.size());
+    EXPECT_TRUE(names.at(1) == "one" && names.at(2) == "two" && names.at(4) == "four");
+    bool thrown = false;
+    try {
+        names.at(5);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    EXPECT_FALSE(names.emplace(3, "tres").second);
+    EXPECT_TRUE(names.find(3)->second == "three");
+    auto range = names.equal_range(2);
+    EXPECT_TRUE(range.first->second == "two" && range.second->first == 3);
+
+    // 接管按键有序的 vector
+    mystl::vector<item> items;
+    for (int i = 0; i < 100; ++i) {
+        items.push_back(item(i, std::to_string(i)));
+    }
+    const item* data = items.data();
+    mystl::flat_map<int, std::string> adopted(mystl::sorted_unique, mystl::move(items));
+    EXPECT_TRUE(adopted.begin() == data);
+    EXPECT_TRUE(adopted[42] == "42");
+
+    // 异构查找: 按 id 查找不构造 Employee
+    mystl::flat_map<Employee, int, ById> staff;
+    for (int i = 0; i < 50; ++i) {
+        staff.emplace(Employee(i * 2, "e" + std::to_string(i)), i);
+    }
+    EXPECT_TRUE(staff.contains(40));
+    EXPECT_FALSE(staff.contains(41));
+    EXPECT_EQ(1, staff.count(98));
+    EXPECT_EQ(20, staff.find(40)->second);
+    EXPECT_TRUE(staff.find(41) == staff.end());
+    EXPECT_EQ(42, staff.lower_bound(41)->first.id);
+    EXPECT_EQ(42, staff.upper_bound(40)->first.id);
+    auto ids = staff.equal_range(10);
+    EXPECT_TRUE(ids.second - ids.first == 1 && ids.first->first.name == "e5");
+    const mystl::flat_set<Employee, ById> ceo{Employee(1, "ceo")};
+    EXPECT_TRUE(ceo.find(1) != ceo.end() && ceo.count(2) == 0);
+}
+
+}
+}
+} // namespace mystl::test::flat_map_test
+#endif // MYSTL_FLAT_MAP_TEST_H_
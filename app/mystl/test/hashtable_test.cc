@@ -0,0 +1,95 @@
+#ifndef MYSTL_HASHTABLE_TEST_H_
+#define MYSTL_HASHTABLE_TEST_H_
+
+#include "hashtable.h"
+#include "htest.h"
+
+#include <string>
+
+namespace mystl {
+namespace test {
+namespace hashtable_test {
+
+using int_table = mystl::hashtable<int, int, mystl::hash<int>, mystl::identity<int>, mystl::equal_to<int>>;
+
+TEST(hashtable) {
+    {
+        int_table ht(10, mystl::hash<int>(), mystl::equal_to<int>());
+        EXPECT_TRUE(ht.empty());
+        EXPECT_EQ(53U, ht.bucket_count());
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(ht.insert_unique(i).second);
+        }
+        EXPECT_FALSE(ht.insert_unique(42).second);
+        EXPECT_EQ(100U, ht.size());
+        EXPECT_TRUE(ht.bucket_count() >= 100U);
+        EXPECT_EQ(42, *ht.find(42));
+        EXPECT_TRUE(ht.find(100) == ht.end());
+
+        int sum = 0;
+        for (auto it = ht.begin(); it != ht.end(); ++it) {
+            sum += *it;
+        }
+        EXPECT_EQ(4950, sum);
+
+        EXPECT_EQ(1U, ht.erase(42));
+        EXPECT_EQ(0U, ht.count(42));
+        EXPECT_EQ(99U, ht.size());
+
+        int_table copy(ht);
+        EXPECT_TRUE(copy == ht);
+        ht.clear();
+        EXPECT_TRUE(ht.empty());
+        EXPECT_EQ(99U, copy.size());
+    }
+
+    {
+        int_table ht(10, mystl::hash<int>(), mystl::equal_to<int>());
+        ht.insert_equal(7);
+        ht.insert_equal(7);
+        ht.insert_equal(8);
+        EXPECT_EQ(2U, ht.count(7));
+        auto range = ht.equal_range(7);
+        int n = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            ++n;
+        }
+        EXPECT_EQ(2, n);
+    }
+
+    {
+        mystl::hashtable<std::string, std::string, mystl::hash<std::string>,
+                         mystl::identity<std::string>, mystl::equal_to<std::string>>
+            ht(10, mystl::hash<std::string>(), mystl::equal_to<std::string>());
+        ht.insert_unique("foo");
+        ht.insert_unique("bar");
+        EXPECT_EQ(1U, ht.count("foo"));
+        EXPECT_EQ(0U, ht.count("baz"));
+    }
+
+    {
+        // hash<std::string> 与 equal_to<> 都是透明的, 用 const char* 查找不构造 std::string
+        mystl::hashtable<std::string, std::string, mystl::hash<std::string>,
+                         mystl::identity<std::string>, mystl::equal_to<>>
+            ht(10, mystl::hash<std::string>(), mystl::equal_to<>());
+        ht.insert_unique("foo");
+        ht.insert_unique("bar");
+        ht.insert_equal("bar");
+        const char* probe = "foo";
+        EXPECT_TRUE(ht.find(probe) != ht.end() && *ht.find(probe) == "foo");
+        EXPECT_TRUE(ht.find("baz") == ht.end());
+        EXPECT_EQ(2U, ht.count("bar"));
+        auto range = ht.equal_range("bar");
+        int n = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            ++n;
+        }
+        EXPECT_EQ(2, n);
+        EXPECT_EQ(mystl::hash<std::string>()(std::string("bar")), mystl::hash<std::string>()("bar"));
+    }
+}
+
+}
+}
+} // namespace mystl::test::hashtable_test
+#endif // !MYSTL_HASHTABLE_TEST_H_
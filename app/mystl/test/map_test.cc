@@ -0,0 +1,135 @@
+#ifndef MYSTL_MAP_TEST_H_
+#define MYSTL_MAP_TEST_H_
+
+#include "map.h"
+#include "htest.h"
+
+#include <string>
+#include <vector>
+
+namespace mystl {
+namespace test {
+namespace map_test {
+
+TEST(map) {
+    using value_type = mystl::map<int, std::string>::value_type;
+    // 元素的 first 为 const, 用 std::vector 存放, 以指针作为区间
+    std::vector<value_type> sorted;
+    for (int i = 0; i < 1000; ++i) {
+        sorted.push_back(value_type(i, std::to_string(i)));
+    }
+
+    mystl::map<int, std::string> first(sorted.data(), sorted.data() + sorted.size());
+    mystl::map<int, std::string> second(mystl::sorted_unique, sorted.data(), sorted.data() + sorted.size());
+    EXPECT_EQ(1000, first.size());
+    EXPECT_EQ(1000, second.size());
+    EXPECT_TRUE(first.find(500)->second == "500");
+    EXPECT_TRUE(second[999] == "999");
+
+    bool ok = true;
+    int expected = 0;
+    for (auto it = second.begin(); it != second.end(); ++it, ++expected) {
+        ok = ok && it->first == expected;
+    }
+    EXPECT_TRUE(ok);
+
+    second[1000] = "1000";
+    second.erase(0);
+    EXPECT_EQ(1000, second.size());
+    EXPECT_TRUE(second.begin()->first == 1);
+
+    // 无序输入
+    value_type unsorted[] = {value_type(3, "c"), value_type(1, "a"), value_type(2, "b"), value_type(1, "z")};
+    mystl::map<int, std::string> third(unsorted, unsorted + 4);
+    EXPECT_EQ(3, third.size());
+    EXPECT_TRUE(third[1] == "a");
+    third.insert(sorted.data(), sorted.data() + 10);
+    EXPECT_EQ(10, third.size());
+}
+
+TEST(map_node_handle) {
+    // 在两个分片之间迁移, 再就地改键, 元素始终在同一个结点里
+    mystl::map<int, std::string> shard1;
+    mystl::map<int, std::string> shard2;
+    for (int i = 0; i < 100; ++i) {
+        shard1[i] = std::to_string(i);
+    }
+    const std::string* addr = &shard1.find(42)->second;
+    for (int i = 50; i < 100; ++i) {
+        shard2.insert(shard1.extract(i));
+    }
+    auto nh = shard1.extract(shard1.find(42));
+    nh.key() = 1042;
+    nh.mapped() += "!";
+    auto r = shard2.insert(mystl::move(nh));
+    EXPECT_TRUE(r.inserted && &r.position->second == addr);
+    EXPECT_TRUE(shard2[1042] == "42!");
+    EXPECT_EQ(49, shard1.size());
+    EXPECT_EQ(51, shard2.size());
+
+    // merge: 重复的键留在原处
+    shard2[0] = "dup";
+    shard1.merge(shard2);
+    EXPECT_EQ(100, shard1.size());
+    EXPECT_EQ(1, shard2.size());
+    EXPECT_TRUE(shard1[0] == "0" && shard2[0] == "dup" && shard1[99] == "99");
+}
+
+// 记录构造次数的键, 能和 const char* 直接比较
+struct CountedKey {
+    static int constructed;
+    std::string s;
+    CountedKey(const char* p) :
+        s(p) {
+        ++constructed;
+    }
+    CountedKey(const CountedKey& x) :
+        s(x.s) {
+        ++constructed;
+    }
+    friend bool operator<(const CountedKey& a, const CountedKey& b) {
+        return a.s < b.s;
+    }
+    friend bool operator<(const CountedKey& a, const char* b) {
+        return a.s.compare(b) < 0;
+    }
+    friend bool operator<(const char* a, const CountedKey& b) {
+        return b.s.compare(a) > 0;
+    }
+};
+int CountedKey::constructed = 0;
+
+TEST(map_transparent) {
+    mystl::map<CountedKey, int, mystl::less<>> m;
+    const char* const names[] = {"alpha", "beta", "delta", "gamma"};
+    for (int i = 0; i < 4; ++i) {
+        m[names[i]] = i;
+    }
+
+    // less<> 下用 const char* 查找, 不构造 CountedKey
+    CountedKey::constructed = 0;
+    EXPECT_EQ(2, m.find("delta")->second);
+    EXPECT_TRUE(m.find("epsilon") == m.end());
+    EXPECT_EQ(1, m.count("beta"));
+    EXPECT_TRUE(m.lower_bound("c")->first.s == "delta");
+    EXPECT_TRUE(m.upper_bound("delta")->first.s == "gamma");
+    auto range = m.equal_range("gamma");
+    EXPECT_TRUE(range.first->second == 3 && range.second == m.end());
+    EXPECT_EQ(0, CountedKey::constructed);
+
+    // 比较器不透明时, 每次查找都要先构造一个临时的键
+    mystl::map<CountedKey, int> plain;
+    plain["alpha"] = 0;
+    CountedKey::constructed = 0;
+    EXPECT_TRUE(plain.find("alpha") != plain.end());
+    EXPECT_EQ(1, CountedKey::constructed);
+
+    // less<> 本身可以比较不同类型
+    EXPECT_TRUE(mystl::less<>()(1, 2.5));
+    EXPECT_FALSE(mystl::less<>()(std::string("b"), "a"));
+}
+
+}
+}
+} // namespace mystl::test::map_test
+#endif // MYSTL_MAP_TEST_H_
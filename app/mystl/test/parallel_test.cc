@@ -0,0 +1,219 @@
+#ifndef MYSTL_PARALLEL_TEST_H_
+#define MYSTL_PARALLEL_TEST_H_
+
+#include "parallel.h"
+#include "numeric.h"
+#include "vector.h"
+#include "deque.h"
+#include "htest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mystl {
+namespace test {
+namespace parallel_test {
+
+// 比较若干次后抛出异常
+struct ThrowingLess {
+    int* budget;
+    bool operator()(int a, int b) const {
+        if (__atomic_sub_fetch(budget, 1, __ATOMIC_RELAXED) == 0) throw std::runtime_error("compare");
+        return a < b;
+    }
+};
+
+template <class Compare>
+bool ParallelSortMatchesStd(const mystl::vector<int>& input, std::size_t threads, Compare comp) {
+    std::vector<int> expected(input.begin(), input.end());
+    std::sort(expected.begin(), expected.end(), comp);
+    mystl::vector<int> v(input);
+    mystl::parallel_sort(v.begin(), v.end(), comp, threads);
+    return std::equal(v.begin(), v.end(), expected.begin());
+}
+
+TEST(parallel_sort) {
+    std::mt19937 rng(20240612);
+    mystl::vector<int> random;
+    mystl::vector<int> few_unique;
+    for (int i = 0; i < 300000; ++i) {
+        random.push_back(static_cast<int>(rng()));
+        few_unique.push_back(static_cast<int>(rng() % 8));
+    }
+    // 线程数不是 2 的幂时有落单的段
+    const std::size_t thread_counts[] = {1, 2, 3, 4, 7, 16};
+    bool ok = true;
+    for (std::size_t threads : thread_counts) {
+        ok = ok && ParallelSortMatchesStd(random, threads, mystl::less<int>());
+        ok = ok && ParallelSortMatchesStd(few_unique, threads, mystl::greater<int>());
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(ParallelSortMatchesStd(random, 0, mystl::less<int>()));
+
+    // 区间太小时退化为 mystl::sort
+    mystl::vector<int> small(random.begin(), random.begin() + 100);
+    EXPECT_TRUE(ParallelSortMatchesStd(small, 8, mystl::less<int>()));
+    mystl::vector<int> empty;
+    mystl::parallel_sort(empty.begin(), empty.end());
+    EXPECT_TRUE(empty.empty());
+
+    mystl::deque<std::string> d;
+    for (int i = 0; i < 100000; ++i) {
+        d.push_back(std::to_string(rng() % 100000));
+    }
+    // 超过 SSO 长度, 元素被移走后会变成空串
+    for (int i = 0; i < 1000; ++i) {
+        d.push_back(std::string(32, 'a') + std::to_string(rng() % 100000));
+    }
+    std::vector<std::string> sorted_copy;
+    for (auto it = d.begin(); it != d.end(); ++it) {
+        sorted_copy.push_back(*it);
+    }
+    std::sort(sorted_copy.begin(), sorted_copy.end());
+    const std::size_t string_threads[] = {2, 3, 4};
+    for (std::size_t threads : string_threads) {
+        mystl::deque<std::string> s(d);
+        mystl::parallel_sort(s.begin(), s.end(), mystl::less<std::string>(), threads);
+        bool same = sorted_copy.size() == s.size();
+        for (std::size_t i = 0; same && i < s.size(); ++i) {
+            same = s[i] == sorted_copy[i];
+        }
+        EXPECT_TRUE(same);
+    }
+
+    // 工作线程里抛出的异常传回调用线程
+    int budget = 500000;
+    mystl::vector<int> t(random);
+    bool thrown = false;
+    try {
+        mystl::parallel_sort(t.begin(), t.end(), ThrowingLess{&budget}, 4);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+}
+
+TEST(parallel_merge) {
+    std::mt19937 rng(5);
+    mystl::vector<int> a;
+    mystl::vector<int> b;
+    for (int i = 0; i < 100000; ++i) {
+        a.push_back(static_cast<int>(rng() % 1000));
+        b.push_back(static_cast<int>(rng() % 1000) + (i < 50000 ? 0 : 500));
+    }
+    mystl::sort(a.begin(), a.end());
+    mystl::sort(b.begin(), b.end());
+    std::vector<int> expected(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+
+    const std::size_t thread_counts[] = {1, 3, 8};
+    for (std::size_t threads : thread_counts) {
+        mystl::vector<int> out(a.size() + b.size());
+        auto end = mystl::parallel_merge(a.begin(), a.end(), b.begin(), b.end(), out.begin(), mystl::less<int>(), threads);
+        EXPECT_TRUE(end == out.end());
+        EXPECT_TRUE(std::equal(out.begin(), out.end(), expected.begin()));
+    }
+
+    // 一侧为空
+    mystl::vector<int> out(a.size());
+    mystl::parallel_merge(a.begin(), a.end(), b.begin(), b.begin(), out.begin());
+    EXPECT_TRUE(std::equal(out.begin(), out.end(), a.begin()));
+}
+
+TEST(parallel_reduce) {
+    mystl::vector<std::int64_t> v;
+    for (int i = 0; i < 200003; ++i) {
+        v.push_back(i % 1000 - 400);
+    }
+    const std::int64_t expected = std::accumulate(v.begin(), v.end(), std::int64_t(5));
+    const std::size_t thread_counts[] = {0, 1, 2, 3, 8};
+    bool ok = true;
+    for (std::size_t threads : thread_counts) {
+        ok = ok && mystl::parallel_reduce(v.begin(), v.end(), std::int64_t(5), mystl::plus<std::int64_t>(), threads) == expected;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(expected, mystl::parallel_reduce(v.begin(), v.end(), std::int64_t(5)));
+    EXPECT_EQ(expected - 5, mystl::reduce(v.begin(), v.end()));
+
+    // 矩阵乘法不满足交换律, 用 2x2 矩阵检查块的合并顺序
+    struct mat {
+        std::uint64_t a, b, c, d;
+    };
+    auto mul = [](const mat& x, const mat& y) {
+        return mat{x.a * y.a + x.b * y.c, x.a * y.b + x.b * y.d, x.c * y.a + x.d * y.c, x.c * y.b + x.d * y.d};
+    };
+    mystl::vector<mat> m;
+    for (int i = 0; i < 100000; ++i) {
+        m.push_back(mat{1, static_cast<std::uint64_t>(i % 7), static_cast<std::uint64_t>(i % 3), 1});
+    }
+    const mat one{1, 0, 0, 1};
+    const mat seq = mystl::reduce(m.begin(), m.end(), one, mul);
+    const mat par = mystl::parallel_reduce(m.begin(), m.end(), one, mul, 4);
+    EXPECT_TRUE(seq.a == par.a && seq.b == par.b && seq.c == par.c && seq.d == par.d);
+
+    const std::int64_t dot = std::inner_product(v.begin(), v.end(), v.begin(), std::int64_t(0));
+    EXPECT_EQ(dot, mystl::transform_reduce(v.begin(), v.end(), v.begin(), std::int64_t(0)));
+    EXPECT_EQ(dot, mystl::parallel_transform_reduce(v.begin(), v.end(), std::int64_t(0), mystl::plus<std::int64_t>(),
+                                                    [](std::int64_t x) { return x * x; }, 4));
+}
+
+TEST(parallel_scan) {
+    mystl::vector<std::int64_t> v;
+    for (int i = 0; i < 150001; ++i) {
+        v.push_back(i % 17 - 8);
+    }
+    std::vector<std::int64_t> inclusive(v.size());
+    std::partial_sum(v.begin(), v.end(), inclusive.begin());
+    std::vector<std::int64_t> exclusive(v.size());
+    std::int64_t running = 100;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        exclusive[i] = running;
+        running += v[i];
+    }
+
+    const std::size_t thread_counts[] = {1, 2, 3, 8};
+    bool ok = true;
+    for (std::size_t threads : thread_counts) {
+        mystl::vector<std::int64_t> out(v.size());
+        mystl::parallel_inclusive_scan(v.begin(), v.end(), out.begin(), mystl::plus<std::int64_t>(), std::int64_t(0), threads);
+        ok = ok && std::equal(out.begin(), out.end(), inclusive.begin());
+        auto end = mystl::parallel_exclusive_scan(v.begin(), v.end(), out.begin(), std::int64_t(100),
+                                                  mystl::plus<std::int64_t>(), threads);
+        ok = ok && end == out.end() && std::equal(out.begin(), out.end(), exclusive.begin());
+        // 原地扫描
+        mystl::vector<std::int64_t> inplace(v);
+        mystl::parallel_exclusive_scan(inplace.begin(), inplace.end(), inplace.begin(), std::int64_t(100),
+                                       mystl::plus<std::int64_t>(), threads);
+        ok = ok && std::equal(inplace.begin(), inplace.end(), exclusive.begin());
+    }
+    EXPECT_TRUE(ok);
+
+    mystl::vector<std::int64_t> out(v.size());
+    mystl::parallel_inclusive_scan(v.begin(), v.end(), out.begin());
+    EXPECT_TRUE(std::equal(out.begin(), out.end(), inclusive.begin()));
+    mystl::vector<std::int64_t> inplace(v);
+    mystl::parallel_inclusive_scan(inplace.begin(), inplace.end(), inplace.begin());
+    EXPECT_TRUE(std::equal(inplace.begin(), inplace.end(), inclusive.begin()));
+    mystl::parallel_exclusive_scan(v.begin(), v.end(), out.begin(), std::int64_t(100));
+    EXPECT_TRUE(std::equal(out.begin(), out.end(), exclusive.begin()));
+
+    // 单线程版本, 区间为空时不写输出
+    mystl::vector<int> small{3, 1, 4, 1, 5};
+    mystl::vector<int> s(5);
+    mystl::inclusive_scan(small.begin(), small.end(), s.begin(), mystl::plus<int>(), 10);
+    EXPECT_EQ(24, s[4]);
+    mystl::exclusive_scan(small.begin(), small.end(), s.begin(), 0);
+    EXPECT_EQ(0, s[0]);
+    EXPECT_EQ(9, s[4]);
+    EXPECT_TRUE(mystl::exclusive_scan(small.begin(), small.begin(), s.begin(), 0) == s.begin());
+}
+
+}
+}
+} // namespace mystl::test::parallel_test
+#endif // MYSTL_PARALLEL_TEST_H_
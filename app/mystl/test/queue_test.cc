@@ -10,6 +10,9 @@
 #include <array>
 #include <random>
 #include <queue>
+#include <algorithm>
+#include <functional>
+#include <vector>
 
 namespace mystl {
 namespace test {
@@ -148,6 +151,66 @@ TEST(priority_queue) {
         EXPECT_TRUE(foo.size() == 3 && bar.size() == 2);
     }
 }
+TEST(top_k) {
+    {
+        mystl::top_k<int> top(3);
+        EXPECT_TRUE(top.empty());
+        const int arr[] = {5, 1, 9, 3, 7, 9, 2};
+        for (int x : arr) {
+            top.push(x);
+        }
+        EXPECT_EQ(3, top.size());
+        EXPECT_TRUE(top.full());
+        EXPECT_EQ(7, top.top());
+        EXPECT_FALSE(top.push(7)); // 与堆顶相等的不替换
+        EXPECT_TRUE(top.push(8));
+        auto sorted = top.sorted();
+        EXPECT_TRUE(sorted.size() == 3 && sorted[0] == 9 && sorted[1] == 9 && sorted[2] == 8);
+    }
+
+    {
+        // 最小的 k 个
+        std::mt19937 rng(20240615);
+        std::vector<int> all;
+        mystl::top_k<int, mystl::greater<int>> smallest(100);
+        mystl::top_k<std::string> words(10);
+        for (int i = 0; i < 100000; ++i) {
+            const int x = static_cast<int>(rng() % 1000000);
+            all.push_back(x);
+            smallest.push(x);
+            words.push(std::to_string(x));
+        }
+        std::sort(all.begin(), all.end());
+        auto s = smallest.sorted();
+        EXPECT_TRUE(std::equal(s.begin(), s.end(), all.begin()));
+        EXPECT_EQ(all[99], smallest.top());
+
+        std::vector<std::string> strs;
+        for (int x : all) {
+            strs.push_back(std::to_string(x));
+        }
+        std::sort(strs.begin(), strs.end(), std::greater<std::string>());
+        auto w = words.sorted();
+        EXPECT_TRUE(std::equal(w.begin(), w.end(), strs.begin()));
+    }
+
+    {
+        mystl::top_k<int> none(0);
+        EXPECT_FALSE(none.push(1));
+        EXPECT_TRUE(none.empty());
+
+        mystl::top_k<int> a(2), b(5);
+        const int arr[] = {4, 8, 15, 16, 23, 42};
+        a.push(arr, arr + 6);
+        EXPECT_EQ(23, a.top());
+        swap(a, b);
+        EXPECT_EQ(5, a.k());
+        EXPECT_EQ(2, b.size());
+        b.clear();
+        EXPECT_TRUE(b.empty());
+    }
+}
+
 }
 }
 } // namespace mystl::test::queue_test
@@ -2,12 +2,15 @@
 #define MYSTL_SET_TEST_H_
 
 #include "set.h"
+#include "vector.h"
+#include "list.h"
 #include "htest.h"
 #include "htest_utils.h"
 
 #include <set>
 #include <string>
 #include <array>
+#include <stdexcept>
 
 namespace mystl {
 namespace test {
@@ -61,6 +64,151 @@ TEST(set) {
         EXPECT_TRUE(htest::ContainerEqual(myset, s1));
     }
 }
+
+// 第 budget 次拷贝时抛出异常
+struct ThrowingKey {
+    static int budget;
+    int v;
+    ThrowingKey(int x) :
+        v(x) {
+    }
+    ThrowingKey(const ThrowingKey& x) :
+        v(x.v) {
+        if (--budget == 0) throw std::runtime_error("copy");
+    }
+    bool operator<(const ThrowingKey& x) const {
+        return v < x.v;
+    }
+};
+int ThrowingKey::budget = -1;
+
+TEST(set_sorted_build) {
+    // 各种大小下建出的树都满足红黑树性质
+    bool ok = true;
+    for (int n = 0; n <= 300; ++n) {
+        mystl::vector<int> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(i * 2);
+        }
+        mystl::set<int> s(v.begin(), v.end());
+        ok = ok && s.size() == static_cast<std::size_t>(n) && s.rb_tree_.rb_verify();
+        ok = ok && std::equal(v.begin(), v.end(), s.begin());
+        mystl::set<int> t(mystl::sorted_unique, v.begin(), v.end());
+        ok = ok && t.size() == static_cast<std::size_t>(n) && t.rb_tree_.rb_verify();
+        // 建好的树可以继续插入和删除
+        t.insert(-1);
+        t.insert(n * 2 + 1);
+        t.erase(n);
+        ok = ok && t.rb_tree_.rb_verify() && *t.begin() == -1;
+    }
+    EXPECT_TRUE(ok);
+
+    mystl::vector<int> big;
+    for (int i = 0; i < 1000000; ++i) {
+        big.push_back(i);
+    }
+    mystl::set<int> large(big.begin(), big.end());
+    EXPECT_EQ(1000000, large.size());
+    EXPECT_TRUE(large.rb_tree_.rb_verify());
+    EXPECT_TRUE(large.find(765432) != large.end());
+
+    // 无序或有重复时逐个插入
+    int unsorted[] = {5, 3, 9, 1, 3, 7, 9};
+    mystl::set<int> u(unsorted, unsorted + 7);
+    int expect[] = {1, 3, 5, 7, 9};
+    EXPECT_EQ(5, u.size());
+    EXPECT_TRUE(std::equal(u.begin(), u.end(), expect) && u.rb_tree_.rb_verify());
+    int dup[] = {1, 2, 2, 3};
+    mystl::set<int> d(dup, dup + 4);
+    EXPECT_EQ(3, d.size());
+
+    // 非空时按 end() 提示插入, 双向迭代器与降序比较器
+    mystl::list<std::string> words;
+    for (int i = 0; i < 500; ++i) {
+        words.push_back(std::to_string(1000 + i));
+    }
+    mystl::set<std::string> w;
+    w.insert(std::string("0"));
+    w.insert(words.begin(), words.end());
+    EXPECT_EQ(501, w.size());
+    EXPECT_TRUE(w.rb_tree_.rb_verify());
+    mystl::set<int, mystl::greater<int>> desc(big.rbegin(), big.rend());
+    EXPECT_EQ(999999, *desc.begin());
+    EXPECT_TRUE(desc.rb_tree_.rb_verify());
+
+    // 建树中途抛出异常时已建好的节点都被释放
+    mystl::vector<ThrowingKey> keys;
+    for (int i = 0; i < 100; ++i) {
+        keys.push_back(ThrowingKey(i));
+    }
+    ThrowingKey::budget = 60;
+    bool thrown = false;
+    try {
+        mystl::set<ThrowingKey> t(mystl::sorted_unique, keys.begin(), keys.end());
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ThrowingKey::budget = -1;
+    EXPECT_TRUE(thrown);
+
+    mystl::set<int> assigned;
+    assigned = {1, 2, 3};
+    EXPECT_EQ(3, assigned.size());
+}
+TEST(set_node_handle) {
+    // merge 只移动本容器没有的键, 结点地址不变
+    mystl::set<int> odd{1, 3, 5, 7};
+    mystl::set<int> small{2, 3, 4, 5, 6};
+    const int* two = &*small.find(2);
+    odd.merge(small);
+    EXPECT_EQ(7, odd.size());
+    EXPECT_EQ(2, small.size());
+    EXPECT_TRUE(small.count(3) == 1 && small.count(5) == 1);
+    EXPECT_TRUE(&*odd.find(2) == two);
+    EXPECT_TRUE(odd.rb_tree_.rb_verify() && small.rb_tree_.rb_verify());
+
+    // extract 之后改键再插回, 用的还是同一个结点
+    mystl::set<int>::node_type nh = odd.extract(4);
+    EXPECT_FALSE(nh.empty());
+    const int* node = &nh.value();
+    nh.value() = 40;
+    mystl::set<int>::insert_return_type r = odd.insert(mystl::move(nh));
+    EXPECT_TRUE(r.inserted && &*r.position == node && nh.empty());
+    EXPECT_TRUE(odd.count(4) == 0 && odd.count(40) == 1);
+
+    // 键已存在时结点留在 node 中, 句柄析构时释放
+    r = odd.insert(small.extract(small.begin()));
+    EXPECT_FALSE(r.inserted);
+    EXPECT_TRUE(*r.position == 3 && r.node.value() == 3);
+    EXPECT_TRUE(odd.extract(100).empty());
+    EXPECT_FALSE(odd.insert(mystl::set<int>::node_type()).inserted);
+
+    // 摘空整棵树再倒序插回
+    mystl::vector<mystl::set<int>::node_type> nodes;
+    while (!odd.empty()) {
+        nodes.push_back(odd.extract(odd.begin()));
+    }
+    EXPECT_TRUE(odd.rb_tree_.rb_verify());
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        odd.insert(odd.end(), mystl::move(*it));
+    }
+    EXPECT_EQ(7, odd.size());
+    EXPECT_TRUE(odd.rb_tree_.rb_verify() && *odd.rbegin() == 40);
+    EXPECT_EQ(40, *odd.erase(odd.find(7)));
+    EXPECT_TRUE(odd.erase(odd.find(2), odd.find(6)) == odd.find(6));
+    EXPECT_EQ(3, odd.size());
+}
+
+TEST(set_transparent) {
+    mystl::set<std::string, mystl::less<>> words{"pear", "apple", "fig"};
+    const char* probe = "fig";
+    EXPECT_TRUE(words.find(probe) != words.end());
+    EXPECT_EQ(1, words.count("apple"));
+    EXPECT_EQ(0, words.count("kiwi"));
+    EXPECT_TRUE(*words.lower_bound("b") == "fig");
+    EXPECT_TRUE(words.upper_bound("pear") == words.end());
+}
+
 }
 }
 } // namespace mystl::test::set_test
@@ -0,0 +1,204 @@
+#ifndef MYSTL_SMALL_VECTOR_TEST_H_
+#define MYSTL_SMALL_VECTOR_TEST_H_
+
+#include "small_vector.h"
+#include "arena.h"
+#include "htest.h"
+#include "htest_utils.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+namespace mystl {
+namespace test {
+namespace small_vector_test {
+
+TEST(small_vector) {
+    {
+        mystl::small_vector<int, 8> v;
+        EXPECT_TRUE(v.empty());
+        EXPECT_TRUE(v.is_inline());
+        EXPECT_EQ(8U, v.capacity());
+        for (int i = 0; i < 8; ++i) {
+            v.push_back(i);
+        }
+        EXPECT_TRUE(v.is_inline()); // 不超过 N 个元素时不申请堆内存
+        v.push_back(8);
+        EXPECT_FALSE(v.is_inline());
+        EXPECT_EQ(9U, v.size());
+        EXPECT_TRUE(v.capacity() >= 9U);
+        for (int i = 0; i < 9; ++i) {
+            EXPECT_EQ(i, v[i]);
+        }
+        EXPECT_EQ(0, v.front());
+        EXPECT_EQ(8, v.back());
+        bool thrown = false;
+        try {
+            v.at(9);
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        EXPECT_TRUE(thrown);
+
+        v.erase(v.begin() + 2, v.begin() + 5);
+        std::vector<int> expected = {0, 1, 5, 6, 7, 8};
+        EXPECT_TRUE(htest::ContainerEqual(v, expected));
+        v.shrink_to_fit(); // 放得下时搬回内部缓冲区
+        EXPECT_TRUE(v.is_inline());
+        EXPECT_TRUE(htest::ContainerEqual(v, expected));
+    }
+
+    {
+        // 与 std::vector 对照插入、删除和赋值
+        std::vector<std::string> sv;
+        mystl::small_vector<std::string, 4> v;
+        for (int i = 0; i < 20; ++i) {
+            sv.push_back(std::to_string(i));
+            v.push_back(std::to_string(i));
+        }
+        sv.insert(sv.begin() + 3, "a");
+        v.insert(v.begin() + 3, "a");
+        sv.insert(sv.begin(), 3, "b");
+        v.insert(v.begin(), 3, "b");
+        sv.insert(sv.end() - 2, {"c", "d"});
+        v.insert(v.end() - 2, {"c", "d"});
+        sv.emplace(sv.begin() + 7, 5, 'e');
+        v.emplace(v.begin() + 7, 5, 'e');
+        sv.erase(sv.begin() + 1);
+        v.erase(v.begin() + 1);
+        EXPECT_TRUE(htest::ContainerEqual(v, sv));
+        sv.resize(30, "f");
+        v.resize(30, "f");
+        EXPECT_TRUE(htest::ContainerEqual(v, sv));
+        sv.resize(2);
+        v.resize(2);
+        EXPECT_TRUE(htest::ContainerEqual(v, sv));
+        sv.assign(3, "g");
+        v.assign(3, "g");
+        EXPECT_TRUE(htest::ContainerEqual(v, sv));
+        sv.assign({"h", "i", "j", "k", "l"});
+        v.assign({"h", "i", "j", "k", "l"});
+        EXPECT_TRUE(htest::ContainerEqual(v, sv));
+        sv.pop_back();
+        v.pop_back();
+        EXPECT_TRUE(htest::ContainerEqual(v, sv));
+        v.clear();
+        EXPECT_TRUE(v.empty());
+    }
+
+    {
+        // 插入的值引用了容器中会被搬走的元素
+        mystl::small_vector<std::string, 4> v = {"x", "y", "z"};
+        v.insert(v.begin(), v[2]); // 刚好填满内部缓冲区
+        v.push_back(v[0]);         // 扩容
+        v.push_back(v[1]);
+        v.insert(v.begin() + 1, 3, v.back());
+        std::vector<std::string> expected = {"z", "x", "x", "x", "x", "y", "z", "z", "x"};
+        EXPECT_TRUE(htest::ContainerEqual(v, expected));
+    }
+}
+
+TEST(small_vector_copy_move) {
+    using vec = mystl::small_vector<std::string, 4>;
+    vec small = {"a", "b"};
+    vec large = {"0", "1", "2", "3", "4", "5"};
+    EXPECT_TRUE(small.is_inline());
+    EXPECT_FALSE(large.is_inline());
+
+    vec small_copy(small);
+    vec large_copy(large);
+    EXPECT_TRUE(small_copy == small);
+    EXPECT_TRUE(large_copy == large);
+    EXPECT_FALSE(small < large);
+
+    // 堆上的数据直接接管, 内部缓冲区中的元素逐个搬移
+    const std::string* large_data = large.data();
+    vec moved_large(std::move(large));
+    EXPECT_EQ(large_data, moved_large.data());
+    EXPECT_TRUE(large.empty());
+    EXPECT_TRUE(large.is_inline());
+    vec moved_small(std::move(small));
+    EXPECT_TRUE(moved_small.is_inline());
+    EXPECT_TRUE(moved_small == small_copy);
+
+    vec a = small_copy;
+    vec b = large_copy;
+    a.swap(b);
+    EXPECT_TRUE(a == large_copy);
+    EXPECT_TRUE(b == small_copy);
+    mystl::swap(a, b);
+    EXPECT_TRUE(a == small_copy);
+    EXPECT_TRUE(b == large_copy);
+
+    a = large_copy;
+    EXPECT_TRUE(a == large_copy);
+    a = small_copy;
+    EXPECT_TRUE(a == small_copy);
+    a = std::move(b);
+    EXPECT_TRUE(a == large_copy);
+    a = vec{"q"};
+    EXPECT_EQ(1U, a.size());
+    EXPECT_EQ(std::string("q"), a[0]);
+
+    // 空区间删除不动任何元素, 不能把后面的元素自我移动赋值成空串
+    vec long_strings = {std::string(32, 'x'), std::string(32, 'y'), std::string(32, 'z')};
+    const vec long_copy(long_strings);
+    auto it = long_strings.erase(long_strings.begin() + 1, long_strings.begin() + 1);
+    EXPECT_TRUE(it == long_strings.begin() + 1);
+    EXPECT_TRUE(long_strings == long_copy);
+    long_strings.erase(long_strings.end(), long_strings.end());
+    EXPECT_TRUE(long_strings == long_copy);
+
+    {
+        // 只能移动的元素
+        mystl::small_vector<std::unique_ptr<int>, 2> v;
+        for (int i = 0; i < 10; ++i) {
+            v.emplace_back(new int(i));
+        }
+        v.erase(v.begin(), v.begin() + 8);
+        v.shrink_to_fit();
+        EXPECT_TRUE(v.is_inline());
+        mystl::small_vector<std::unique_ptr<int>, 2> w(std::move(v));
+        EXPECT_EQ(8, *w[0]);
+        EXPECT_EQ(9, *w[1]);
+    }
+
+    {
+        // 有状态的分配器只在溢出内部缓冲区时才用到
+        mystl::Arena arena;
+        using arena_vec = mystl::small_vector<int, 4, mystl::arena_allocator<int>>;
+        arena_vec v((mystl::arena_allocator<int>(arena)));
+        for (int i = 0; i < 4; ++i) {
+            v.push_back(i);
+        }
+        EXPECT_EQ(0U, arena.BytesUsed());
+        v.push_back(4);
+        EXPECT_TRUE(arena.BytesUsed() > 0U);
+        EXPECT_TRUE(v.get_allocator().arena() == &arena);
+    }
+}
+
+TEST(small_vector_bulk_append) {
+    mystl::small_vector<int, 4> v;
+    v.resize_uninitialized(3);
+    v[0] = 0;
+    v[1] = 1;
+    v[2] = 2;
+    v.reserve(4);
+    v.unchecked_push_back(3);
+    EXPECT_TRUE(v.is_inline());
+    int src[] = {4, 5, 6};
+    v.append(src, src + 3);
+    v.append(v.begin(), v.begin() + 2);
+    std::vector<int> expected = {0, 1, 2, 3, 4, 5, 6, 0, 1};
+    EXPECT_TRUE(htest::ContainerEqual(v, expected));
+    v.resize_default_init(2);
+    EXPECT_EQ(2U, v.size());
+}
+
+}
+}
+} // namespace mystl::test::small_vector_test
+#endif // MYSTL_SMALL_VECTOR_TEST_H_
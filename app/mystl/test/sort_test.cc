@@ -0,0 +1,424 @@
+#ifndef MYSTL_SORT_TEST_H_
+#define MYSTL_SORT_TEST_H_
+
+#include "sort.h"
+#include "radix_sort.h"
+#include "heap.h"
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include "utility.h"
+#include "htest.h"
+
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mystl {
+namespace test {
+namespace sort_test {
+
+enum Pattern {
+    RANDOM,
+    SORTED,
+    REVERSED,
+    FEW_UNIQUE,
+    ORGAN_PIPE,
+    SAWTOOTH,
+    PATTERN_COUNT
+};
+
+mystl::vector<int> Generate(Pattern pattern, int n, std::mt19937& rng) {
+    mystl::vector<int> v;
+    v.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        switch (pattern) {
+        case RANDOM: v.push_back(static_cast<int>(rng())); break;
+        case SORTED: v.push_back(i); break;
+        case REVERSED: v.push_back(n - i); break;
+        case FEW_UNIQUE: v.push_back(static_cast<int>(rng() % 4)); break;
+        case ORGAN_PIPE: v.push_back(i < n / 2 ? i : n - i); break;
+        default: v.push_back(i % 97); break;
+        }
+    }
+    return v;
+}
+
+template <class Compare>
+bool SortMatchesStd(std::mt19937& rng, Compare comp) {
+    const int sizes[] = {0, 1, 2, 3, 23, 24, 25, 100, 129, 1000, 5000};
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        for (int n : sizes) {
+            mystl::vector<int> v = Generate(static_cast<Pattern>(p), n, rng);
+            // sort 不稳定, 等价元素的次序可以与 std::sort 不同: 只检查有序且是原序列的排列
+            std::vector<int> expected(v.begin(), v.end());
+            std::stable_sort(expected.begin(), expected.end(), comp);
+            mystl::vector<int> s(v);
+            mystl::sort(s.begin(), s.end(), comp);
+            if (!mystl::is_sorted(s.begin(), s.end(), comp)) return false;
+            if (!std::is_permutation(s.begin(), s.end(), expected.begin())) return false;
+            mystl::vector<int> st(v);
+            mystl::stable_sort(st.begin(), st.end(), comp);
+            if (!std::equal(st.begin(), st.end(), expected.begin())) return false;
+        }
+    }
+    return true;
+}
+
+struct Record {
+    int key;
+    int order;
+};
+
+struct ByKey {
+    bool operator()(const Record& a, const Record& b) const {
+        return a.key < b.key;
+    }
+};
+
+// 比较若干次后抛出异常
+struct ThrowingLess {
+    int* budget;
+    bool operator()(const std::string& a, const std::string& b) const {
+        if (--*budget == 0) throw std::runtime_error("compare");
+        return a < b;
+    }
+};
+
+TEST(sort_int) {
+    std::mt19937 rng(20240611);
+    EXPECT_TRUE(SortMatchesStd(rng, mystl::less<int>()));
+    EXPECT_TRUE(SortMatchesStd(rng, mystl::greater<int>()));
+    EXPECT_TRUE(SortMatchesStd(rng, [](int a, int b) { return (a & 0xff) < (b & 0xff); }));
+
+    // 能触发堆排序兜底的输入: 中间大两头小, 轴总是选到边上
+    mystl::vector<int> v;
+    for (int i = 0; i < 100000; ++i) {
+        v.push_back(i % 2 == 0 ? i : 100000 - i);
+    }
+    mystl::sort(v.begin(), v.end());
+    EXPECT_TRUE(mystl::is_sorted(v.begin(), v.end()));
+
+    mystl::vector<double> d;
+    for (int i = 0; i < 3000; ++i) {
+        d.push_back(static_cast<double>(rng() % 1000) / 7.0);
+    }
+    mystl::sort(d.begin(), d.end());
+    EXPECT_TRUE(mystl::is_sorted(d.begin(), d.end()));
+
+    mystl::deque<int> q;
+    for (int i = 0; i < 2000; ++i) {
+        q.push_front(static_cast<int>(rng() % 500));
+    }
+    mystl::sort(q.begin(), q.end());
+    EXPECT_TRUE(mystl::is_sorted(q.begin(), q.end()));
+}
+
+TEST(sort_string) {
+    std::mt19937 rng(7);
+    mystl::vector<std::string> v;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 3000; ++i) {
+        v.push_back(std::to_string(rng() % 5000));
+        expected.push_back(v.back());
+    }
+    std::sort(expected.begin(), expected.end());
+    mystl::vector<std::string> s(v);
+    mystl::sort(s.begin(), s.end());
+    mystl::vector<std::string> st(v);
+    mystl::stable_sort(st.begin(), st.end());
+    bool same = true;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        same = same && s[i] == expected[i] && st[i] == expected[i];
+    }
+    EXPECT_TRUE(same);
+
+    // 比较抛出异常后元素既不丢失也不重复
+    int budget = 20000;
+    mystl::vector<std::string> t(v);
+    bool thrown = false;
+    try {
+        mystl::stable_sort(t.begin(), t.end(), ThrowingLess{&budget});
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    mystl::sort(t.begin(), t.end());
+    EXPECT_TRUE(mystl::equal(t.begin(), t.end(), s.begin()));
+}
+
+TEST(sort_stable) {
+    std::mt19937 rng(11);
+    const int sizes[] = {10, 33, 1000, 4097};
+    for (int n : sizes) {
+        mystl::vector<Record> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(Record{static_cast<int>(rng() % 16), i});
+        }
+        mystl::stable_sort(v.begin(), v.end(), ByKey());
+        bool stable = true;
+        for (int i = 1; i < n; ++i) {
+            stable = stable && (v[i - 1].key < v[i].key || (v[i - 1].key == v[i].key && v[i - 1].order < v[i].order));
+        }
+        EXPECT_TRUE(stable);
+    }
+
+    // 申请不到缓冲区时的原地归并
+    mystl::vector<Record> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.push_back(Record{static_cast<int>(rng() % 16), i});
+    }
+    mystl::sort_detail::inplace_stable_sort(v.begin(), v.end(), ByKey());
+    bool stable = true;
+    for (int i = 1; i < 3000; ++i) {
+        stable = stable && (v[i - 1].key < v[i].key || (v[i - 1].key == v[i].key && v[i - 1].order < v[i].order));
+    }
+    EXPECT_TRUE(stable);
+
+    // inplace_merge: 左段短时正向归并, 右段短时反向归并, 相等时左段在前
+    const int splits[] = {0, 1, 100, 1500, 2900, 3000};
+    for (int split : splits) {
+        mystl::vector<Record> m;
+        for (int i = 0; i < 3000; ++i) {
+            m.push_back(Record{static_cast<int>(rng() % 64), i});
+        }
+        mystl::stable_sort(m.begin(), m.begin() + split, ByKey());
+        mystl::stable_sort(m.begin() + split, m.end(), ByKey());
+        mystl::inplace_merge(m.begin(), m.begin() + split, m.end(), ByKey());
+        bool merged = true;
+        for (int i = 1; i < 3000; ++i) {
+            merged = merged && (m[i - 1].key < m[i].key || (m[i - 1].key == m[i].key && m[i - 1].order < m[i].order));
+        }
+        EXPECT_TRUE(merged);
+    }
+}
+
+TEST(sort_heap) {
+    std::mt19937 rng(3);
+    for (int n = 0; n < 300; n += 7) {
+        mystl::vector<int> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(static_cast<int>(rng() % 100));
+        }
+        std::vector<int> expected(v.begin(), v.end());
+        std::sort(expected.begin(), expected.end());
+
+        mystl::make_heap(v.begin(), v.end());
+        EXPECT_TRUE(std::is_heap(v.begin(), v.end()));
+        mystl::sort_heap(v.begin(), v.end());
+        EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+
+        mystl::vector<int> h;
+        for (int x : expected) {
+            h.push_back(x);
+            mystl::push_heap(h.begin(), h.end());
+        }
+        bool popped_in_order = true;
+        for (int i = n - 1; i >= 0; --i) {
+            mystl::pop_heap(h.begin(), h.begin() + i + 1);
+            popped_in_order = popped_in_order && h[i] == expected[i];
+        }
+        EXPECT_TRUE(popped_in_order);
+    }
+}
+
+template <class T>
+bool RadixMatchesStd(std::mt19937_64& rng, std::size_t n) {
+    mystl::vector<T> v;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t bits = rng();
+        T x;
+        if (std::is_floating_point<T>::value) {
+            x = static_cast<T>(static_cast<std::int64_t>(bits)) / static_cast<T>(1 << 20);
+        } else {
+            x = static_cast<T>(bits >> (i % 3 == 0 ? 0 : 48)); // 混入高位为 0 的值, 有的趟可以跳过
+        }
+        v.push_back(x);
+    }
+    std::vector<T> expected(v.begin(), v.end());
+    std::sort(expected.begin(), expected.end());
+    mystl::radix_sort(v.begin(), v.end());
+    return std::equal(v.begin(), v.end(), expected.begin());
+}
+
+TEST(radix_sort) {
+    std::mt19937_64 rng(20240613);
+    const std::size_t sizes[] = {0, 1, 63, 64, 1000, 20000};
+    bool ok = true;
+    for (std::size_t n : sizes) {
+        ok = ok && RadixMatchesStd<std::int8_t>(rng, n) && RadixMatchesStd<std::uint16_t>(rng, n);
+        ok = ok && RadixMatchesStd<int>(rng, n) && RadixMatchesStd<unsigned>(rng, n);
+        ok = ok && RadixMatchesStd<long long>(rng, n) && RadixMatchesStd<std::uint64_t>(rng, n);
+        ok = ok && RadixMatchesStd<float>(rng, n) && RadixMatchesStd<double>(rng, n);
+    }
+    EXPECT_TRUE(ok);
+
+    // 极值和正负零
+    mystl::vector<double> d;
+    const double specials[] = {0.0, -1.5, std::numeric_limits<double>::infinity(), 2.0,
+                               -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::max(),
+                               std::numeric_limits<double>::lowest(), std::numeric_limits<double>::denorm_min(), -0.0};
+    for (int i = 0; i < 20; ++i) {
+        d.insert(d.end(), specials, specials + 9);
+    }
+    mystl::radix_sort(d.begin(), d.end());
+    EXPECT_TRUE(mystl::is_sorted(d.begin(), d.end()));
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), d.front());
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), d.back());
+
+    // 用 select1st 取键, 相等的键保持原来的次序
+    mystl::vector<mystl::pair<int, int>> p;
+    for (int i = 0; i < 5000; ++i) {
+        p.push_back(mystl::pair<int, int>(static_cast<int>(rng() % 64) - 32, i));
+    }
+    mystl::radix_sort(p.begin(), p.end(), mystl::select1st<mystl::pair<int, int>>());
+    bool stable = true;
+    for (std::size_t i = 1; i < p.size(); ++i) {
+        stable = stable && (p[i - 1].first < p[i].first || (p[i - 1].first == p[i].first && p[i - 1].second < p[i].second));
+    }
+    EXPECT_TRUE(stable);
+
+    // 非平凡类型先移动到缓冲区
+    mystl::vector<std::string> s;
+    for (int i = 0; i < 1000; ++i) {
+        s.push_back(std::to_string(rng() % 100000));
+    }
+    mystl::radix_sort(s.begin(), s.end(), [](const std::string& x) { return std::stol(x); });
+    bool by_value = true;
+    for (std::size_t i = 1; i < s.size(); ++i) {
+        by_value = by_value && std::stol(s[i - 1]) <= std::stol(s[i]);
+    }
+    EXPECT_TRUE(by_value);
+}
+
+TEST(radix_sort_strings) {
+    std::mt19937 rng(9);
+    mystl::vector<std::string> v;
+    // 长公共前缀、空串、前缀关系和非 ASCII 字节
+    for (int i = 0; i < 20000; ++i) {
+        std::string s = (i % 4 == 0) ? std::string(40, 'p') : std::string();
+        const int len = static_cast<int>(rng() % 12);
+        for (int j = 0; j < len; ++j) {
+            s.push_back(static_cast<char>(i % 5 == 0 ? 0x80 + rng() % 100 : 'a' + rng() % 4));
+        }
+        v.push_back(s);
+    }
+    std::vector<std::string> expected(v.begin(), v.end());
+    std::sort(expected.begin(), expected.end(), [](const std::string& a, const std::string& b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+            return static_cast<unsigned char>(x) < static_cast<unsigned char>(y);
+        });
+    });
+    mystl::vector<std::string> s(v);
+    mystl::msd_radix_sort(s.begin(), s.end());
+    EXPECT_TRUE(std::equal(s.begin(), s.end(), expected.begin()));
+
+    // const char* 与取键函数
+    mystl::vector<const char*> c;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        c.push_back(v[i].c_str());
+    }
+    mystl::msd_radix_sort(c.begin(), c.end());
+    bool same = true;
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        same = same && expected[i] == c[i];
+    }
+    EXPECT_TRUE(same);
+
+    mystl::vector<mystl::pair<std::string, int>> p;
+    for (int i = 0; i < 3000; ++i) {
+        p.push_back(mystl::pair<std::string, int>(v[i % 100], i));
+    }
+    mystl::msd_radix_sort(p.begin(), p.end(), mystl::select1st<mystl::pair<std::string, int>>());
+    bool stable = true;
+    for (std::size_t i = 1; i < p.size(); ++i) {
+        stable = stable && (p[i - 1].first != p[i].first || p[i - 1].second < p[i].second);
+    }
+    EXPECT_TRUE(stable);
+}
+
+TEST(sort_partial) {
+    std::mt19937 rng(21);
+    const int sizes[] = {0, 1, 5, 24, 25, 200, 5000};
+    bool ok = true;
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        for (int n : sizes) {
+            mystl::vector<int> v = Generate(static_cast<Pattern>(p), n, rng);
+            std::vector<int> expected(v.begin(), v.end());
+            std::sort(expected.begin(), expected.end());
+            const int positions[] = {0, n / 3, n / 2, n - 1};
+            for (int k : positions) {
+                if (k < 0 || k >= n) continue;
+                mystl::vector<int> nth(v);
+                mystl::nth_element(nth.begin(), nth.begin() + k, nth.end());
+                ok = ok && nth[k] == expected[k];
+                for (int i = 0; i < n; ++i) {
+                    ok = ok && (i < k ? nth[i] <= nth[k] : nth[i] >= nth[k]);
+                }
+                ok = ok && std::is_permutation(nth.begin(), nth.end(), v.begin());
+
+                mystl::vector<int> part(v);
+                mystl::partial_sort(part.begin(), part.begin() + k, part.end());
+                ok = ok && std::equal(part.begin(), part.begin() + k, expected.begin());
+                ok = ok && std::is_permutation(part.begin(), part.end(), v.begin());
+            }
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    // 降序比较器与 deque
+    mystl::deque<int> d;
+    for (int i = 0; i < 3000; ++i) {
+        d.push_back(static_cast<int>(rng() % 100));
+    }
+    std::vector<int> desc;
+    for (int x : d) {
+        desc.push_back(x);
+    }
+    std::sort(desc.begin(), desc.end(), std::greater<int>());
+    mystl::nth_element(d.begin(), d.begin() + 100, d.end(), mystl::greater<int>());
+    EXPECT_EQ(desc[100], d[100]);
+    mystl::partial_sort(d.begin(), d.begin() + 50, d.end(), mystl::greater<int>());
+    EXPECT_TRUE(std::equal(d.begin(), d.begin() + 50, desc.begin()));
+
+    // 全部相等时不退化
+    mystl::vector<int> same(100000, 7);
+    mystl::nth_element(same.begin(), same.begin() + 50000, same.end());
+    EXPECT_EQ(7, same[50000]);
+
+    // partial_sort_copy: 输出区间比输入长或短, 输入为双向迭代器
+    mystl::list<int> l;
+    for (int i = 0; i < 500; ++i) {
+        l.push_back(static_cast<int>(rng() % 1000));
+    }
+    std::vector<int> sorted;
+    for (int x : l) {
+        sorted.push_back(x);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    mystl::vector<int> small(10);
+    auto end = mystl::partial_sort_copy(l.begin(), l.end(), small.begin(), small.end());
+    EXPECT_TRUE(end == small.end());
+    EXPECT_TRUE(std::equal(small.begin(), small.end(), sorted.begin()));
+    mystl::vector<int> big(600);
+    end = mystl::partial_sort_copy(l.begin(), l.end(), big.begin(), big.end());
+    EXPECT_TRUE(end == big.begin() + 500);
+    EXPECT_TRUE(std::equal(big.begin(), end, sorted.begin()));
+    mystl::vector<std::string> strs;
+    mystl::vector<std::string> first3(3);
+    for (int i = 0; i < 100; ++i) {
+        strs.push_back(std::to_string(i));
+    }
+    mystl::partial_sort_copy(strs.begin(), strs.end(), first3.begin(), first3.end(), mystl::greater<std::string>());
+    EXPECT_TRUE(first3[0] == "99" && first3[1] == "98" && first3[2] == "97");
+}
+
+}
+}
+} // namespace mystl::test::sort_test
+#endif // MYSTL_SORT_TEST_H_
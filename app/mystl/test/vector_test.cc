@@ -2,6 +2,7 @@
 #define MYSTL_VECTOR_TEST_H_
 
 #include "vector.h"
+#include "list.h"
 #include "htest.h"
 #include "htest_utils.h"
 
@@ -9,8 +10,40 @@
 #include <string>
 #include <array>
 #include <set>
+#include <memory>
 
 namespace mystl {
+namespace test {
+namespace vector_test {
+// 统计移动构造次数, 用来观察扩容时是逐个移动还是整块搬移
+template <bool Relocatable>
+struct MoveCounter {
+    static int moves;
+    int value;
+
+    MoveCounter(int v) :
+        value(v) {
+    }
+    MoveCounter(const MoveCounter& other) :
+        value(other.value) {
+    }
+    MoveCounter(MoveCounter&& other) :
+        value(other.value) {
+        ++moves;
+    }
+    MoveCounter& operator=(const MoveCounter&) = default;
+    ~MoveCounter() {
+    }
+};
+
+template <bool Relocatable>
+int MoveCounter<Relocatable>::moves = 0;
+}
+} // namespace test
+
+template <>
+struct is_trivially_relocatable<test::vector_test::MoveCounter<true>> : std::true_type {};
+
 namespace test {
 namespace vector_test {
 
@@ -261,6 +294,123 @@ TEST(vector) {
         EXPECT_TRUE(htest::ContainerEqual(third, third1));
     }
 }
+TEST(vector_relocate) {
+    EXPECT_TRUE(mystl::is_trivially_relocatable<int>::value);
+    EXPECT_TRUE(mystl::is_trivially_relocatable<std::unique_ptr<int>>::value);
+    EXPECT_FALSE(mystl::is_trivially_relocatable<std::string>::value);
+
+    {
+        // 声明为可平凡重定位的类型扩容时不调用移动构造, 其它类型逐个移动
+        using relocated = MoveCounter<true>;
+        using moved = MoveCounter<false>;
+        mystl::vector<relocated> v1;
+        mystl::vector<moved> v2;
+        for (int i = 0; i < 1000; ++i) {
+            v1.emplace_back(i);
+            v2.emplace_back(i);
+        }
+        EXPECT_EQ(0, relocated::moves);
+        EXPECT_TRUE(moved::moves >= 1000);
+        v1.insert(v1.begin() + 10, relocated(-1));
+        v1.erase(v1.begin(), v1.begin() + 5);
+        EXPECT_EQ(2, relocated::moves); // 实参先移入局部临时量, 再移入空位, 其余元素按字节搬移
+        EXPECT_EQ(996U, v1.size());
+        EXPECT_EQ(-1, v1[5].value);
+        EXPECT_EQ(10, v1[6].value);
+        EXPECT_EQ(999, v1.back().value);
+    }
+
+    {
+        // 只能移动的 unique_ptr 整块搬移
+        mystl::vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.emplace_back(new int(i));
+        }
+        v.emplace(v.begin(), new int(-1));
+        v.erase(v.begin() + 1, v.begin() + 11);
+        v.reserve(1000);
+        EXPECT_EQ(91U, v.size());
+        EXPECT_EQ(-1, *v[0]);
+        EXPECT_EQ(10, *v[1]);
+        EXPECT_EQ(99, *v.back());
+    }
+
+    {
+        // 插入的值引用了容器中会被搬走的元素
+        mystl::vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.push_back(i);
+        }
+        v.reserve(100);
+        v.insert(v.begin(), 3, v[5]);
+        v.insert(v.begin() + 1, v[9]);
+        std::vector<int> expected = {5, 6, 5, 5, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        EXPECT_TRUE(htest::ContainerEqual(v, expected));
+        auto it = v.insert(v.begin() + 2, 100, 7);
+        EXPECT_TRUE(it == v.begin() + 2);
+        EXPECT_EQ(114U, v.size());
+        EXPECT_EQ(5, v[102]);
+    }
+}
+
+TEST(vector_bulk_append) {
+    {
+        // 默认初始化扩展之后直接写入, 不经过清零
+        mystl::vector<unsigned char> buf;
+        buf.resize_uninitialized(16);
+        EXPECT_EQ(16U, buf.size());
+        for (int i = 0; i < 16; ++i) {
+            buf[i] = static_cast<unsigned char>(i);
+        }
+        buf.resize_default_init(4);
+        EXPECT_EQ(4U, buf.size());
+        EXPECT_EQ(3, buf[3]);
+        buf.resize_default_init(100);
+        EXPECT_EQ(100U, buf.size());
+        EXPECT_EQ(3, buf[3]);
+
+        // 非平凡类型仍然调用默认构造函数
+        mystl::vector<std::string> strs(2, "a");
+        strs.resize_default_init(5);
+        EXPECT_EQ(5U, strs.size());
+        EXPECT_TRUE(strs[4].empty());
+        EXPECT_EQ(std::string("a"), strs[1]);
+    }
+
+    {
+        mystl::vector<int> v;
+        int src[] = {1, 2, 3, 4, 5};
+        v.append(src, src + 5);
+        v.append(src, src + 2);
+        std::vector<int> expected = {1, 2, 3, 4, 5, 1, 2};
+        EXPECT_TRUE(htest::ContainerEqual(v, expected));
+
+        // 追加自身的元素
+        v.append(v.begin(), v.end());
+        EXPECT_EQ(14U, v.size());
+        EXPECT_EQ(2, v[13]);
+
+        mystl::list<int> l = {7, 8, 9};
+        v.append(l.begin(), l.end());
+        EXPECT_EQ(17U, v.size());
+        EXPECT_EQ(7, v[14]);
+        EXPECT_EQ(9, v.back());
+    }
+
+    {
+        mystl::vector<std::string> v;
+        v.reserve(4);
+        const std::string a = "a";
+        v.unchecked_push_back(a);
+        v.unchecked_push_back(std::string("b"));
+        v.push_back(a);
+        v.push_back(v[1]);
+        v.push_back(v[0]); // 扩容时引用容器中的元素
+        std::vector<std::string> expected = {"a", "b", "a", "b", "a"};
+        EXPECT_TRUE(htest::ContainerEqual(v, expected));
+    }
+}
+
 }
 }
 } // namespace mystl::test::vector_test